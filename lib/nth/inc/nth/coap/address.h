@@ -3,6 +3,7 @@
 
 #include "nth/coap/base.h"
 #include <array>
+#include <concepts>
 
 namespace nth::coap {
 
@@ -58,6 +59,25 @@ struct address {
     addr_type type;
 };
 
+/**
+ * @brief Raw datagram with remote address, payload points to external buffer.
+ * 
+ */
+struct datagram {
+    address addr;
+    ispan data;
+};
+
+/**
+ * @brief Anything that can send a batch of datagrams and report how
+ * many of them were sent, e.g. nth::coap::udp_socket.
+ *
+ */
+template<class T>
+concept transport = requires (T& t, std::span<const datagram> batch) {
+    { t.send(batch) } -> std::convertible_to<size_t>;
+};
+
 }
 
 #endif
\ No newline at end of file
@@ -92,6 +92,7 @@ enum class msg_code {
     valid                      = make_msg_code(msg_class::success, 3),
     changed                    = make_msg_code(msg_class::success, 4),
     content                    = make_msg_code(msg_class::success, 5),
+    continue_                  = make_msg_code(msg_class::success, 31),
     bad_request                = make_msg_code(msg_class::client_err, 0),
     unauthorized               = make_msg_code(msg_class::client_err, 1),
     bad_option                 = make_msg_code(msg_class::client_err, 2),
@@ -99,6 +100,7 @@ enum class msg_code {
     not_found                  = make_msg_code(msg_class::client_err, 4),
     method_not_allowed         = make_msg_code(msg_class::client_err, 5),
     not_acceptable             = make_msg_code(msg_class::client_err, 6),
+    request_entity_incomplete  = make_msg_code(msg_class::client_err, 8),
     precondition_failed        = make_msg_code(msg_class::client_err, 12),
     request_entity_too_large   = make_msg_code(msg_class::client_err, 13),
     unsupported_content_format = make_msg_code(msg_class::client_err, 15),
@@ -0,0 +1,235 @@
+#ifndef NTH_COAP_BLOCK_H
+#define NTH_COAP_BLOCK_H
+
+#include "nth/coap/packet.h"
+#include "nth/container/flat_map.h"
+
+namespace nth::coap {
+
+/**
+ * @brief Block1/Block2 option value (RFC 7959, 2.2): block number,
+ * more flag and size exponent, block size is 16 << szx. Exponent 7
+ * is reserved, such values are invalid.
+ *
+ */
+struct block_opt {
+    uint32_t num = 0;
+    bool more = false;
+    byte szx = 0;
+
+    static constexpr uint32_t max_num = 0xfffff;
+
+    constexpr bool valid() const            { return szx < 7 && num <= max_num; }
+    constexpr size_t size() const           { return size_t(16) << szx; }
+    constexpr size_t offset() const         { return size_t(num) << (szx + 4); }
+    constexpr uint32_t value() const        { return num << 4 | more << 3 | szx; }
+    constexpr bool operator==(const block_opt&) const = default;
+
+    static constexpr block_opt from_value(uint32_t val)
+    {
+        return {val >> 4, bool(val & 0x8), byte(val & 0x7)};
+    }
+};
+
+/**
+ * @brief Get block option from packet.
+ *
+ * @param pkt Parsed packet
+ * @param num Either option_num::block1 or option_num::block2
+ * @param blk Decoded value, invalid if option is longer than 3 bytes
+ * @return True if option is present
+ */
+constexpr bool block_get(const packet_view& pkt, option_num num, block_opt& blk)
+{
+    auto opt = pkt.opt_get(num);
+    if (!opt_valid(opt))
+        return false;
+    blk = opt.len > 3 ? block_opt{.szx = 7} : block_opt::from_value(opt_uint_decode(opt));
+    return true;
+}
+
+/**
+ * @brief Producer of response body, which is read block by block on
+ * demand, so whole body never has to be in memory. Read must return
+ * exactly 'min(out.size(), size - offset)' bytes, except for failure.
+ *
+ */
+struct payload_source {
+    size_t (*read)(void* ctx, size_t offset, ospan out);
+    size_t size;
+    void* ctx;
+
+    /**
+     * @brief Make source for body which is in memory anyway. Data must
+     * outlive source.
+     *
+     * @param data Body
+     * @return Source
+     */
+    static constexpr payload_source from(ispan data)
+    {
+        return {
+            .read = [] (void* ctx, size_t offset, ospan out) {
+                std::copy_n(static_cast<const byte*>(ctx) + offset, out.size(), out.begin());
+                return out.size();
+            },
+            .size = data.size(),
+            .ctx = const_cast<byte*>(data.data()),
+        };
+    }
+};
+
+/**
+ * @brief Consumer of request body, which receives it block by block.
+ * Write may reject block, e.g. if offset isn't the expected one.
+ *
+ */
+struct payload_sink {
+    bool (*write)(void* ctx, size_t offset, ispan data, bool last);
+    void* ctx;
+};
+
+/**
+ * @brief Result of receiving one block of request body.
+ *
+ */
+enum class block_status {
+    complete,   // Whole body received, respond as usual
+    partial,    // More blocks expected, 2.31 Continue was sent
+    failed,     // Error response was sent
+};
+
+/**
+ * @brief Cache of recently read blocks of payload sources, shared by
+ * all sessions, so concurrent clients fetching the same large resource
+ * block by block don't make source produce each block again. Blocks
+ * are keyed by source context, offset and size and replaced in FIFO
+ * order. Call 'invalidate' when resource behind source changes.
+ *
+ * @tparam N Number of cached blocks, must be power of 2
+ * @tparam BlockSize Maximum size of cached block, larger reads bypass cache
+ */
+template<size_t N, size_t BlockSize = 16 << imp::max_block_szx>
+struct block_cache {
+
+    /**
+     * @brief Source reading through cache. Must outlive its uses as
+     * nth::coap::payload_source.
+     *
+     */
+    struct source {
+        block_cache& cache;
+        payload_source src;
+
+        operator payload_source() const
+        {
+            return {
+                .read = [] (void* ctx, size_t offset, ospan out) {
+                    auto self = static_cast<const source*>(ctx);
+                    return self->cache.read(self->src, offset, out);
+                },
+                .size = src.size,
+                .ctx = const_cast<source*>(this),
+            };
+        }
+    };
+
+    block_cache() = default;
+    block_cache(const block_cache&) = delete;
+    block_cache& operator=(const block_cache&) = delete;
+
+    static constexpr size_t capacity()  { return N; }
+    size_t size() const noexcept        { return map.size(); }
+    size_t hits() const noexcept        { return hit_cnt; }
+    size_t misses() const noexcept      { return miss_cnt; }
+
+    /**
+     * @brief Read block from cache or from source, remembering it.
+     *
+     * @param src Source
+     * @param offset Block offset
+     * @param out Destination
+     * @return Number of bytes read
+     */
+    size_t read(const payload_source& src, size_t offset, ospan out)
+    {
+        if (out.size() > BlockSize)
+            return src.read(src.ctx, offset, out);
+
+        key k = {src.ctx, offset, out.size()};
+        if (auto it = map.find(k); it != map.end()) {
+            auto& e = buf[it->second];
+            ++hit_cnt;
+            std::copy_n(e.dat, e.len, out.begin());
+            return e.len;
+        }
+        ++miss_cnt;
+        auto idx = next++ & M;
+        auto& e = buf[idx];
+        if (e.used)
+            map.erase(e.k);
+        e.used = false;
+        e.len = src.read(src.ctx, offset, {e.dat, out.size()});
+        if (e.len == out.size()) {
+            e.k = k;
+            e.used = true;
+            map.insert({k, uint32_t(idx)});
+        }
+        std::copy_n(e.dat, e.len, out.begin());
+        return e.len;
+    }
+
+    /**
+     * @brief Drop every cached block of source.
+     *
+     * @param ctx Source context
+     */
+    void invalidate(const void* ctx)
+    {
+        for (auto& e : buf) {
+            if (e.used && e.k.ctx == ctx) {
+                map.erase(e.k);
+                e.used = false;
+            }
+        }
+    }
+
+    void clear()
+    {
+        map.clear();
+        for (auto& e : buf)
+            e.used = false;
+    }
+private:
+    struct key {
+        const void* ctx;
+        size_t offset;
+        size_t len;
+        constexpr bool operator==(const key&) const = default;
+    };
+    struct key_hash {
+        size_t operator()(const key& k) const
+        {
+            return flat_hash::mix(reinterpret_cast<uintptr_t>(k.ctx) ^ (uint64_t(k.offset) << 12) ^ k.len);
+        }
+    };
+    struct entry {
+        key k;
+        size_t len;
+        bool used = false;
+        byte dat[BlockSize];
+    };
+private:
+    static constexpr auto M = N - 1;
+    static_assert(N > 1 && !(M & N), "block cache size must be > 1 and power of 2");
+
+    flat_map<key, uint32_t, N * 2, key_hash> map;
+    entry buf[N];
+    size_t next = 0;
+    size_t hit_cnt = 0;
+    size_t miss_cnt = 0;
+};
+
+}
+
+#endif
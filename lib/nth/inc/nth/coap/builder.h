@@ -0,0 +1,145 @@
+#ifndef NTH_COAP_BUILDER_H
+#define NTH_COAP_BUILDER_H
+
+#include "nth/coap/packet.h"
+#include <string_view>
+
+namespace nth::coap {
+
+/**
+ * @brief Forward-only packet writer. Unlike 'opt_insert', which has to
+ * find insertion point and shift everything after it, options are only
+ * appended, so they must come in ascending order of numbers (repeated
+ * numbers allowed), and delta is just difference with the previous one.
+ * Option cache is filled along the way exactly like 'parse' would do it,
+ * so packet is ready for 'opt_get' without re-parsing. Payload goes last
+ * and closes the packet. Any failure (out of order option, not enough
+ * space) is sticky: further calls do nothing and 'ok' returns false.
+ *
+ */
+struct packet_builder {
+
+    /**
+     * @brief Start new packet in place of whatever view holds.
+     *
+     * @param pkt Packet to write
+     * @param t Message type
+     * @param c Message code
+     * @param id Message ID
+     * @param tok Token
+     */
+    constexpr packet_builder(packet_view& pkt, msg_type t, msg_code c, word id, ispan tok) : pkt{pkt}
+    {
+        pkt.flush();
+        fail = !pkt.setup(t, c, id, tok);
+    }
+
+    constexpr bool ok() const               { return !fail; }
+    constexpr packet_view& get() const      { return pkt; }
+
+    /**
+     * @brief Append option.
+     *
+     * @param num Option number, not less than previous one
+     * @param val Value
+     * @return True on success
+     */
+    constexpr bool add(option_num num, ispan val)
+    {
+        return append(+num, val);
+    }
+
+    /**
+     * @brief Append option with string value, e.g. Uri-Path segment.
+     *
+     * @param num Option number, not less than previous one
+     * @param val Value
+     * @return True on success
+     */
+    bool add(option_num num, std::string_view val)
+    {
+        return append(+num, {reinterpret_cast<const byte*>(val.data()), val.size()});
+    }
+
+    /**
+     * @brief Append option with unsigned integer value, minimal length.
+     *
+     * @param num Option number, not less than previous one
+     * @param val Value
+     * @return True on success
+     */
+    constexpr bool add_uint(option_num num, uint32_t val)
+    {
+        byte tmp[4];
+        return append(+num, {tmp, opt_uint_encode(val, tmp)});
+    }
+
+    /**
+     * @brief Append payload and finish packet.
+     *
+     * @param pld Payload
+     * @return True on success
+     */
+    constexpr bool payload(ispan pld)
+    {
+        auto dst = payload(pld.size());
+        if (dst.data() == nullptr)
+            return false;
+        std::ranges::copy(pld, dst.begin());
+        return true;
+    }
+
+    /**
+     * @brief Reserve payload to be written in place and finish packet.
+     *
+     * @param n Payload size
+     * @return Writable payload or span with nullptr on failure
+     */
+    constexpr ospan payload(size_t n)
+    {
+        if (fail)
+            return {};
+        auto dst = pkt.alloc_payload(n);
+        fail = dst.data() == nullptr;
+        done = true;
+        return dst;
+    }
+private:
+    constexpr bool append(word num, ispan val)
+    {
+        if (fail || done || num < prev || val.size() > packet_view::max_pkl)
+            return fail = true, false;
+
+        auto off = pkt.size();
+        auto len = word(val.size());
+        auto delta = word(num - prev);
+        if (!pkt.resize(off + opt_total_size(delta, len)))
+            return fail = true, false;
+
+        auto p = opt_encode_head(pkt.begin() + off, delta, len);
+        std::ranges::copy(val, p);
+
+#if (NTH_COAP_OPTION_CACHE)
+        if (num != prev) {
+            auto idx = +opt_num_to_bit(num);
+            set_arr_bit(pkt.opt_mask.data(), idx);
+            pkt.opt_offset[idx] = word(pkt.begin() + off - pkt.opt_begin());
+            pkt.opt_deltas[idx] = prev;
+        }
+#else
+        if (opt_num_to_bit(num) == option_bit::unknown)
+            pkt.opt_unknown_present = true;
+#endif
+        prev = num;
+        return true;
+    }
+private:
+    packet_view& pkt;
+    word prev = 0;
+    bool fail = false;
+    bool done = false;
+};
+
+}
+
+#endif
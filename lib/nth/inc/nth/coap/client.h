@@ -1,17 +1,736 @@
 #ifndef NTH_COAP_CLIENT_H
 #define NTH_COAP_CLIENT_H
 
-#include "nth/coap/session.h"
+#include "nth/coap/packet.h"
+#include "nth/coap/block.h"
+#include "nth/coap/dedup.h"
+#include "nth/util/bitset.h"
 
 namespace nth::coap {
 
-struct Client : Session<Client> {
-    void cancel();
-    void request();
+/**
+ * @brief Outcome of client request, reported to handler.
+ *
+ */
+enum class client_result {
+    response,   // Response received
+    reset,      // Server rejected request with RST
+    timeout,    // No ACK after all retransmissions or no response during exchange lifetime
+    incomplete, // Block-wise transfer broke off: unexpected block, or source or sink failed
+};
+
+/**
+ * @brief Retransmission timeout estimator of CoCoA, per endpoint
+ * (draft-ietf-core-cocoa). Strong estimator is fed with RTT of CON
+ * exchanges acknowledged without retransmission, weak one with RTT
+ * since the first transmission of exchanges, which needed one or two
+ * retransmissions, and overall RTO blends both. Starts at
+ * 'imp::ack_timeout', so without measurements behavior is the same as
+ * plain RFC 7252 exponential backoff. Overall RTO, which isn't updated
+ * for a while, ages back towards default: below 1s after 16 * RTO and
+ * above 3s after 4 * RTO.
+ *
+ */
+struct cocoa_rto {
+
+    static constexpr timestamp max_rto = 60000;
+
+    constexpr timestamp rto() const noexcept    { return overall; }
+
+    /**
+     * @brief Feed RTT measurement.
+     *
+     * @param rtt Time since the first transmission till ACK
+     * @param retx Number of retransmissions, 3 and more are ignored
+     * @param now Current time
+     */
+    constexpr void update(timestamp rtt, int retx, timestamp now)
+    {
+        if (retx == 0)
+            overall = (strong.feed(rtt, 4) + overall) / 2;
+        else if (retx <= 2)
+            overall = (weak.feed(rtt, 1) + 3 * overall) / 4;
+        else
+            return;
+        overall = std::min(overall, max_rto);
+        updated = now;
+    }
+
+    /**
+     * @brief Age overall RTO, which wasn't updated for a while.
+     *
+     * @param now Current time
+     */
+    constexpr void age(timestamp now)
+    {
+        if (overall < 1000 && now - updated > 16 * overall) {
+            overall = (1000 + overall) / 2;
+            updated = now;
+        } else if (overall > 3000 && now - updated > 4 * overall) {
+            overall = (2000 + overall) / 2;
+            updated = now;
+        }
+    }
+
+    /**
+     * @brief Apply variable backoff factor, which depends on initial
+     * timeout of exchange: 3 below 1s, 1.5 above 3s and 2 otherwise.
+     *
+     * @param timeout Current timeout
+     * @param initial Initial timeout of exchange
+     * @return Next timeout
+     */
+    static constexpr timestamp backoff(timestamp timeout, timestamp initial)
+    {
+        if (initial < 1000)
+            return timeout * 3;
+        if (initial > 3000)
+            return timeout * 3 / 2;
+        return timeout * 2;
+    }
+private:
+    struct estimator {
+        constexpr timestamp feed(timestamp rtt, int k)
+        {
+            if (!valid) {
+                srtt = rtt;
+                rttvar = rtt / 2;
+                valid = true;
+            } else {
+                rttvar = (3 * rttvar + (srtt > rtt ? srtt - rtt : rtt - srtt)) / 4;
+                srtt = (7 * srtt + rtt) / 8;
+            }
+            return srtt + std::max<timestamp>(k * rttvar, 1);
+        }
+        timestamp srtt = 0;
+        timestamp rttvar = 0;
+        bool valid = false;
+    };
 private:
-    ClientState state = client_st_idle;  
+    estimator strong;
+    estimator weak;
+    timestamp overall = imp::ack_timeout;
+    timestamp updated = 0;
+};
+
+/**
+ * @brief Client engine for many concurrent requests to many servers.
+ * Requests are matched with responses by token and with ACK/RST by
+ * message ID through hash maps of exchange keys, so lookup is O(1)
+ * regardless of number of outstanding requests. Congestion control
+ * follows RFC 7252, 4.7: at most NStart interactions are outstanding
+ * per server, further requests wait in per server FIFO and go out in
+ * order as soon as earlier ones are acknowledged, answered or time out,
+ * and NON requests to server, which doesn't respond, are paced at
+ * 'NTH_COAP_PROBING_RATE'. CON requests are retransmitted with
+ * exponential backoff: initial timeout is picked randomly between RTO
+ * and RTO * 'imp::ack_random_factor', where RTO is CoCoA estimate for
+ * the server (initially 'imp::ack_timeout'), and up to
+ * 'imp::max_retransmit_cnt' times. CON responses are acknowledged and
+ * their message IDs remembered, so duplicates get ACK again and never
+ * reach handler. Block-wise requests (RFC 7959) send body in Block1
+ * blocks and fetch further Block2 blocks of response, every next block
+ * goes through the same congestion control as a new request. Outgoing
+ * datagrams are batched like in nth::coap::server_engine.
+ *
+ * @tparam Transport Outgoing transport, see nth::coap::transport
+ * @tparam N Maximum number of requests, queued and outstanding
+ * @tparam PacketSize Size of every packet buffer
+ * @tparam NStart Maximum number of outstanding interactions per server
+ * @tparam TxBatch Maximum number of datagrams in outgoing batch
+ * @tparam Peers Maximum number of servers, whose state is tracked
+ * @tparam Dedup Number of remembered message IDs of CON responses, must be power of 2
+ */
+template<transport Transport, size_t N, size_t PacketSize = imp::default_packet_size, size_t NStart = NTH_COAP_NSTART,
+    size_t TxBatch = 32, size_t Peers = N, size_t Dedup = std::bit_ceil(std::max(N, size_t(2)))>
+struct client_engine {
+
+    static_assert(N && NStart && TxBatch && Peers);
+
+    explicit client_engine(Transport& tr, word first_id = 0, uint32_t seed = 0x9e3779b9) : tr{tr}, id{first_id}, rng{seed | 1} {}
+    client_engine(const client_engine&) = delete;
+    client_engine& operator=(const client_engine&) = delete;
+
+    static constexpr size_t capacity()      { return N; }
+    size_t size() const noexcept            { return len; }
+    bool empty() const noexcept             { return len == 0; }
+    bool full() const noexcept              { return len == N; }
+    timestamp time() const noexcept         { return now; }
+
+    /**
+     * @brief Queue request and send it right away if congestion control
+     * allows. Handle identifies request in handler and stays valid until
+     * request is completed or cancelled, after that it may be reused.
+     *
+     * @param addr Server endpoint
+     * @param code Request method
+     * @param payload Payload
+     * @param opts Options, e.g. Uri-Path, in any order
+     * @param con Send as confirmable
+     * @return Handle or 'capacity()' if request doesn't fit
+     */
+    size_t request(const address& addr, msg_code code, ispan payload = {}, std::span<const option> opts = {}, bool con = true)
+    {
+        return start(addr, code, opts, con, [&] (slot& s, packet_view& pkt) {
+            s.xfer = transfer::none;
+            return pkt.set_payload(payload);
+        });
+    }
+
+    /**
+     * @brief Queue block-wise request (RFC 7959). Body is read from source
+     * block by block and sent with Block1, unless it fits into single
+     * packet, every next block follows 2.31 Continue. If final response
+     * has Block2 with more flag, further blocks are requested, and every
+     * block of response body is passed to sink. Server may lower block
+     * size, it's followed. Handler is called once, with final response
+     * (only its last block of body) or with error.
+     *
+     * @param addr Server endpoint
+     * @param code Request method
+     * @param body Request body source, must stay valid until completion
+     * @param sink Response body sink, without 'write' Block2 isn't followed
+     * @param opts Options, e.g. Uri-Path, in any order, repeated in every block
+     * @param con Send as confirmable
+     * @param szx Preferred block size exponent of request body
+     * @return Handle or 'capacity()' if request doesn't fit
+     */
+    size_t request_block(const address& addr, msg_code code, const payload_source& body, const payload_sink& sink = {},
+        std::span<const option> opts = {}, bool con = true, byte szx = imp::max_block_szx)
+    {
+        return start(addr, code, opts, con, [&] (slot& s, packet_view& pkt) {
+            s.xfer = transfer::block1;
+            s.blk = {.szx = std::min(szx, byte(6))};
+            s.src = body;
+            s.sink = sink;
+            return fill(s, pkt);
+        });
+    }
+
+    /**
+     * @brief Forget request without calling handler. Late response to
+     * it will be dropped, or rejected with RST if confirmable.
+     *
+     * @param handle Request handle
+     * @return True if request was pending
+     */
+    bool cancel(size_t handle)
+    {
+        if (handle >= N || !used[handle])
+            return false;
+        auto pi = slots[handle].peer;
+        if (slots[handle].st == state::queued)
+            unqueue(handle);
+        release(handle);
+        pump(pi);
+        return true;
+    }
+
+    /**
+     * @brief Match received datagram with request. Malformed datagrams,
+     * requests and responses, which match nothing, are dropped, except
+     * for unexpected CON response, which is rejected with RST.
+     *
+     * @param dg Received datagram
+     * @param handler Callable with 'size_t handle, client_result res,
+     * const packet_view& rsp' for every completed request, response is
+     * empty unless result is client_result::response
+     * @return True if datagram was accepted, including duplicates
+     */
+    template<class Fn>
+    bool feed(const datagram& dg, Fn&& handler)
+    {
+        auto raw = dg.data;
+        if (raw.size() > PacketSize || packet_view::validate(raw) != error::ok)
+            return false;
+        auto type = msg_type((raw[0] >> 4) & 0x3);
+        auto tkl = size_t(raw[0] & 0xf);
+        auto mid = word((raw[2] << 8) | raw[3]);
+        auto code = raw[1];
+
+        if (type == msg_type::ack || type == msg_type::rst) {
+            auto it = table.find(exchange_key::from_id(dg.addr, mid));
+            if (it == table.end())
+                return false;
+            auto idx = it->second;
+            auto& s = slots[idx];
+            if (type == msg_type::rst) {
+                complete(idx, client_result::reset, {}, handler);
+                return true;
+            }
+            if (!s.con)
+                return false;
+            if (code != +msg_code::empty && !std::ranges::equal(raw.subspan(4, tkl), ispan{s.key.tok, s.key.tkl}))
+                return false;
+            // NOTE: Pump only after response, so next block is queued in front of other requests
+            auto pi = s.peer;
+            acknowledge(idx);
+            if (code != +msg_code::empty)
+                respond(idx, raw, handler);
+            pump(pi);
+            return true;
+        }
+        if (code == +msg_code::empty || (code >> 5) == +msg_class::request)
+            return false;
+
+        if (type == msg_type::con) {
+            if (auto e = dedup.find(dg.addr, mid, now)) {
+                enqueue(dg.addr, e->response());
+                return true;
+            }
+        }
+        auto it = table.find(exchange_key::from_token(dg.addr, raw.subspan(4, tkl)));
+        if (it == table.end() || slots[it->second].st == state::queued) {
+            if (type == msg_type::con)
+                reply(dg.addr, msg_type::rst, mid);
+            return false;
+        }
+        if (type == msg_type::con)
+            dedup.insert(dg.addr, mid, now).store(reply(dg.addr, msg_type::ack, mid));
+        respond(it->second, raw, handler);
+        return true;
+    }
+
+    /**
+     * @brief Feed whole batch of received datagrams.
+     *
+     * @param batch Received datagrams
+     * @param handler Same as for single datagram
+     * @return Number of accepted datagrams
+     */
+    template<class Fn>
+    size_t feed(std::span<const datagram> batch, Fn&& handler)
+    {
+        size_t n = 0;
+        for (const auto& it : batch)
+            n += feed(it, handler);
+        return n;
+    }
+
+    /**
+     * @brief Update time, retransmit or give up on unacknowledged
+     * requests, send queued ones, which congestion control allows now,
+     * and flush outgoing batch.
+     *
+     * @param time Current time
+     * @param handler Callable for every request, which timed out
+     * @return Number of datagrams sent
+     */
+    template<class Fn>
+    size_t poll(timestamp time, Fn&& handler)
+    {
+        now = time;
+        for (auto i = used.find_next_set(0); i < N; i = used.find_next_set(i + 1)) {
+            auto& s = slots[i];
+            if (s.st == state::queued || s.due > now)
+                continue;
+            switch (s.st) {
+            case state::wait_ack:
+                if (s.retx < imp::max_retransmit_cnt) {
+                    ++s.retx;
+                    s.timeout = cocoa_rto::backoff(s.timeout, s.initial);
+                    s.due = now + s.timeout;
+                    enqueue(peers[s.peer].key.addr, {bufs[i], s.len});
+                } else {
+                    complete(i, client_result::timeout, {}, handler);
+                }
+            break;
+            case state::wait_non:
+                s.st = state::wait_rsp;
+                s.due = s.sent + imp::exchange_lifetime;
+                --peers[s.peer].active;
+            break;
+            default:
+                complete(i, client_result::timeout, {}, handler);
+            }
+        }
+        for (size_t i = 0; i < Peers; ++i) {
+            if (peer_used[i] && peers[i].refs) {
+                peers[i].rto.age(now);
+                pump(i);
+            }
+        }
+        return flush();
+    }
+
+    /**
+     * @brief Hand outgoing batch to transport.
+     *
+     * @return Number of datagrams sent
+     */
+    size_t flush()
+    {
+        if (!txn)
+            return 0;
+        size_t n = tr.send(std::span<const datagram>{txq, txn});
+        txn = 0;
+        return n;
+    }
+
+    /**
+     * @brief Current retransmission timeout estimate for server.
+     *
+     * @param addr Server endpoint
+     * @return RTO, 'imp::ack_timeout' if server isn't tracked
+     */
+    timestamp rto(const address& addr) const
+    {
+        auto it = peer_table.find(exchange_key::from_token(addr, {}));
+        return it == peer_table.end() ? imp::ack_timeout : peers[it->second].rto.rto();
+    }
+
+    /**
+     * @brief Number of outstanding interactions with server.
+     *
+     * @param addr Server endpoint
+     * @return Number of interactions, never greater than NStart
+     */
+    size_t outstanding(const address& addr) const
+    {
+        auto it = peer_table.find(exchange_key::from_token(addr, {}));
+        return it == peer_table.end() ? 0 : peers[it->second].active;
+    }
+private:
+    enum class state : byte {
+        queued,     // Waiting for congestion control
+        wait_ack,   // CON sent, retransmitted until ACK
+        wait_non,   // NON sent, outstanding until response or RTO
+        wait_rsp,   // Not outstanding anymore, waiting for separate or late response
+    };
+    enum class transfer : byte {
+        none,       // Plain request
+        block1,     // Sending request body, Block1 in request unless body fits
+        block2,     // Fetching response body, Block2 in request after the first block
+    };
+    struct slot {
+        exchange_key key;
+        uint32_t peer;
+        uint32_t next;
+        timestamp sent;
+        timestamp due;
+        timestamp timeout;
+        timestamp initial;
+        word id;
+        word len;
+        byte retx;
+        state st;
+        bool con;
+        transfer xfer;
+        block_opt blk;
+        payload_source src;
+        payload_sink sink;
+    };
+    struct peer {
+        exchange_key key;
+        cocoa_rto rto;
+        timestamp probe_ts;
+        uint32_t head;
+        uint32_t tail;
+        uint32_t active;
+        uint32_t refs;
+    };
+    uint32_t next_rand()
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+    template<class Fn>
+    size_t start(const address& addr, msg_code code, std::span<const option> opts, bool con, Fn&& fn)
+    {
+        if (full())
+            return N;
+        auto pi = acquire_peer(addr);
+        if (pi == Peers)
+            return N;
+        auto idx = used.acquire_any();
+        auto& s = slots[idx];
+
+        byte tok[4];
+        do {
+            auto r = next_rand();
+            for (auto& it : tok)
+                it = byte(r), r >>= 8;
+            s.key = exchange_key::from_token(addr, tok);
+        } while (table.find(s.key) != table.end());
+
+        packet_view pkt{bufs[idx]};
+        bool ok = pkt.setup(con ? msg_type::con : msg_type::non, code, 0, tok);
+        for (auto& it : opts)
+            ok = ok && pkt.opt_insert(it);
+        if (!ok || !fn(s, pkt)) {
+            used.clr(idx);
+            if (!peers[pi].refs)
+                release_peer(pi);
+            return N;
+        }
+        s.peer = uint32_t(pi);
+        s.next = N;
+        s.len = word(pkt.size());
+        s.st = state::queued;
+        s.con = con;
+        ++len;
+        ++peers[pi].refs;
+        table.insert({s.key, uint32_t(idx)});
+
+        auto& p = peers[pi];
+        if (p.head == N)
+            p.head = uint32_t(idx);
+        else
+            slots[p.tail].next = uint32_t(idx);
+        p.tail = uint32_t(idx);
+        pump(pi);
+        return idx;
+    }
+    size_t acquire_peer(const address& addr)
+    {
+        auto key = exchange_key::from_token(addr, {});
+        if (auto it = peer_table.find(key); it != peer_table.end())
+            return it->second;
+        size_t idx = Peers;
+        for (size_t i = 0; i < Peers; ++i) {
+            if (!peers[i].refs) {
+                idx = i;
+                if (!peer_used[i])
+                    break;
+            }
+        }
+        if (idx == Peers)
+            return Peers;
+        if (peer_used[idx])
+            release_peer(idx);
+        peer_used.set(idx);
+        peers[idx] = {.key = key, .rto = {}, .probe_ts = 0, .head = N, .tail = N, .active = 0, .refs = 0};
+        peer_table.insert({key, uint32_t(idx)});
+        return idx;
+    }
+    void release_peer(size_t idx)
+    {
+        peer_table.erase(peers[idx].key);
+        peer_used.clr(idx);
+    }
+    void pump(size_t pi)
+    {
+        auto& p = peers[pi];
+        while (p.head != N && p.active < NStart) {
+            auto idx = p.head;
+            auto& s = slots[idx];
+            if (!s.con && p.probe_ts > now)
+                break;
+            p.head = s.next;
+            if (p.head == N)
+                p.tail = N;
+            ++p.active;
+            transmit(idx);
+        }
+    }
+    void unqueue(size_t idx)
+    {
+        auto& p = peers[slots[idx].peer];
+        uint32_t prev = N;
+        for (auto i = p.head; i != idx; i = slots[i].next)
+            prev = i;
+        if (prev == N)
+            p.head = slots[idx].next;
+        else
+            slots[prev].next = slots[idx].next;
+        if (p.tail == idx)
+            p.tail = prev;
+    }
+    void transmit(size_t idx)
+    {
+        auto& s = slots[idx];
+        auto& p = peers[s.peer];
+        s.id = id++;
+        s.sent = now;
+        s.retx = 0;
+        bufs[idx][2] = byte(s.id >> 8);
+        bufs[idx][3] = byte(s.id);
+        if (s.con) {
+            auto rto = p.rto.rto();
+            s.st = state::wait_ack;
+            s.initial = rto + timestamp(next_rand() % (timestamp(rto * (imp::ack_random_factor - 1)) + 1));
+            s.timeout = s.initial;
+        } else {
+            s.st = state::wait_non;
+            s.initial = s.timeout = p.rto.rto();
+            p.probe_ts = now + timestamp(s.len) * 1000 / NTH_COAP_PROBING_RATE;
+        }
+        // NOTE: NON is matched by message ID too, RST may answer it until completion
+        table.insert({exchange_key::from_id(p.key.addr, s.id), uint32_t(idx)});
+        s.due = now + s.timeout;
+        enqueue(p.key.addr, {bufs[idx], s.len});
+    }
+    void acknowledge(size_t idx)
+    {
+        auto& s = slots[idx];
+        auto& p = peers[s.peer];
+        p.rto.update(now - s.sent, s.retx, now);
+        forget_id(idx);
+        s.st = state::wait_rsp;
+        s.due = s.sent + imp::exchange_lifetime;
+        --p.active;
+        p.probe_ts = 0;
+    }
+    bool fill(slot& s, packet_view& pkt)
+    {
+        pkt.opt_delete(option_num::block1);
+        pkt.opt_delete(option_num::block2);
+        pkt.alloc_payload(0);
+        if (s.xfer == transfer::block2)
+            return !s.blk.num || opt_insert_uint(pkt, option_num::block2, s.blk.value());
+
+        auto need = pkt.size() + 6; // Block1 and payload marker
+        auto room = PacketSize > need ? PacketSize - need : 0;
+        auto offset = s.blk.offset();
+        if (!s.blk.num) {
+            while (s.blk.szx && s.blk.size() > room)
+                --s.blk.szx;
+            if (s.src.size <= room + 5) {
+                s.blk.more = false;
+                auto out = pkt.alloc_payload(s.src.size);
+                return out.size() == s.src.size && (out.empty() || s.src.read(s.src.ctx, 0, out) == out.size());
+            }
+        }
+        if (s.blk.size() > room || offset >= s.src.size)
+            return false;
+        auto n = std::min(s.blk.size(), s.src.size - offset);
+        s.blk.more = offset + n < s.src.size;
+        if (!opt_insert_uint(pkt, option_num::block1, s.blk.value()))
+            return false;
+        auto out = pkt.alloc_payload(n);
+        return out.size() == n && s.src.read(s.src.ctx, offset, out) == n;
+    }
+    bool resume(size_t idx)
+    {
+        auto& s = slots[idx];
+        auto& p = peers[s.peer];
+        retire(idx);
+        packet_view pkt{bufs[idx]};
+        pkt.resize(s.len);
+        pkt.parse();
+        if (!fill(s, pkt))
+            return false;
+        s.len = word(pkt.size());
+        s.st = state::queued;
+        s.next = p.head;
+        p.head = uint32_t(idx);
+        if (p.tail == N)
+            p.tail = uint32_t(idx);
+        pump(s.peer);
+        return true;
+    }
+    template<class Fn>
+    void respond(size_t idx, ispan raw, Fn& handler)
+    {
+        auto& s = slots[idx];
+        if (s.xfer == transfer::none)
+            return complete(idx, client_result::response, raw, handler);
+        rx.parse(raw);
+        block_opt blk;
+        if (s.xfer == transfer::block1 && s.blk.more && rx.get_code() == +msg_code::continue_) {
+            if (!block_get(rx, option_num::block1, blk) || !blk.valid() || blk.szx > s.blk.szx || blk.offset() != s.blk.offset())
+                return complete(idx, client_result::incomplete, {}, handler);
+            auto next = s.blk.offset() + s.blk.size();
+            s.blk = {.num = uint32_t(next >> (blk.szx + 4)), .szx = blk.szx};
+            if (!resume(idx))
+                complete(idx, client_result::incomplete, {}, handler);
+            return;
+        }
+        if (!s.sink.write || rx.get_code_class() != +msg_class::success)
+            return complete(idx, client_result::response, raw, handler);
+        auto offset = s.xfer == transfer::block2 ? s.blk.offset() : 0;
+        bool chunked = block_get(rx, option_num::block2, blk);
+        auto pld = rx.get_payload();
+        if (chunked && (!blk.valid() || blk.offset() != offset || (blk.more && pld.size() != blk.size())))
+            return complete(idx, client_result::incomplete, {}, handler);
+        bool last = !chunked || !blk.more;
+        if (!s.sink.write(s.sink.ctx, offset, pld, last))
+            return complete(idx, client_result::incomplete, {}, handler);
+        if (last)
+            return complete(idx, client_result::response, raw, handler);
+        s.xfer = transfer::block2;
+        s.blk = {.num = blk.num + 1, .szx = blk.szx};
+        if (!resume(idx))
+            complete(idx, client_result::incomplete, {}, handler);
+    }
+    template<class Fn>
+    void complete(size_t idx, client_result res, ispan raw, Fn& handler)
+    {
+        auto pi = slots[idx].peer;
+        peers[pi].probe_ts = res == client_result::timeout ? peers[pi].probe_ts : 0;
+        release(idx);
+        pump(pi);
+        if (raw.empty())
+            rx.clear();
+        else
+            rx.parse(raw);
+        handler(idx, res, static_cast<const packet_view&>(rx));
+    }
+    void retire(size_t idx)
+    {
+        auto& s = slots[idx];
+        auto& p = peers[s.peer];
+        if (s.st != state::queued)
+            forget_id(idx);
+        if (s.st == state::wait_ack || s.st == state::wait_non)
+            --p.active;
+        s.st = state::wait_rsp;
+    }
+    void forget_id(size_t idx)
+    {
+        auto& s = slots[idx];
+        auto key = exchange_key::from_id(peers[s.peer].key.addr, s.id);
+        if (auto it = table.find(key); it != table.end() && it->second == idx)
+            table.erase(key);
+    }
+    void release(size_t idx)
+    {
+        auto& s = slots[idx];
+        auto& p = peers[s.peer];
+        retire(idx);
+        table.erase(s.key);
+        --p.refs;
+        used.clr(idx);
+        --len;
+    }
+    ispan reply(const address& addr, msg_type type, word mid)
+    {
+        byte msg[4] = {byte((imp::version << 6) | (int(type) << 4)), +msg_code::empty, byte(mid >> 8), byte(mid)};
+        return enqueue(addr, msg);
+    }
+    ispan enqueue(const address& addr, ispan pkt)
+    {
+        if (txn == TxBatch)
+            flush();
+        std::ranges::copy(pkt, txbuf[txn]);
+        txq[txn] = {addr, {txbuf[txn], pkt.size()}};
+        return txq[txn++].data;
+    }
+private:
+    static constexpr size_t table_size = std::bit_ceil(4 * N);
+    static constexpr size_t peer_table_size = std::bit_ceil(2 * Peers);
+
+    Transport& tr;
+    timestamp now = 0;
+    word id;
+    uint32_t rng;
+    size_t len = 0;
+    size_t txn = 0;
+    bitset<size_t, N, 16> used;
+    bitset<size_t, Peers, 16> peer_used;
+    flat_map<exchange_key, uint32_t, table_size, exchange_key_hash> table;
+    flat_map<exchange_key, uint32_t, peer_table_size, exchange_key_hash> peer_table;
+    dedup_cache<Dedup, 4> dedup; // Only empty ACK is stored
+    slot slots[N];
+    peer peers[Peers];
+    byte bufs[N][PacketSize];
+    packet<PacketSize> rx;
+    datagram txq[TxBatch];
+    byte txbuf[TxBatch][PacketSize];
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -2,6 +2,7 @@
 #define NTH_COAP_CONFIG_H
 
 #include "nth/coap/base.h"
+#include <bit>
 
 namespace nth::coap {
 namespace imp {
@@ -9,10 +10,9 @@ namespace imp {
 // FIXME make an inline constexpr flags
 
 #define NTH_COAP_OPTION_CACHE       true
-#define NTH_COAP_OSCORE_NO_SCRATCH  false
-// #define NTH_COAP_NSTART             1
+#define NTH_COAP_NSTART             1
 // #define NTH_COAP_DEFAULT_LEISURE    5 // seconds
-// #define NTH_COAP_PROBING_RATE       1 // byte/second
+#define NTH_COAP_PROBING_RATE       1 // byte/second
 
 // Some configs explained here: https://datatracker.ietf.org/doc/html/rfc7252#section-4.8
 
@@ -22,10 +22,15 @@ inline constexpr auto max_transition_buf    = 2;
 inline constexpr auto max_retransmit_cnt    = 4;
 inline constexpr auto ack_timeout           = timestamp(2000); 
 inline constexpr auto ack_random_factor     = 1.5;  // Multiplier for `ack_timeout`
+inline constexpr auto exchange_lifetime     = timestamp(247000); // Time to remember message ID for deduplication
+inline constexpr auto dedup_request_rate    = 1;    // Expected requests per second from all clients, sizes dedup cache
+inline constexpr auto dedup_size            = std::bit_ceil(size_t(dedup_request_rate * exchange_lifetime / 1000)); // Entries to cover `exchange_lifetime` at that rate
+inline constexpr auto max_block_szx         = 6;    // Preferred block size exponent, 16 << 6 = 1024 bytes
 inline constexpr auto log_packet_raw_hex    = true;
 inline constexpr auto oscore_version        = 1;
-inline constexpr auto oscore_cbor_size      = 128;
-inline constexpr auto oscore_scratch_size   = 128;
+inline constexpr auto oscore_cbor_size      = 128;  // Key derivation info and AAD
+inline constexpr auto oscore_scratch_size   = default_packet_size; // Decrypted plaintext of received message
+inline constexpr auto oscore_replay_window  = 256;  // Bits of anti-replay window, power of 2
 
 }
 
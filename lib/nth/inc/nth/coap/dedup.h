@@ -0,0 +1,129 @@
+#ifndef NTH_COAP_DEDUP_H
+#define NTH_COAP_DEDUP_H
+
+#include "nth/coap/exchange.h"
+#include "nth/coap/config.h"
+
+namespace nth::coap {
+
+/**
+ * @brief Cache of recently received message IDs per endpoint for duplicate
+ * detection (RFC 7252, 4.5), with optional copy of response to replay it
+ * for retransmitted CON. Entries live in a ring in order of insertion,
+ * which is also order of expiry, so eviction only ever looks at the oldest
+ * one, and hash map points into the ring for O(1) lookup. When full, the
+ * oldest entry is evicted before its lifetime ends and 'overflows' counts
+ * it, so duplicate of that message would be taken as new. Size it for
+ * expected message rate times lifetime, see 'imp::dedup_size'.
+ *
+ * @tparam N Maximum number of entries, must be power of 2
+ * @tparam PacketSize Maximum size of stored response
+ */
+template<size_t N, size_t PacketSize = imp::default_packet_size>
+struct dedup_cache {
+
+    struct entry {
+        constexpr bool replayable() const   { return len; }
+        constexpr ispan response() const    { return {rsp, len}; }
+        constexpr bool store(ispan pkt)
+        {
+            if (pkt.size() > PacketSize)
+                return false;
+            std::ranges::copy(pkt, rsp);
+            len = word(pkt.size());
+            return true;
+        }
+    private:
+        friend dedup_cache;
+        exchange_key key;
+        timestamp ts;
+        word len;
+        byte rsp[PacketSize];
+    };
+
+    constexpr dedup_cache(timestamp lifetime = imp::exchange_lifetime) : lifetime{lifetime} {}
+    constexpr dedup_cache(const dedup_cache&) = delete;
+    constexpr dedup_cache& operator=(const dedup_cache&) = delete;
+
+    constexpr static size_t capacity()          { return N; }
+    constexpr size_t size() const noexcept      { return tail - head; }
+    constexpr bool empty() const noexcept       { return head == tail; }
+    constexpr bool full() const noexcept        { return size() == N; }
+    constexpr size_t overflows() const noexcept { return evicted; }
+
+    /**
+     * @brief Find entry for message, evicting expired entries first.
+     *
+     * @param addr Remote endpoint
+     * @param id Message ID
+     * @param now Current time
+     * @return Entry or nullptr if message wasn't seen during lifetime
+     */
+    constexpr entry* find(const address& addr, word id, timestamp now)
+    {
+        evict(now);
+        auto it = map.find(exchange_key::from_id(addr, id));
+        return it == map.end() ? nullptr : &buf[it->second & M];
+    }
+
+    /**
+     * @brief Remember message, which must not be present yet. Evicts
+     * expired entries and the oldest one if cache is still full.
+     *
+     * @param addr Remote endpoint
+     * @param id Message ID
+     * @param now Current time
+     * @return New entry without response
+     */
+    constexpr entry& insert(const address& addr, word id, timestamp now)
+    {
+        evict(now);
+        if (full()) {
+            pop();
+            ++evicted;
+        }
+        auto& e = buf[tail & M];
+        e.key = exchange_key::from_id(addr, id);
+        e.ts = now;
+        e.len = 0;
+        [[maybe_unused]] auto ret = map.insert({e.key, tail++});
+        assert(ret.second);
+        return e;
+    }
+
+    /**
+     * @brief Remove entries older than lifetime.
+     *
+     * @param now Current time
+     */
+    constexpr void evict(timestamp now)
+    {
+        while (!empty() && buf[head & M].ts + lifetime <= now)
+            pop();
+    }
+
+    constexpr void clear()
+    {
+        map.clear();
+        head = tail = 0;
+    }
+private:
+    constexpr void pop()
+    {
+        map.erase(buf[head++ & M].key);
+    }
+private:
+    static constexpr auto M = N - 1;
+    static_assert(N > 1 && !(M & N), "dedup cache size must be > 1 and power of 2");
+
+    flat_map<exchange_key, uint32_t, N * 2, exchange_key_hash> map;
+    entry buf[N];
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    size_t evicted = 0;
+    timestamp lifetime;
+};
+
+}
+
+#endif
@@ -0,0 +1,330 @@
+#ifndef NTH_COAP_ENGINE_H
+#define NTH_COAP_ENGINE_H
+
+#include "nth/coap/server.h"
+#include "nth/coap/dedup.h"
+#include "nth/coap/observer.h"
+#include "nth/util/bitset.h"
+
+namespace nth::coap {
+
+/**
+ * @brief Server engine for many endpoints. Owns fixed table of N server
+ * sessions with packet buffers, indexed by hash map of exchange keys, so
+ * datagram is routed to its session in O(1) regardless of number of
+ * clients. Engine installs itself as application hooks while it drives
+ * sessions: transmitted packets are copied into outgoing batch, which
+ * is handed to transport when full or on 'flush', and message IDs come
+ * from engine counter. Request handler is called with session, which
+ * holds request packet, and must either respond, respond later through
+ * 'separate' (engine sends empty ACK for CON in that case) or ignore it.
+ * Ignored request holds its session until 'drop' or until
+ * 'imp::exchange_lifetime' passes since it was received.
+ * Request message IDs are remembered in nth::coap::dedup_cache together
+ * with ACK sent for them, so duplicates never reach handler: duplicate
+ * CON gets the same ACK again and duplicate NON is silently dropped.
+ *
+ * @tparam Transport Outgoing transport, see nth::coap::transport
+ * @tparam N Maximum number of concurrent exchanges
+ * @tparam PacketSize Size of every packet buffer
+ * @tparam TxBatch Maximum number of datagrams in outgoing batch
+ * @tparam Dedup Number of remembered message IDs, must be power of 2. Should
+ * cover all requests received during 'imp::exchange_lifetime', not just N
+ * concurrent ones, see 'imp::dedup_size' and 'dedup_overflows'
+ */
+template<transport Transport, size_t N, size_t PacketSize = imp::default_packet_size, size_t TxBatch = 32, size_t Dedup = imp::dedup_size>
+struct server_engine {
+
+    static_assert(N && TxBatch);
+
+    explicit server_engine(Transport& tr, word first_id = 0) : tr{tr}, id{first_id} {}
+    server_engine(const server_engine&) = delete;
+    server_engine& operator=(const server_engine&) = delete;
+
+    static constexpr size_t capacity()      { return N; }
+    size_t size() const noexcept            { return len; }
+    bool empty() const noexcept             { return len == 0; }
+    bool full() const noexcept              { return len == N; }
+    timestamp time() const noexcept         { return now; }
+    size_t dedup_overflows() const noexcept { return dedup.overflows(); }
+    const address& remote(const server& s)  { return slots[index(s)].addr; }
+
+    /**
+     * @brief Route received datagram to its session, creating one for new
+     * request. Duplicate requests are answered from cache or dropped.
+     * Malformed datagrams (checked in place before anything is copied),
+     * unexpected ACK/RST, requests matching exchange which is still in
+     * progress and requests which don't fit into table are dropped.
+     *
+     * @param dg Received datagram
+     * @param handler Callable with 'server&' for every new request
+     * @return True if datagram was accepted, including duplicates
+     */
+    template<class Fn>
+    bool feed(const datagram& dg, Fn&& handler)
+    {
+        auto raw = dg.data;
+        if (raw.size() > PacketSize || packet_view::validate(raw) != error::ok)
+            return false;
+        auto type = msg_type((raw[0] >> 4) & 0x3);
+        auto tkl = size_t(raw[0] & 0xf);
+        auto mid = word((raw[2] << 8) | raw[3]);
+
+        app_hooks_scope scope{hooks()};
+        size_t idx;
+        bool request = type == msg_type::con || type == msg_type::non;
+
+        if (request) {
+            if (raw[1] == +msg_code::empty || (raw[1] >> 5) != +msg_class::request)
+                return false;
+            if (auto e = dedup.find(dg.addr, mid, now)) {
+                if (type == msg_type::con && e->replayable())
+                    enqueue(dg.addr, e->response());
+                return true;
+            }
+            auto key = exchange_key::from_token(dg.addr, raw.subspan(4, tkl));
+            if (auto it = table.find(key); it != table.end()) {
+                idx = it->second;
+                if (!sessions[idx].finished())
+                    return false;
+                release(idx);
+            }
+            if ((idx = acquire(key, dg.addr)) == N)
+                return false;
+            dedup.insert(dg.addr, mid, now);
+        } else {
+            auto it = table.find(exchange_key::from_id(dg.addr, mid));
+            if (it == table.end())
+                return false;
+            idx = it->second;
+        }
+        auto& s = sessions[idx];
+        active = idx;
+        s.feed(raw);
+        s.advance();
+        if (request && !s.idle()) {
+            handler(s);
+            if (s.serving())
+                s.emptyack();
+        }
+        if (s.finished())
+            release(idx);
+        return true;
+    }
+
+    /**
+     * @brief Feed whole batch of received datagrams.
+     *
+     * @param batch Received datagrams
+     * @param handler Callable with 'server&' for every new request
+     * @return Number of accepted datagrams
+     */
+    template<class Fn>
+    size_t feed(std::span<const datagram> batch, Fn&& handler)
+    {
+        size_t n = 0;
+        for (const auto& it : batch)
+            n += feed(it, handler);
+        return n;
+    }
+
+    /**
+     * @brief Send separate response for request, which handler didn't
+     * respond to right away.
+     *
+     * @param s Session passed to handler before
+     * @param payload Payload
+     * @param code Response code
+     */
+    void separate(server& s, ispan payload, msg_code code = msg_code::content)
+    {
+        app_hooks_scope scope{hooks()};
+        active = index(s);
+        s.separate(payload, code);
+        if (s.finished())
+            release(active);
+    }
+
+    /**
+     * @brief Send separate block-wise response for request, which handler
+     * didn't respond to right away, see nth::coap::server::respond_block.
+     *
+     * @param s Session passed to handler before
+     * @param src Body source
+     * @param code Response code
+     */
+    void separate_block(server& s, const payload_source& src, msg_code code = msg_code::content)
+    {
+        app_hooks_scope scope{hooks()};
+        active = index(s);
+        s.respond_block(src, code);
+        if (s.finished())
+            release(active);
+    }
+
+    /**
+     * @brief Free session of request, which handler ignored and won't
+     * respond to. Session must not be used afterwards.
+     *
+     * @param s Session passed to handler before
+     */
+    void drop(server& s)
+    {
+        auto idx = index(s);
+        assert(used[idx]);
+        release(idx);
+    }
+
+    /**
+     * @brief Notify observers of resource through engine transport, with
+     * message IDs from engine counter. Pending batch is flushed first.
+     * Empty ACK and RST to notifications aren't matched by 'feed', pass
+     * them to nth::coap::observer_registry::feed. Confirmable ones are
+     * retransmitted by 'poll' with the same registry.
+     *
+     * @param obs Observers of resource
+     * @param payload Payload
+     * @param code Response code
+     * @param con Send confirmable notifications
+     * @param opts Extra options, e.g. Content-Format
+     * @return Number of notifications sent
+     */
+    template<size_t M, size_t P, size_t B, size_t I>
+    size_t notify(observer_registry<M, P, B, I>& obs, ispan payload, msg_code code = msg_code::content, bool con = false, std::span<const option> opts = {})
+    {
+        flush();
+        app_hooks_scope scope{hooks()};
+        return obs.notify(tr, payload, code, con, opts);
+    }
+
+    /**
+     * @brief Update time, retransmit or give up on unacknowledged CON
+     * responses and notifications, free sessions of requests left without
+     * response for 'imp::exchange_lifetime' and flush outgoing batch.
+     *
+     * @param time Current time
+     * @param obs Observer registries notified through this engine
+     * @return Number of datagrams sent
+     */
+    template<class... Registry>
+    size_t poll(timestamp time, Registry&... obs)
+    {
+        now = time;
+        {
+            app_hooks_scope scope{hooks()};
+            for (auto i = used.find_next_set(0); i < N; i = used.find_next_set(i + 1)) {
+                active = i;
+                sessions[i].advance();
+                if (sessions[i].finished() || (!sessions[i].idle() && now - slots[i].since >= imp::exchange_lifetime))
+                    release(i);
+            }
+        }
+        size_t n = flush();
+        ((n += obs.poll(tr, now)), ...);
+        return n;
+    }
+
+    /**
+     * @brief Hand outgoing batch to transport.
+     *
+     * @return Number of datagrams sent
+     */
+    size_t flush()
+    {
+        if (!txn)
+            return 0;
+        size_t n = tr.send(std::span<const datagram>{txq, txn});
+        txn = 0;
+        return n;
+    }
+private:
+    struct slot {
+        exchange_key key;
+        address addr;
+        timestamp since;
+        word tx_id;
+        bool tx_con;
+    };
+    app_hooks hooks()
+    {
+        return {
+            .handler = [] (void* ctx, app_event_type type, app_event_data) {
+                if (type == app_event_type::transmission)
+                    static_cast<server_engine*>(ctx)->transmit();
+            },
+            .get_time = [] (void* ctx) { return static_cast<server_engine*>(ctx)->now; },
+            .next_id = [] (void* ctx) { return static_cast<server_engine*>(ctx)->id++; },
+            .ctx = this,
+        };
+    }
+    size_t index(const server& s) const
+    {
+        assert(&s >= sessions && &s < sessions + N);
+        return &s - sessions;
+    }
+    size_t acquire(const exchange_key& key, const address& addr)
+    {
+        if (full())
+            return N;
+        auto idx = used.acquire_any();
+        ++len;
+        table.insert({key, uint32_t(idx)});
+        slots[idx] = {key, addr, now, 0, false};
+        sessions[idx].init(packet_view{bufs[idx]});
+        return idx;
+    }
+    void release(size_t idx)
+    {
+        table.erase(slots[idx].key);
+        if (slots[idx].tx_con)
+            table.erase(exchange_key::from_id(slots[idx].addr, slots[idx].tx_id));
+        used.clr(idx);
+        --len;
+    }
+    void transmit()
+    {
+        auto& pkt = sessions[active].get_packet();
+        auto& info = slots[active];
+        if (pkt.get_type() == +msg_type::con && !(info.tx_con && info.tx_id == pkt.get_id())) {
+            if (info.tx_con)
+                table.erase(exchange_key::from_id(info.addr, info.tx_id));
+            info.tx_con = true;
+            info.tx_id = pkt.get_id();
+            table.insert({exchange_key::from_id(info.addr, info.tx_id), uint32_t(active)});
+        }
+        if (pkt.get_type() == +msg_type::ack) {
+            if (auto e = dedup.find(info.addr, pkt.get_id(), now))
+                e->store(pkt);
+        }
+        enqueue(info.addr, pkt);
+    }
+    void enqueue(const address& addr, ispan pkt)
+    {
+        if (txn == TxBatch)
+            flush();
+        std::ranges::copy(pkt, txbuf[txn]);
+        txq[txn] = {addr, {txbuf[txn], pkt.size()}};
+        ++txn;
+    }
+private:
+    static constexpr size_t table_size = std::bit_ceil(2 * N);
+
+    Transport& tr;
+    timestamp now = 0;
+    word id;
+    size_t active = 0;
+    size_t len = 0;
+    size_t txn = 0;
+    bitset<size_t, N, 16> used;
+    flat_map<exchange_key, uint32_t, table_size, exchange_key_hash> table;
+    dedup_cache<Dedup, PacketSize> dedup;
+    server sessions[N];
+    slot slots[N];
+    byte bufs[N][PacketSize];
+    datagram txq[TxBatch];
+    byte txbuf[TxBatch][PacketSize];
+};
+
+}
+
+#endif
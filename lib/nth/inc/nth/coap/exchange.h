@@ -0,0 +1,74 @@
+#ifndef NTH_COAP_EXCHANGE_H
+#define NTH_COAP_EXCHANGE_H
+
+#include "nth/coap/address.h"
+#include "nth/container/flat_map.h"
+
+namespace nth::coap {
+
+/**
+ * @brief Exchange identifier: remote endpoint plus either token of
+ * request or, if 'tkl' is 'id_tkl', message ID. The latter is needed to
+ * match empty ACK and RST, which only echo ID, and duplicate messages.
+ *
+ */
+struct exchange_key {
+
+    static constexpr byte id_tkl = 0xff;
+
+    static constexpr exchange_key from_token(const address& addr, ispan tok)
+    {
+        exchange_key k = {addr};
+        k.tkl = byte(tok.size());
+        std::ranges::copy(tok, k.tok);
+        return k;
+    }
+    static constexpr exchange_key from_id(const address& addr, word id)
+    {
+        exchange_key k = {addr};
+        k.tkl = id_tkl;
+        k.tok[0] = byte(id >> 8);
+        k.tok[1] = byte(id);
+        return k;
+    }
+    constexpr size_t tok_size() const
+    {
+        return tkl == id_tkl ? 2 : tkl;
+    }
+    constexpr bool operator==(const exchange_key& rhs) const
+    {
+        return tkl == rhs.tkl && addr == rhs.addr && std::equal(tok, tok + tok_size(), rhs.tok);
+    }
+
+    address addr;
+    byte tok[8] = {};
+    byte tkl = 0;
+};
+
+/**
+ * @brief Hash for exchange_key, feeds only meaningful bytes of address
+ * and token into FNV-1a and finalizes it with nth::flat_hash.
+ *
+ */
+struct exchange_key_hash {
+    constexpr size_t operator()(const exchange_key& k) const
+    {
+        uint64_t h = 0xcbf29ce484222325;
+        auto feed = [&h] (ispan bytes) {
+            for (auto it : bytes) {
+                h ^= it;
+                h *= 0x100000001b3;
+            }
+        };
+        if (k.addr.type == addr_type::ipv6)
+            feed(k.addr.data.ipv6);
+        else
+            feed(k.addr.data.ipv4);
+        feed({k.tok, k.tok_size()});
+        return flat_hash::mix(h ^ (uint64_t(k.addr.port) << 40) ^ (uint64_t(k.tkl) << 32));
+    }
+};
+
+}
+
+#endif
@@ -27,14 +27,50 @@ struct app_event {
     app_event_data data;
 };
 
+/**
+ * @brief Application hooks behind 'app_' functions. Sessions don't know
+ * who owns them, so owner (e.g. nth::coap::server_engine) installs its
+ * hooks for the duration of each call into session and 'ctx' tells it
+ * which one. Any hook can be left empty. Thread-local, so independent
+ * engines can run in different threads.
+ *
+ */
+struct app_hooks {
+    void (*handler)(void* ctx, app_event_type type, app_event_data data) = nullptr;
+    timestamp (*get_time)(void* ctx) = nullptr;
+    word (*next_id)(void* ctx) = nullptr;
+    void* ctx = nullptr;
+};
+
+inline thread_local app_hooks app_current = {};
+
+/**
+ * @brief Install hooks until the end of scope, restoring previous ones.
+ *
+ */
+struct app_hooks_scope {
+    app_hooks_scope(const app_hooks& hooks) : prev{app_current} { app_current = hooks; }
+    app_hooks_scope(const app_hooks_scope&) = delete;
+    app_hooks_scope& operator=(const app_hooks_scope&) = delete;
+    ~app_hooks_scope() { app_current = prev; }
+private:
+    app_hooks prev;
+};
+
 inline void app_handler(app_event_type type, app_event_data data = {})
 {
-    // TODO
+    if (app_current.handler)
+        app_current.handler(app_current.ctx, type, data);
 }
 
 inline timestamp app_get_time()
 {
-    return 0;
+    return app_current.get_time ? app_current.get_time(app_current.ctx) : 0;
+}
+
+inline word app_next_id()
+{
+    return app_current.next_id ? app_current.next_id(app_current.ctx) : 0;
 }
 
 }
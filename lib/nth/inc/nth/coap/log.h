@@ -106,6 +106,7 @@ constexpr auto str_msg_code(msg_code code)
         case msg_code::valid:                        return "Valid";
         case msg_code::changed:                      return "Changed";
         case msg_code::content:                      return "Content";
+        case msg_code::continue_:                    return "Continue";
         case msg_code::bad_request:                  return "Bad Request";
         case msg_code::unauthorized:                 return "Unauthorized";
         case msg_code::bad_option:                   return "Bad Option";
@@ -113,6 +114,7 @@ constexpr auto str_msg_code(msg_code code)
         case msg_code::not_found:                    return "Not Found";
         case msg_code::method_not_allowed:           return "Method Not Allowed";
         case msg_code::not_acceptable:               return "Not Acceptable";
+        case msg_code::request_entity_incomplete:    return "Request Entity Incomplete";
         case msg_code::precondition_failed:          return "Precondition Failed";
         case msg_code::request_entity_too_large:     return "Request Entity Too Large";
         case msg_code::unsupported_content_format:   return "Unsupported Content-Format";
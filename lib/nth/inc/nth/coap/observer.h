@@ -1,78 +1,326 @@
 #ifndef NTH_COAP_OBSERVER_H
 #define NTH_COAP_OBSERVER_H
 
-#include "nth/coap/address.h"
+#include "nth/coap/exchange.h"
+#include "nth/coap/packet.h"
+#include "nth/coap/config.h"
+#include "nth/coap/hal.h"
 
 namespace nth::coap {
 
-struct observer {
-    observer* next = nullptr;
-    address addr;
-    uint8_t tok[8];
-    uint8_t tkl;
-    uint16_t id;
-    bool reliable;
-};
+/**
+ * @brief Observers of a single resource (RFC 7641). Observers are kept
+ * in dense array, so fan-out walks contiguous memory, and indexed by
+ * endpoint with token, for registration and cancellation, and by
+ * endpoint with message ID of each of the last 'Ids' notifications, for
+ * RST and ACK to them, both in O(1). Every update is encoded once as a
+ * template (code, Observe, extra options and payload) and for each
+ * observer only header with its token and fresh message ID is written in
+ * front of it, then notifications go to transport in batches. Message IDs
+ * and time come from 'app_' hooks, so notify from within engine hooks,
+ * see nth::coap::server_engine::notify.
+ *
+ * Confirmable notification is retransmitted by 'poll' with exponential
+ * backoff from random timeout between 'imp::ack_timeout' and
+ * 'imp::ack_timeout' * 'imp::ack_random_factor' until ACK to it. Newer
+ * update replaces it, keeping its retransmission counter and timeout
+ * (RFC 7641 4.5.2), and observer is dropped after
+ * 'imp::max_retransmit_cnt' retransmissions without ACK. ACK to earlier
+ * notification, which arrives after newer one was sent, still shows that
+ * endpoint is alive and restarts retransmission counter of current one.
+ *
+ * @tparam N Maximum number of observers
+ * @tparam PacketSize Maximum size of notification
+ * @tparam TxBatch Maximum number of notifications per transport call
+ * @tparam Ids Number of recent notification message IDs per observer
+ */
+template<size_t N, size_t PacketSize = imp::default_packet_size, size_t TxBatch = 32, size_t Ids = 4>
+struct observer_registry {
+
+    struct observer {
+        exchange_key key;
+        word ids[Ids];      // Message IDs of recent notifications, oldest first
+        byte nids;          // Number of valid 'ids'
+        byte retx;          // Retransmissions of current CON notification
+        bool pending;       // Current notification is CON without ACK yet
+        timestamp due;      // Time of next retransmission
+        timestamp timeout;  // Current retransmission timeout
+    };
+
+    static_assert(N && Ids && Ids <= 0xff && N * Ids <= 0x10000 && TxBatch);
 
-struct observer_iter {
-    constexpr observer_iter(observer *p) : p{p} {}
-    constexpr bool operator==(const observer_iter &rhs) const   { return p == rhs.p }
-    constexpr const observer* operator->() const                { return p; }
-    constexpr const observer& operator*() const                 { return *p; }
-    constexpr observer* operator->()                            { return p; }
-    constexpr observer& operator*()                             { return *p; }
-    constexpr observer_iter& operator++()
+    observer_registry() = default;
+    observer_registry(const observer_registry&) = delete;
+    observer_registry& operator=(const observer_registry&) = delete;
+
+    static constexpr size_t capacity()                  { return N; }
+    size_t size() const noexcept                        { return len; }
+    bool empty() const noexcept                         { return len == 0; }
+    bool full() const noexcept                          { return len == N; }
+    uint32_t sequence() const noexcept                  { return seq; }
+    std::span<const observer> observers() const         { return {obs, len}; }
+
+    /**
+     * @brief Add observer or refresh existing one with the same
+     * endpoint and token.
+     *
+     * @param addr Remote endpoint
+     * @param tok Token of registration request
+     * @return False if registry is full
+     */
+    bool subscribe(const address& addr, ispan tok)
     {
-        p = p->next;
-        return *this;
+        auto key = exchange_key::from_token(addr, tok);
+        if (auto it = by_tok.find(key); it != by_tok.end()) {
+            obs[it->second].retx = 0;
+            return true;
+        }
+        if (full())
+            return false;
+        obs[len] = {};
+        obs[len].key = key;
+        by_tok.insert({key, uint32_t(len)});
+        ++len;
+        return true;
     }
-private:
-    observer* p;
-};
 
-struct observer_list {
-    constexpr bool append(observer* obs)
+    /**
+     * @brief Remove observer.
+     *
+     * @param addr Remote endpoint
+     * @param tok Token of registration request
+     * @return True if observer was present
+     */
+    bool unsubscribe(const address& addr, ispan tok)
     {
-        if (obs == nullptr)
+        auto it = by_tok.find(exchange_key::from_token(addr, tok));
+        if (it == by_tok.end())
             return false;
-        for (const auto& it : *this)
-            if (&it == obs)
-                return false; // Already in list
-
-        if (head == nullptr)
-            head = obs;
-        if (tail == nullptr)
-            tail = obs;
-        obs->next = nullptr;
+        remove(it->second);
         return true;
     }
-    constexpr bool remove(observer* obs)
+
+    /**
+     * @brief Handle request to resource: Observe 0 registers, Observe 1
+     * or request without Observe with the same token deregisters.
+     *
+     * @param addr Remote endpoint
+     * @param req Parsed request
+     * @return True if observer is registered and response should carry
+     * 'seq_option'
+     */
+    bool observe(const address& addr, const packet_view& req)
+    {
+        auto opt = req.opt_get(option_num::observe);
+        if (opt_valid(opt) && opt_uint_decode(opt) == 0 && req.get_code() == +msg_code::get)
+            return subscribe(addr, req.get_token());
+        unsubscribe(addr, req.get_token());
+        return false;
+    }
+
+    /**
+     * @brief Observe option with current sequence number, for response
+     * to registration. Points into registry.
+     *
+     * @return Option
+     */
+    option seq_option()
     {
-        observer* prev = nullptr;
-        bool found = false;;
+        return {seq_buf, opt_uint_encode(seq & 0xffffff, seq_buf), +option_num::observe};
+    }
 
-        for (auto &it : *this) {
-            if (obs == &it) {
-                found = true;
-                break;
+    /**
+     * @brief Handle empty ACK or RST, which engine didn't match to any
+     * exchange. RST to any of recent notifications cancels observation.
+     * ACK to current one confirms it, ACK to earlier one restarts its
+     * retransmission counter.
+     *
+     * @param dg Received datagram
+     * @return True if it matched notification
+     */
+    bool feed(const datagram& dg)
+    {
+        auto raw = dg.data;
+        if (raw.size() < 4)
+            return false;
+        auto type = msg_type((raw[0] >> 4) & 0x3);
+        if (type != msg_type::ack && type != msg_type::rst)
+            return false;
+        auto mid = word((raw[2] << 8) | raw[3]);
+        auto it = by_id.find(exchange_key::from_id(dg.addr, mid));
+        if (it == by_id.end())
+            return false;
+        size_t idx = it->second;
+        auto& o = obs[idx];
+        if (type == msg_type::rst) {
+            remove(idx);
+        } else if (mid == o.ids[o.nids - 1]) {
+            while (o.nids > 1)
+                forget(o, 0);
+            o.pending = false;
+            o.retx = 0;
+        } else {
+            forget(o, size_t(std::ranges::find(o.ids, o.ids + o.nids, mid) - o.ids));
+            if (o.pending) {
+                o.retx = 0;
+                o.timeout = initial_timeout();
             }
-            prev = &it;
         }
-        if (!found)
-            return false;
+        return true;
+    }
 
-        prev->next = obs->next;
-        obs->next = nullptr;
+    /**
+     * @brief Send notification to every observer. Observer with
+     * confirmable notification still pending gets this one as
+     * confirmable too, replacing it.
+     *
+     * @param tr Transport
+     * @param payload Payload
+     * @param code Response code
+     * @param con Send confirmable notifications
+     * @param opts Extra options, e.g. Content-Format
+     * @return Number of notifications handed to transport
+     */
+    template<transport Transport>
+    size_t notify(Transport& tr, ispan payload, msg_code code = msg_code::content, bool con = false, std::span<const option> opts = {})
+    {
+        tmpl.flush();
+        tmpl.setup(msg_type::non, code, 0, {});
+        opt_insert_uint(tmpl, option_num::observe, (seq + 1) & 0xffffff);
+        for (auto& it : opts)
+            tmpl.opt_insert(it);
+        if (!tmpl.set_payload(payload) || tmpl.size() + 8 > PacketSize)
+            return 0;
+        ++seq;
+        cur_len = tmpl.size();
+        std::ranges::copy(ispan{tmpl}, cur);
 
-        return true;
+        auto now = app_get_time();
+        size_t sent = 0;
+        for (size_t i = 0; i < len; ++i) {
+            auto& o = obs[i];
+            if (o.nids == Ids)
+                forget(o, 0);
+            o.ids[o.nids++] = app_next_id();
+            by_id.insert({exchange_key::from_id(o.key.addr, o.ids[o.nids - 1]), uint32_t(i)});
+            if (con && !o.pending) {
+                o.pending = true;
+                o.retx = 0;
+                o.timeout = initial_timeout();
+                o.due = now + o.timeout;
+            }
+            sent += enqueue(tr, o);
+        }
+        return sent + flush(tr);
+    }
+
+    /**
+     * @brief Retransmit confirmable notifications, which weren't
+     * acknowledged in time, and drop observers, which didn't acknowledge
+     * any after 'imp::max_retransmit_cnt' retransmissions.
+     *
+     * @param tr Transport
+     * @param now Current time
+     * @return Number of notifications handed to transport
+     */
+    template<transport Transport>
+    size_t poll(Transport& tr, timestamp now)
+    {
+        size_t sent = 0;
+        for (size_t i = 0; i < len; ) {
+            auto& o = obs[i];
+            if (!o.pending || o.due > now) {
+                ++i;
+                continue;
+            }
+            if (o.retx >= imp::max_retransmit_cnt) {
+                remove(i);
+                continue;
+            }
+            ++o.retx;
+            o.timeout *= 2;
+            o.due = now + o.timeout;
+            sent += enqueue(tr, o);
+            ++i;
+        }
+        return sent + flush(tr);
+    }
+
+    void clear()
+    {
+        by_tok.clear();
+        by_id.clear();
+        len = 0;
+    }
+private:
+    template<class Transport>
+    size_t enqueue(Transport& tr, const observer& o)
+    {
+        auto type = o.pending ? msg_type::con : msg_type::non;
+        auto id = o.ids[o.nids - 1];
+        auto body = ispan{cur, cur_len}.subspan(4);
+        auto dst = txbuf[txn];
+        dst[0] = byte((cur[0] & 0xc0) | (+type << 4) | o.key.tkl);
+        dst[1] = cur[1];
+        dst[2] = byte(id >> 8);
+        dst[3] = byte(id);
+        std::copy_n(o.key.tok, o.key.tkl, dst + 4);
+        std::ranges::copy(body, dst + 4 + o.key.tkl);
+        txq[txn++] = {o.key.addr, {dst, 4 + o.key.tkl + body.size()}};
+        return txn == TxBatch ? flush(tr) : 0;
+    }
+    template<class Transport>
+    size_t flush(Transport& tr)
+    {
+        size_t n = txn ? size_t(tr.send(std::span<const datagram>{txq, txn})) : 0;
+        txn = 0;
+        return n;
+    }
+    void forget(observer& o, size_t pos)
+    {
+        by_id.erase(exchange_key::from_id(o.key.addr, o.ids[pos]));
+        std::copy(o.ids + pos + 1, o.ids + o.nids, o.ids + pos);
+        --o.nids;
+    }
+    void remove(size_t idx)
+    {
+        auto& o = obs[idx];
+        by_tok.erase(o.key);
+        for (size_t j = 0; j < o.nids; ++j)
+            by_id.erase(exchange_key::from_id(o.key.addr, o.ids[j]));
+        if (idx != --len) {
+            o = obs[len];
+            by_tok.find(o.key)->second = uint32_t(idx);
+            for (size_t j = 0; j < o.nids; ++j)
+                by_id.find(exchange_key::from_id(o.key.addr, o.ids[j]))->second = uint32_t(idx);
+        }
+    }
+    timestamp initial_timeout()
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return imp::ack_timeout + timestamp(rng % (timestamp(imp::ack_timeout * (imp::ack_random_factor - 1)) + 1));
     }
-    constexpr const observer_iter begin() const { return head; }
-    constexpr const observer_iter end()   const { return nullptr; }
 private:
-    observer* head;
-    observer* tail;
+    static constexpr size_t table_size = std::bit_ceil(2 * N);
+    static constexpr size_t id_table_size = std::bit_ceil(2 * N * Ids);
+
+    flat_map<exchange_key, uint32_t, table_size, exchange_key_hash> by_tok;
+    flat_map<exchange_key, uint32_t, id_table_size, exchange_key_hash> by_id;
+    observer obs[N];
+    size_t len = 0;
+    size_t txn = 0;
+    size_t cur_len = 0;
+    uint32_t seq = 0;
+    uint32_t rng = 0x9e3779b9;
+    byte seq_buf[4];
+    packet<PacketSize> tmpl;
+    byte cur[PacketSize];
+    datagram txq[TxBatch];
+    byte txbuf[TxBatch][PacketSize];
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -343,6 +343,39 @@ constexpr option opt_decode(const byte* ptr, const byte* end, word opt_delta)
     return {ptr, length, word(opt_delta + delta)};
 }
 
+/**
+ * @brief Encode unsigned integer option value in network byte order
+ * without leading zeros, so zero takes no bytes at all.
+ *
+ * @param val Value
+ * @param p Destination, at least 4 bytes
+ * @return Number of bytes written
+ */
+constexpr word opt_uint_encode(uint32_t val, byte* p)
+{
+    word len = 0;
+    for (auto tmp = val; tmp; tmp >>= 8)
+        ++len;
+    for (word i = 0; i < len; ++i)
+        p[i] = byte(val >> (8 * (len - 1 - i)));
+    return len;
+}
+
+/**
+ * @brief Decode unsigned integer option value. Values longer than
+ * 4 bytes are truncated to the least significant ones.
+ *
+ * @param opt Option
+ * @return Value
+ */
+constexpr uint32_t opt_uint_decode(option opt)
+{
+    uint32_t val = 0;
+    for (word i = 0; i < opt.len; ++i)
+        val = (val << 8) | opt.dat[i];
+    return val;
+}
+
 /**
  * @brief An iterator for CoAP options in a serialized buffer. It provides methods
  * for iterating over the options, checking their validity, and accessing
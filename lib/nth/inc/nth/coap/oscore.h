@@ -1,845 +1,537 @@
-#ifndef COAP_OSCORE_H
-#define COAP_OSCORE_H
-
-#include "coap/cose.h"
-#include "coap/packet.h"
+#ifndef NTH_COAP_OSCORE_H
+#define NTH_COAP_OSCORE_H
+
+#include "nth/coap/builder.h"
+#include "nth/cbor/enc.h"
+#include "nth/crypto/cipher/aes.h"
+#include "nth/crypto/hash/sha2.h"
+#include "nth/crypto/kdf/hkdf.h"
+#include "nth/crypto/mode/ccm.h"
+#include "nth/util/bitslide.h"
 #include <string_view>
 
-namespace coap {
-
-enum CoseAlgorithm {
-    cose_es256              = -7,   // ECDSA w/ SHA-256
-    cose_es384              = -35,  // ECDSA w/ SHA-384
-    cose_es512              = -36,  // ECDSA w/ SHA-512
-    cose_eddsa              = -8,   // EdDSA
-    cose_hmac_256_64        = 4,    // HMAC w/ SHA-256 truncated to 64 bits 
-    cose_hmac_256_256       = 5,    // HMAC w/ SHA-256 
-    cose_hmac_384_384       = 6,    // HMAC w/ SHA-384 
-    cose_hmac_512_512       = 7,    // HMAC w/ SHA-512 
-    cose_aes_mac_128_64     = 14,   // AES-MAC 128-bit key, 64-bit tag 
-    cose_aes_mac_256_64     = 15,   // AES-MAC 256-bit key, 64-bit tag 
-    cose_aes_mac_128_128    = 25,   // AES-MAC 128-bit key, 128-bit tag
-    cose_aes_mac_256_128    = 26,   // AES-MAC 256-bit key, 128-bit tag
-    cose_a128gcm            = 1,    // AES-GCM mode w/ 128-bit key, 128-bit tag
-    cose_a192gcm            = 2,    // AES-GCM mode w/ 192-bit key, 128-bit tag
-    cose_a256gcm            = 3,    // AES-GCM mode w/ 256-bit key, 128-bit tag
-    cose_aes_ccm_16_64_128  = 10,   // AES-CCM mode 128-bit key, 64-bit tag, 13-byte nonce
-    cose_aes_ccm_16_64_256  = 11,   // AES-CCM mode 256-bit key, 64-bit tag, 13-byte nonce
-    cose_aes_ccm_64_64_128  = 12,   // AES-CCM mode 128-bit key, 64-bit tag, 7-byte nonce 
-    cose_aes_ccm_64_64_256  = 13,   // AES-CCM mode 256-bit key, 64-bit tag, 7-byte nonce 
-    cose_aes_ccm_16_128_128 = 30,   // AES-CCM mode 128-bit key, 128-bit tag, 13-byte nonce  
-    cose_aes_ccm_16_128_256 = 31,   // AES-CCM mode 256-bit key, 128-bit tag, 13-byte nonce 
-    cose_aes_ccm_64_128_128 = 32,   // AES-CCM mode 128-bit key, 128-bit tag, 7-byte nonce
-    cose_aes_ccm_64_128_256 = 33,   // AES-CCM mode 256-bit key, 128-bit tag, 7-byte nonce
-    cose_chacha20_poly1305  = 24,   // ChaCha20/Poly1305 w/ 256-bit key, 128-bit tag
+namespace nth::coap {
+
+/**
+ * @brief COSE algorithm identifiers.
+ *
+ */
+enum class cose_alg {
+    es256               = -7,   // ECDSA w/ SHA-256
+    es384               = -35,  // ECDSA w/ SHA-384
+    es512               = -36,  // ECDSA w/ SHA-512
+    eddsa               = -8,   // EdDSA
+    hmac_256_64         = 4,    // HMAC w/ SHA-256 truncated to 64 bits
+    hmac_256_256        = 5,    // HMAC w/ SHA-256
+    hmac_384_384        = 6,    // HMAC w/ SHA-384
+    hmac_512_512        = 7,    // HMAC w/ SHA-512
+    aes_mac_128_64      = 14,   // AES-MAC 128-bit key, 64-bit tag
+    aes_mac_256_64      = 15,   // AES-MAC 256-bit key, 64-bit tag
+    aes_mac_128_128     = 25,   // AES-MAC 128-bit key, 128-bit tag
+    aes_mac_256_128     = 26,   // AES-MAC 256-bit key, 128-bit tag
+    a128gcm             = 1,    // AES-GCM mode w/ 128-bit key, 128-bit tag
+    a192gcm             = 2,    // AES-GCM mode w/ 192-bit key, 128-bit tag
+    a256gcm             = 3,    // AES-GCM mode w/ 256-bit key, 128-bit tag
+    aes_ccm_16_64_128   = 10,   // AES-CCM mode 128-bit key, 64-bit tag, 13-byte nonce
+    aes_ccm_16_64_256   = 11,   // AES-CCM mode 256-bit key, 64-bit tag, 13-byte nonce
+    aes_ccm_64_64_128   = 12,   // AES-CCM mode 128-bit key, 64-bit tag, 7-byte nonce
+    aes_ccm_64_64_256   = 13,   // AES-CCM mode 256-bit key, 64-bit tag, 7-byte nonce
+    aes_ccm_16_128_128  = 30,   // AES-CCM mode 128-bit key, 128-bit tag, 13-byte nonce
+    aes_ccm_16_128_256  = 31,   // AES-CCM mode 256-bit key, 128-bit tag, 13-byte nonce
+    aes_ccm_64_128_128  = 32,   // AES-CCM mode 128-bit key, 128-bit tag, 7-byte nonce
+    aes_ccm_64_128_256  = 33,   // AES-CCM mode 256-bit key, 128-bit tag, 7-byte nonce
+    chacha20_poly1305   = 24,   // ChaCha20/Poly1305 w/ 256-bit key, 128-bit tag
+};
+
+/**
+ * @brief OSCORE processing result.
+ *
+ */
+enum class oscore_error {
+    ok,
+    no_option,
+    reserved_bits,
+    replay,
+    unknown_kid,
+    illegal_kid_length,
+    illegal_piv_length,
+    illegal_tag_length,
+    invalid_plaintext,
+    sequence_wrap,
+    out_of_memory,
+    crypto_fail,
 };
 
-constexpr bool is_class_e(word num)
+/**
+ * @brief Is option class E, i.e. encrypted and integrity protected
+ * as part of plaintext. Observe is both class E and U.
+ *
+ * @param num Option number
+ * @return true if yes
+ */
+constexpr bool opt_class_e(word num)
 {
-    switch (num) {
-        case option_num_uri_host: 
-        case option_num_uri_port: 
-        case option_num_oscore:
-        case option_num_proxy_uri:
-        case option_num_proxy_scheme: return false;
+    switch (option_num(num)) {
+        case option_num::uri_host:
+        case option_num::uri_port:
+        case option_num::oscore:
+        case option_num::proxy_uri:
+        case option_num::proxy_scheme: return false;
         default: return true;
     }
 }
 
-constexpr bool is_class_i([[maybe_unused]] word num)
+/**
+ * @brief Is option class U, i.e. left unprotected in outer message.
+ *
+ * @param num Option number
+ * @return true if yes
+ */
+constexpr bool opt_class_u(word num)
 {
-    return false;
+    return !opt_class_e(num) || num == +option_num::observe;
 }
 
-constexpr bool is_class_u(word num)
+/**
+ * @brief Anti-replay window of OSCORE recipient on top of circular
+ * nth::bitslide_arr, so it can be much wider than machine word and
+ * tolerate heavy reordering. Unlike nth::bitslide, initial value isn't
+ * considered as already received, so the very first sequence number 0
+ * passes: numbers are stored shifted by one, which never overflows as
+ * OSCORE sequence numbers are at most 40 bits.
+ *
+ * @tparam Bits Window size, power of 2, at least 32
+ */
+template<size_t Bits = imp::oscore_replay_window>
+struct replay_window {
+
+    constexpr replay_window() = default;
+
+    constexpr uint64_t latest() const           { return win.latest() - 1; }
+    constexpr bool check(uint64_t seqn) const   { return win.check(seqn + 1); }
+    constexpr void update(uint64_t seqn)        { win.update(seqn + 1); }
+    constexpr bool check_and_update(uint64_t seqn)
+    {
+        return win.check_and_update(seqn + 1);
+    }
+private:
+    bitslide_arr<uint64_t, uint32_t, Bits> win;
+};
+
+/**
+ * @brief Decoded value of OSCORE option (RFC 8613, 6.1). Spans point
+ * into option value.
+ *
+ */
+struct oscore_option {
+    ispan piv;
+    ispan ctx;
+    ispan kid;
+    bool kid_flag = false;
+    bool ctx_flag = false;
+};
+
+/**
+ * @brief Decode OSCORE option value.
+ *
+ * @param opt Option
+ * @param val Decoded value
+ * @return Error status
+ */
+constexpr oscore_error oscore_option_decode(option opt, oscore_option& val)
 {
-    switch (num) {
-        case option_num_uri_host:
-        case option_num_observe:
-        case option_num_uri_port:
-        case option_num_oscore:
-        case option_num_max_age:
-        case option_num_block2:
-        case option_num_block1:
-        case option_num_size2:
-        case option_num_proxy_uri: 
-        case option_num_proxy_scheme: 
-        case option_num_size1:
-        case option_num_no_response: return true;
-        default: return false;
+    val = {};
+    if (opt.len == 0)
+        return oscore_error::ok;
+    auto p = opt.dat;
+    auto end = opt_edge(opt);
+    auto flags = *p++;
+    if (flags & 0xe0)
+        return oscore_error::reserved_bits;
+    size_t n = flags & 0x07;
+    if (n > 5 || size_t(end - p) < n)
+        return oscore_error::illegal_piv_length;
+    val.piv = {p, n};
+    p += n;
+    val.ctx_flag = flags & 0x10;
+    val.kid_flag = flags & 0x08;
+    if (val.ctx_flag) {
+        if (p == end || size_t(end - p - 1) < *p)
+            return oscore_error::illegal_kid_length;
+        val.ctx = {p + 1, *p};
+        p += 1 + *p;
     }
+    if (val.kid_flag)
+        val.kid = {p, end};
+    else if (p != end)
+        return oscore_error::illegal_kid_length;
+    return oscore_error::ok;
 }
 
-enum OscoreErr {
-    oscore_err_ok,
-    oscore_err_no_option,
-    oscore_err_reserved_bits,
-    oscore_err_replay,
-    oscore_err_illegal_kid_length,
-    oscore_err_illegal_piv_length,
-    oscore_err_illegal_tag_length,
-    oscore_err_out_of_memory,
-    oscore_err_crypto_fail,
+/**
+ * @brief Parameters of request, which its response is cryptographically
+ * bound to: 'kid' and 'Partial IV' of request sender. Filled when request
+ * is protected by client or verified by server, then given back to
+ * protect or verify response.
+ *
+ */
+struct oscore_request {
+    byte kid[7];
+    byte piv[5];
+    byte kid_len = 0;
+    byte piv_len = 0;
+
+    constexpr ispan get_kid() const { return {kid, kid_len}; }
+    constexpr ispan get_piv() const { return {piv, piv_len}; }
 };
 
-template<class T = uint32_t>
-struct ReplayWindow {
-
-    ReplayWindow() = default;
-    ReplayWindow(T seqn) : high{seqn} {}
+/**
+ * @brief OSCORE security context (RFC 8613) with AES-CCM-16-64-128 as
+ * AEAD and HKDF-SHA-256 as key derivation function. Sender key,
+ * recipient key and common IV are derived once in 'init', and AES key
+ * schedules of both keys are expanded right away, so protecting and
+ * verifying messages costs only the cipher itself. Nonce and AAD are
+ * built in buffers inside context, verified plaintext is decrypted into
+ * scratch buffer of 'imp::oscore_scratch_size' bytes, while protected
+ * plaintext is encrypted in place within outgoing packet.
+ *
+ * Length requirements:
+ *  1. Sender ID: [0..7]
+ *  2. Recipient ID: [0..7]
+ *  3. ID Context: [0..255], referenced, must outlive context
+ *  4. Master Salt: variable-length, used only in 'init'
+ *  5. Master Secret: variable-length, used only in 'init'
+ */
+struct oscore_context {
+
+    static constexpr auto alg           = cose_alg::aes_ccm_16_64_128;
+    static constexpr size_t key_size    = aes128::key_size;
+    static constexpr size_t nonce_size  = 13;
+    static constexpr size_t tag_size    = 8;
+    static constexpr size_t max_piv     = 5;
+    static constexpr size_t max_id      = nonce_size - 6;
+    static constexpr uint64_t max_seqn  = (uint64_t(1) << (8 * max_piv)) - 1;
+
+    /**
+     * @brief Derive keys and common IV and reset sequence number and
+     * replay window.
+     *
+     * @param secret Master Secret
+     * @param salt Master Salt, may be empty
+     * @param sender Sender ID
+     * @param recipient Recipient ID
+     * @param id_ctx ID Context, may be empty
+     * @return True on success
+     */
+    bool init(ispan secret, ispan salt, ispan sender, ispan recipient, ispan id_ctx = {})
+    {
+        if (sender.size() > max_id || recipient.size() > max_id || id_ctx.size() > 0xff)
+            return false;
+        std::ranges::copy(sender, sid);
+        std::ranges::copy(recipient, rid);
+        sid_len = sender.size();
+        rid_len = recipient.size();
+        ctx = id_ctx;
+        if (!derive(skey, sender, "Key", secret, salt) ||
+            !derive(rkey, recipient, "Key", secret, salt) ||
+            !derive(civ, {}, "IV", secret, salt))
+            return false;
+        sender_ciph.init(skey);
+        recipient_ciph.init(rkey);
+        seqn = 0;
+        window = {};
+        return true;
+    }
 
-    constexpr T latest() const
+    ispan sender_id() const             { return {sid, sid_len}; }
+    ispan recipient_id() const          { return {rid, rid_len}; }
+    ispan id_context() const            { return ctx; }
+    ispan sender_key() const            { return skey; }
+    ispan recipient_key() const         { return rkey; }
+    ispan common_iv() const             { return civ; }
+    uint64_t sequence() const           { return seqn; }
+    void set_sequence(uint64_t seq)     { seqn = seq; }
+
+    /**
+     * @brief Protect request with new Partial IV from sender sequence number.
+     *
+     * @param req Plain request
+     * @param out Protected request
+     * @param bind Request parameters to verify response with
+     * @return Error status
+     */
+    oscore_error protect_req(const packet_view& req, packet_view& out, oscore_request& bind)
     {
-        return high;
+        if (!next_piv(bind))
+            return oscore_error::sequence_wrap;
+        std::ranges::copy(sender_id(), bind.kid);
+        bind.kid_len = sid_len;
+        return protect(req, out, bind.get_piv(), true, !ctx.empty(), bind);
     }
 
-    constexpr bool check(T seqn) const
+    /**
+     * @brief Verify and decrypt request, rejecting replayed ones.
+     *
+     * @param in Protected request
+     * @param out Plain request
+     * @param bind Request parameters to protect response with
+     * @return Error status
+     */
+    oscore_error verify_req(const packet_view& in, packet_view& out, oscore_request& bind)
     {
-        if (seqn > high)
-            return true;
-        if (high - seqn >= bits)
-            return false;
-        return !utl::get_bit(mask, high - seqn);
+        auto opt = in.opt_get(option_num::oscore);
+        if (!opt_valid(opt))
+            return oscore_error::no_option;
+        oscore_option val;
+        if (auto e = oscore_option_decode(opt, val); e != oscore_error::ok)
+            return e;
+        if (val.piv.empty())
+            return oscore_error::illegal_piv_length;
+        if (!val.kid_flag || !std::ranges::equal(val.kid, recipient_id()))
+            return oscore_error::unknown_kid;
+        if (val.ctx_flag && !std::ranges::equal(val.ctx, ctx))
+            return oscore_error::unknown_kid;
+
+        uint64_t seq = 0;
+        for (auto it : val.piv)
+            seq = seq << 8 | it;
+        if (!window.check(seq))
+            return oscore_error::replay;
+
+        std::ranges::copy(val.piv, bind.piv);
+        std::ranges::copy(val.kid, bind.kid);
+        bind.piv_len = val.piv.size();
+        bind.kid_len = val.kid.size();
+
+        auto e = verify(in, out, recipient_id(), val.piv, bind);
+        if (e == oscore_error::ok)
+            window.update(seq);
+        return e;
     }
 
-    constexpr void update(T seqn)
+    /**
+     * @brief Protect response to verified request.
+     *
+     * @param rsp Plain response
+     * @param out Protected response
+     * @param bind Parameters of request
+     * @param use_piv Use own Partial IV instead of request's one,
+     * mandatory for Observe notifications
+     * @return Error status
+     */
+    oscore_error protect_rsp(const packet_view& rsp, packet_view& out, const oscore_request& bind, bool use_piv = false)
     {
-        if (seqn > high)
-            update_latest(seqn);
-        else if (high - seqn >= bits)
-            return;
-        else 
-            utl::set_bit(mask, high - seqn);
+        oscore_request own;
+        if (use_piv && !next_piv(own))
+            return oscore_error::sequence_wrap;
+        return protect(rsp, out, own.get_piv(), false, false, bind);
     }
 
-    constexpr bool check_and_update(T seqn)
+    /**
+     * @brief Verify and decrypt response to protected request.
+     *
+     * @param in Protected response
+     * @param out Plain response
+     * @param bind Parameters of request
+     * @return Error status
+     */
+    oscore_error verify_rsp(const packet_view& in, packet_view& out, const oscore_request& bind)
     {
-        if (seqn > high) {
-            update_latest(seqn);
-            return true;
-        }
-        auto idx = high - seqn;
-        if (idx >= bits)
+        auto opt = in.opt_get(option_num::oscore);
+        if (!opt_valid(opt))
+            return oscore_error::no_option;
+        oscore_option val;
+        if (auto e = oscore_option_decode(opt, val); e != oscore_error::ok)
+            return e;
+        if (val.piv.empty())
+            return verify(in, out, bind.get_kid(), bind.get_piv(), bind);
+        return verify(in, out, recipient_id(), val.piv, bind);
+    }
+private:
+    bool derive(ospan out, ispan id, std::string_view type, ispan secret, ispan salt) const
+    {
+        cbor::encoder<imp::oscore_cbor_size> info;
+        auto e = info.encode_(cbor::enc::arr(5), id);
+        if (e == cbor::err::ok)
+            e = ctx.empty() ? info.encode_prim(cbor::prim_null) : info.encode_data(ctx);
+        if (e == cbor::err::ok)
+            e = info.encode_(int(+alg), type, uint64_t(out.size()));
+        if (e != cbor::err::ok)
             return false;
-        if (utl::get_bit(mask, idx))
+        return hkdf<sha256>(out, {secret.data(), secret.size()}, {salt.data(), salt.size()}, {info.data(), info.size()});
+    }
+    bool next_piv(oscore_request& bind)
+    {
+        if (seqn > max_seqn)
             return false;
-        utl::set_bit(mask, idx);
+        auto seq = seqn++;
+        bind.piv_len = 0;
+        do {
+            ++bind.piv_len;
+        } while (seq >> (8 * bind.piv_len));
+        for (int i = bind.piv_len - 1; i >= 0; --i, seq >>= 8)
+            bind.piv[i] = byte(seq);
         return true;
     }
-private:
-    constexpr void update_latest(T seqn)
+    void make_nonce(ispan id, ispan piv)
     {
-        auto diff = seqn - high;
-        mask = 1 | (diff < bits ? mask << diff : 0);
-        high = seqn;
+        std::ranges::fill(nonce, 0);
+        nonce[0] = byte(id.size());
+        std::ranges::copy(id, nonce + 1 + max_id - id.size());
+        std::ranges::copy(piv, nonce + nonce_size - piv.size());
+        xorb(nonce, civ, nonce_size);
+    }
+    void make_aad(const oscore_request& bind)
+    {
+        cbor::encoder<32> arr; // 'aad_array', at most 19 bytes
+        arr.encode_(
+            cbor::enc::arr(5),
+            imp::oscore_version,
+            cbor::enc::arr(1),
+            int(+alg),
+            bind.get_kid(),
+            bind.get_piv(),
+            cbor::span{}); // NOTE: No class I options currently exist
+        aad.clear();
+        aad.encode_(
+            cbor::enc::arr(3),
+            std::string_view{"Encrypt0"},
+            cbor::span{},
+            cbor::span{arr.data(), arr.size()});
+    }
+    oscore_error protect(const packet_view& in, packet_view& out, ispan piv, bool use_kid, bool use_ctx, const oscore_request& bind)
+    {
+        // OSCORE option value goes to scratch, it's free until verify
+        size_t n = 0;
+        if (!piv.empty() || use_kid || use_ctx)
+            scratch[n++] = byte(piv.size() | use_kid << 3 | use_ctx << 4);
+        n = std::ranges::copy(piv, scratch + n).out - scratch;
+        if (use_ctx) {
+            if (n + 1 + ctx.size() + sid_len > sizeof(scratch))
+                return oscore_error::out_of_memory;
+            scratch[n++] = byte(ctx.size());
+            n = std::ranges::copy(ctx, scratch + n).out - scratch;
+        }
+        if (use_kid)
+            n = std::ranges::copy(sender_id(), scratch + n).out - scratch;
+
+        bool observe = in.opt_is_set(option_num::observe);
+        auto code = in.get_code_class() == +msg_class::request ?
+            (observe ? msg_code::fetch : msg_code::post) :
+            (observe ? msg_code::content : msg_code::changed);
+
+        packet_builder b{out, msg_type(in.get_type()), code, in.get_id(), in.get_token()};
+        bool added = false;
+        size_t len = 1;
+        word prev = 0;
+        for (auto opt : in.get_options()) {
+            if (!added && opt.num > +option_num::oscore) {
+                b.add(option_num::oscore, {scratch, n});
+                added = true;
+            }
+            if (opt_class_u(opt.num))
+                b.add(option_num(opt.num), {opt.dat, opt.len});
+            if (opt_class_e(opt.num)) {
+                len += opt_total_size(opt.num - prev, opt.len);
+                prev = opt.num;
+            }
+        }
+        if (!added)
+            b.add(option_num::oscore, {scratch, n});
+        auto pld = in.get_payload();
+        if (!pld.empty())
+            len += 1 + pld.size();
+
+        // Plaintext is written right where ciphertext goes and encrypted in place
+        auto dst = b.payload(len + tag_size);
+        if (dst.data() == nullptr)
+            return oscore_error::out_of_memory;
+        auto p = dst.data();
+        *p++ = in.get_code();
+        prev = 0;
+        for (auto opt : in.get_options()) {
+            if (opt_class_e(opt.num)) {
+                p = opt_encode(p, opt.num - prev, opt.len, opt.dat);
+                prev = opt.num;
+            }
+        }
+        if (!pld.empty()) {
+            *p++ = 0xff;
+            std::ranges::copy(pld, p);
+        }
+        if (piv.empty())
+            make_nonce(bind.get_kid(), bind.get_piv());
+        else
+            make_nonce(sender_id(), piv);
+        make_aad(bind);
+
+        if (!ccm_encrypt<aes128>(sender_ciph, nonce, {aad.data(), aad.size()}, dst.subspan(len), dst.data(), dst.data(), len))
+            return oscore_error::crypto_fail;
+        return oscore_error::ok;
+    }
+    oscore_error verify(const packet_view& in, packet_view& out, ispan id, ispan piv, const oscore_request& bind)
+    {
+        auto pld = in.get_payload();
+        if (pld.size() < 1 + tag_size)
+            return oscore_error::illegal_tag_length;
+        auto len = pld.size() - tag_size;
+        if (len > sizeof(scratch))
+            return oscore_error::out_of_memory;
+
+        make_nonce(id, piv);
+        make_aad(bind);
+
+        if (!ccm_decrypt<aes128>(recipient_ciph, nonce, {aad.data(), aad.size()}, {pld.data() + len, tag_size}, pld.data(), scratch, len))
+            return oscore_error::crypto_fail;
+
+        // Plaintext is code, class E options and optional payload
+        auto end = scratch + len;
+        auto p = scratch + 1;
+        for (auto opt : option_range{p, end}) {
+            if (opt_edge(opt) > end)
+                return oscore_error::invalid_plaintext;
+            p = const_cast<byte*>(opt_edge(opt));
+        }
+        auto inner_end = p;
+        if (p != end && (*p != 0xff || p + 1 == end))
+            return oscore_error::invalid_plaintext;
+
+        // Merge outer class U options (taking Observe from inner) with inner ones, both are sorted
+        packet_builder b{out, msg_type(in.get_type()), msg_code(scratch[0]), in.get_id(), in.get_token()};
+        auto outer = in.get_options().begin();
+        auto inner = option_range{scratch + 1, inner_end}.begin();
+        auto done = option_iterator{};
+        while (true) {
+            while (outer != done && (opt_class_e(outer->num) || outer->num == +option_num::oscore))
+                ++outer;
+            if (outer == done && inner == done)
+                break;
+            auto& it = inner == done || (outer != done && outer->num < inner->num) ? outer : inner;
+            b.add(option_num(it->num), {it->dat, it->len});
+            ++it;
+        }
+        if (p != end)
+            b.payload({p + 1, end});
+        return b.ok() ? oscore_error::ok : oscore_error::out_of_memory;
     }
 private:
-    T mask = -2;
-    T high = 0;
-    static constexpr auto bits = sizeof(T) * 8;
-};
-
-/**
- * @brief OSCORE security context.
- * 
- * Algorithms:
- *  1. AEAD: AES-CCM-16-64-128 
- *  2. HKDF: HKDF-SHA-256
- * 
- * Length requirements:
- *  1. Sender ID: [0..7]
- *  2. Recipient ID: [0..7]
- *  3. ID Context: variable-length
- *  4. Master Salt: variable-length
- *  5. Master Secret: variable-length
- */
-struct Security {
-public:
-    bool derive(m_span out, span id, std::string_view type, size_t length) const;
-    bool derive_key(m_span out, span id) const;
-    bool derive_common_iv(m_span common_iv) const;
-    bool derive_sender_key(m_span sender_key) const;
-    bool derive_recipient_key(m_span recipient_key) const;
-    OscoreErr protect_req(const Packet &packet, Packet &oscore);
-    OscoreErr protect_rsp(const Packet &packet, Packet &oscore, bool use_piv, bool use_kid);
-    OscoreErr verify_req(const Packet &oscore, Packet &packet);
-    OscoreErr verify_rsp(const Packet &oscore, Packet &packet);
-private:
-    OscoreErr protect(
-        const Packet &packet, 
-              Packet &oscore, 
-        bool use_piv, 
-        bool use_kid, 
-        bool use_ctx, 
-        span piv, 
-        span kid, 
-        span req_piv, 
-        span req_kid);
-    OscoreErr verify(
-        const Packet &oscore, 
-              Packet &packet,
-        bool use_piv,
-        span piv,
-        span kid,
-        span req_piv,
-        span req_kid);
-    auto construct_key(span id) const;
-    auto construct_nonce(span kid, span piv) const;
-private:
-    static constexpr size_t NONCE_SIZE  = 13;
-    static constexpr size_t KEY_SIZE    = 16;
-    static constexpr size_t TAG_SIZE    = 8;
-    static constexpr size_t PIV_SIZE    = 5;
-    static constexpr size_t KID_SIZE    = NONCE_SIZE - 6;
-public:
-    const span id_context           = {};
-    const span master_salt          = {};
-    const span master_secret        = {};
-    const span sender_id            = {};
-    const span recipient_id         = {};
-    ReplayWindow<> replay_window    = {};
-    uint32_t sequence_number        = 0;
-};
-
-struct OscoreOption {
-
-    OscoreOption() = delete;
-    OscoreOption(const byte* buf, size_t len) : buf{buf}, len{len}
-    {}
-
-    bool get_kid_flag() const           { return buf[0] & 0x08; }
-    bool get_ctx_flag() const           { return buf[0] & 0x10; }
-    auto get_reserved() const           { return buf[0] & 0xe0; }
-    size_t get_piv_len() const          { return buf[0] & 0x07; }
-    size_t get_ctx_len() const          { return buf[1 + get_piv_len()]; }
-    size_t get_kid_len() const          { return buf + len - kid_begin(); }
-    span get_piv() const                 { return {piv_begin(), get_piv_len()}; }
-    span get_ctx() const                 { return {ctx_begin(), get_ctx_len()}; } 
-    span get_kid() const                 { return {kid_begin(), get_kid_len()}; }
-private:
-    const byte* piv_begin() const    { return buf + 1; }
-    const byte* ctx_begin() const    { return piv_begin() + get_piv_len() + get_ctx_flag(); }
-    const byte* kid_begin() const    { return ctx_begin() + get_ctx_len() * get_ctx_flag(); }
-    const byte* buf;
-    size_t len;
+    aes128 sender_ciph;
+    aes128 recipient_ciph;
+    replay_window<> window;
+    uint64_t seqn = 0;
+    ispan ctx;
+    byte sid[max_id];
+    byte rid[max_id];
+    byte sid_len = 0;
+    byte rid_len = 0;
+    byte skey[key_size];
+    byte rkey[key_size];
+    byte civ[nonce_size];
+    byte nonce[nonce_size];
+    cbor::encoder<imp::oscore_cbor_size> aad;
+    byte scratch[imp::oscore_scratch_size];
 };
 
 }
 
 #endif
-
-// #include <algorithm>
-// #include "coap/oscore.h"
-// #include "coap/config.h"
-// #include "coap/log.h"
-// #include "shoc/kdf/hkdf.h"
-// #include "shoc/hash/sha2.h"
-// #include "shoc/mode/ccm.h"
-// #include "shoc/cipher/aes.h"
-// #include "zbor/codec.h"
-// #include "zbor/log.h"
-
-// #define LOG_ENABLED_DBG false
-// #define LOG_ENABLED_WRN true
-// #define LOG_ENABLED_ERR true
-
-// namespace coap {
-// namespace {
-
-// auto construct_piv_buffer(auto seqn)
-// {
-//     std::array<uint8_t, sizeof(seqn)> seqn_buf = {};
-
-//     int seqn_idx = sizeof(seqn);
-//     while (seqn && seqn_idx) {
-//         seqn_buf[--seqn_idx] = seqn;
-//         seqn >>= 8;
-//     }
-//     return std::pair{seqn_buf, seqn_idx};
-// }
-
-// auto construct_piv(auto &buf, size_t idx)
-// {
-//     return idx == sizeof(buf) ?
-//         span{buf.begin(), 1} :
-//         span{buf.begin() + idx, buf.end()};
-// }
-
-// auto construct_aad(span kid, span piv)
-// {
-//     zbor::Codec<imp::oscore_cbor_size> aad;
-
-//     auto aad_array = [&]()
-//     {
-//         aad.encode_arr(5);
-//         aad.encode(COAP_OSCORE_VER);
-//         aad.encode_arr(1);
-//         aad.encode(cose_aes_ccm_16_64_128);
-//         aad.encode(kid);
-//         aad.encode(piv);
-//         aad.encode(span{}); // NOTE: No class I options currently exist, so it's simplified here a lot.
-//     };
-//     aad_array();
-//     size_t aad_array_size = aad.size();
-
-//     aad.clear();
-//     aad.encode_arr(3);
-//     aad.encode("Encrypt0");
-//     aad.encode(span{});
-//     aad.encode_head(zbor::mt_data, aad_array_size);
-//     aad_array();
-
-// #if (LOG_ENABLED_DBG)
-//     logd() << "aad";
-//     log_hex(aad.data(), aad.size());
-// #endif
-//     return aad;
-// }
-
-// template<class T>
-// auto construct_seqn(span buf)
-// {
-//     T val = 0;
-//     for (size_t i = 0; i < buf.size(); ++i) {
-//         val <<= 8;
-//         val |= buf[i];
-//     }
-//     return val;
-// }
-
-// auto copy_options(const Packet &src, Packet &dst)
-// {
-//     for (auto opt : src.options()) {
-//         if (!is_class_e(OptionNum(opt.num)) && !dst.opt_insert(opt)) {
-//             return false;
-//         }
-//     }
-//     return true;
-// }
-
-// }
-
-// auto Security::construct_key(span id) const
-// {
-//     std::array<uint8_t, KEY_SIZE> key;
-//     derive_key(key, id);
-// #if (LOG_ENABLED_DBG)
-//     logd() << "key";
-//     log_hex(key.data(), key.size());
-// #endif
-//     return key;
-// }
-
-// auto Security::construct_nonce(span kid, span piv) const
-// {
-//     std::array<uint8_t, NONCE_SIZE> iv;
-//     std::array<uint8_t, NONCE_SIZE> nonce = { uint8_t(kid.size()) };
-
-//     derive_common_iv(iv);
-
-//     shoc::copy(&nonce[1 + KID_SIZE - kid.size()], kid.data(), kid.size());
-//     shoc::copy(&nonce[NONCE_SIZE - piv.size()], piv.data(), piv.size());
-//     shoc::xorb(nonce.data(), iv.data(), NONCE_SIZE);
-    
-// #if (LOG_ENABLED_DBG)
-//     logd() << "common_iv";
-//     log_hex(iv.data(), iv.size());
-//     logd() << "nonce";
-//     log_hex(nonce.data(), nonce.size());
-// #endif
-//     return nonce;
-// }
-
-// bool Security::derive(m_span out, span id, std::string_view type, size_t length) const
-// {
-//     if (out.size() < length) {
-//         loge(LOG_ENABLED_ERR) << "too small buffer, can't derive";
-//         return false;
-//     }
-//     zbor::Codec<imp::oscore_cbor_size> info;
-
-//     info.encode_arr(5);
-//     info.encode(id);
-//     if (id_context.empty())
-//         info.encode(zbor::prim_null);
-//     else
-//         info.encode(id_context);
-//     info.encode(cose_aes_ccm_16_64_128);
-//     info.encode(type);
-//     info.encode(length);
-
-//     return shoc::hkdf<shoc::Sha2<shoc::SHA_256>>(
-//         out.data(),
-//         length,
-//         master_secret.data(),
-//         master_secret.size(),
-//         master_salt.data(),
-//         master_salt.size(),
-//         info.data(),
-//         info.size()
-//     );
-// }
-
-// bool Security::derive_common_iv(m_span out) const
-// {
-//     return derive(out, {}, "IV", NONCE_SIZE);
-// }
-
-// bool Security::derive_key(m_span out, span id) const
-// {
-//     return derive(out, id, "Key", KEY_SIZE);
-// }
-
-// bool Security::derive_sender_key(m_span out) const
-// {
-//     return derive_key(out, sender_id);
-// }
-
-// bool Security::derive_recipient_key(m_span out) const
-// {
-//     return derive_key(out, recipient_id);
-// }
-
-// OscoreErr Security::protect(
-//     const Packet &packet, 
-//           Packet &oscore, 
-//     bool use_piv,
-//     bool use_kid,
-//     bool use_ctx,
-//     span piv,
-//     span kid,
-//     span req_piv,
-//     span req_kid)
-// {
-//     if (kid.size() > KID_SIZE) {
-//         logw() << "kid.size() is greater than maximum: " << kid.size() << " > " << KID_SIZE;
-//         return oscore_err_illegal_kid_length;
-//     }
-//     if (piv.size() > PIV_SIZE) {
-//         logw() << "piv.size() is greater than maximum: " << piv.size() << " > " << PIV_SIZE;
-//         return oscore_err_illegal_piv_length;
-//     }
-//     if (req_kid.size() > KID_SIZE) {
-//         logw() << "req_kid.size() is greater than maximum: " << req_kid.size() << " > " << KID_SIZE;
-//         return oscore_err_illegal_kid_length;
-//     }
-//     if (req_piv.size() > PIV_SIZE) {
-//         logw() << "req_piv.size() is greater than maximum: " << req_piv.size() << " > " << PIV_SIZE;
-//         return oscore_err_illegal_piv_length;
-//     }
-    
-//     // 1. Mirror header
-//     // 2. Add OSCORE option
-//     // 3. Sort all options: either direct copy or store to plaintext section
-//     // 4. Construct common_iv, sender_key and nonce
-//     // 5. Construct aad_array and AAD
-//     // 6. Encrypt plaintext and add to OSCORE packet
-
-//     oscore.clear();
-//     oscore.init(
-//         packet.get_ver(), 
-//         packet.get_type(),
-//         packet.get_code(), 
-//         packet.get_id(), 
-//         packet.get_token().data(), 
-//         packet.get_tkl());
-
-//     bool observe = packet.opt_is_set(option_num_observe);
-
-//     if (packet.get_code_class() == cc_request)
-//         oscore.set_code(observe ? code_fetch : code_post);
-//     else
-//         oscore.set_code(observe ? code_content : code_changed);
-
-//     //////////////////////////////////
-// #if (COAP_OSCORE_NO_SCRATCH)
-
-//     uint16_t scratch_size = 0;
-
-//     if (use_piv || use_kid || use_ctx) {
-//         scratch_size += 1;
-//     }
-//     if (use_piv) {
-//         scratch_size += piv.size();
-//     }
-//     if (use_ctx) {
-//         scratch_size += 1;
-//         scratch_size += id_context.size();
-//     }
-//     if (use_kid) {
-//         scratch_size += kid.size();
-//     }
-//     auto oscore_opt_write_idx = oscore.size();
-//     auto oscore_opt_size = opt_total_size(option_num_oscore, scratch_size);
-//     if (oscore_opt_write_idx + oscore_opt_size > oscore.capacity()) {
-//         loge(LOG_ENABLED_ERR) << "too huge option for OSCORE packet";
-//         return oscore_err_out_of_memory;
-//     }
-//     opt_encode_head(oscore.end(), option_num_oscore, scratch_size);
-//     oscore_opt_write_idx += opt_head_size(option_num_oscore, scratch_size);
-
-//     if (use_piv || use_kid || use_ctx) {
-//         oscore[oscore_opt_write_idx] = (piv.size() * use_piv) | (use_kid << 3) | (use_ctx << 4);
-//         oscore_opt_write_idx++;
-//     }
-//     if (use_piv) {
-//         memcpy(&oscore[oscore_opt_write_idx], piv.data(), piv.size());
-//         oscore_opt_write_idx += piv.size();
-//     }
-//     if (use_ctx) {
-//         oscore[oscore_opt_write_idx] = id_context.size();
-//         oscore_opt_write_idx += 1;
-//         memcpy(&oscore[oscore_opt_write_idx], id_context.data(), id_context.size());
-//         oscore_opt_write_idx += id_context.size();
-//     }
-//     if (use_kid) {
-//         memcpy(&oscore[oscore_opt_write_idx], kid.data(), kid.size());
-//         oscore_opt_write_idx += kid.size();
-//     }
-//     oscore.resize(oscore_opt_write_idx);
-//     oscore.parse();
-// #else
-//     uint8_t scratch[imp::oscore_scratch_size];
-//     uint16_t scratch_size = 0;
-
-//     if (use_piv || use_kid || use_ctx) {
-//         scratch_size += 1;
-//     }
-//     if (use_piv) {
-//         scratch_size += piv.size();
-//     }
-//     if (use_ctx) {
-//         scratch_size += 1;
-//         scratch_size += id_context.size();
-//     }
-//     if (use_kid) {
-//         scratch_size += kid.size();
-//     }
-
-//     if (scratch_size > sizeof(scratch)) {
-//         loge(LOG_ENABLED_ERR) << "not enough memory in scratch section";
-//         return oscore_err_out_of_memory;
-//     }
-//     scratch_size = 0;
-
-//     if (use_piv || use_kid || use_ctx) {
-//         scratch[0] = (piv.size() * use_piv) | (use_kid << 3) | (use_ctx << 4);
-//         scratch_size += 1;
-//     }
-//     if (use_piv) {
-//         memcpy(scratch + scratch_size, piv.data(), piv.size());
-//         scratch_size += piv.size();
-//     }
-//     if (use_ctx) {
-//         scratch[scratch_size] = id_context.size();
-//         scratch_size += 1;
-//         memcpy(scratch + scratch_size, id_context.data(), id_context.size());
-//         scratch_size += id_context.size();
-//     }
-//     if (use_kid) {
-//         memcpy(scratch + scratch_size, kid.data(), kid.size());
-//         scratch_size += kid.size();
-//     }
-//     oscore.opt_insert({
-//         .dat = scratch,
-//         .len = scratch_size,
-//         .num = option_num_oscore,
-//     });
-// #if (LOG_ENABLED_DBG)
-//     logd() << "option";
-//     log_hex(scratch, scratch_size);
-// #endif
-// #endif
-//     //////////////////////////////////
-
-// #if (COAP_OSCORE_NO_SCRATCH)
-//     if (!copy_options(packet, oscore)) {
-//         loge(LOG_ENABLED_ERR) << "failed to add non-E option to OSCORE packet";
-//         return oscore_err_out_of_memory;
-//     }
-//     auto payload = oscore.end() + 1;
-//     auto payload_size = oscore.size() + 1;
-//     auto write_idx = oscore.size();
-
-//     if (write_idx + 2 > oscore.capacity()) { // 0xff + CODE
-//         loge(LOG_ENABLED_ERR) << "not enough memory for OSCORE payload";
-//         return oscore_err_out_of_memory;
-//     }
-//     oscore[write_idx++] = 0xff;
-//     oscore[write_idx++] = packet.get_code();
-
-//     uint16_t prev_num = 0;
-
-//     for (auto opt : packet.options()) {
-
-//         if (is_class_e(OptionNum(opt.num))) {
-
-//             uint16_t delta = opt.num - prev_num;
-//             uint16_t opt_size = opt_total_size(delta, opt.len);
-
-//             if (write_idx + opt_size> oscore.capacity()) {
-//                 loge(LOG_ENABLED_ERR) << "too huge option for OSCORE packet";
-//                 return oscore_err_out_of_memory;
-//             }
-//             opt_encode(&oscore[write_idx], delta, opt.len, opt.dat);
-//             write_idx += opt_size;
-//             delta = 0;
-//             prev_num = opt.num;
-//         }
-//     }
-//     auto payload_plain = packet.get_payload();
-//     if (!payload_plain.empty()) {
-//         if (write_idx + payload_plain.size() + 1 > oscore.capacity()) {
-//             loge(LOG_ENABLED_ERR) << "too huge payload for OSCORE packet";
-//             return oscore_err_out_of_memory;
-//         }
-//         oscore[write_idx++] = 0xff;
-//         memcpy(&oscore[write_idx], payload_plain.data(), payload_plain.size());
-//         write_idx += payload_plain.size();
-//     }
-
-//     if (write_idx + TAG_SIZE >= oscore.capacity()) {
-//         loge(LOG_ENABLED_ERR) << "too huge payload for OSCORE packet, can't include tag";
-//         return oscore_err_out_of_memory;
-//     }
-//     payload_size = write_idx - payload_size;
-// #else
-//     scratch[0] = packet.get_code();
-//     scratch_size = 1;
-
-//     uint16_t prev_num = 0;
-
-//     for (auto opt : packet.options()) {
-
-//         uint16_t delta = opt.num - prev_num;
-
-//         if (is_class_e(opt.num)) {
-//             if (scratch_size + opt_total_size(delta, opt.len) > sizeof(scratch)) {
-//                 loge(LOG_ENABLED_ERR) << "too huge option for scratch section";
-//                 return oscore_err_out_of_memory;
-//             }
-//             opt_encode(&scratch[scratch_size], delta, opt.len, opt.dat);
-//             scratch_size += opt_total_size(delta, opt.len);
-//             delta = 0;
-//             prev_num = opt.num;
-//         } else {
-//             if (!oscore.opt_insert(opt)) {
-//                 loge(LOG_ENABLED_ERR) << "failed to add non-E option to OSCORE packet";
-//                 return oscore_err_out_of_memory;
-//             }
-//         }
-//     }
-
-//     auto payload = packet.get_payload();
-//     if (!payload.empty()) {
-//         if (scratch_size + payload.size() + 1 > sizeof(scratch)) {
-//             loge(LOG_ENABLED_ERR) << "too huge payload for scratch section";
-//             return oscore_err_out_of_memory;
-//         }
-//         scratch[scratch_size++] = 0xff;
-//         memcpy(scratch + scratch_size, payload.data(), payload.size());
-//         scratch_size += payload.size();
-//     }
-
-//     if (scratch_size + TAG_SIZE >= sizeof(scratch)) {
-//         loge(LOG_ENABLED_ERR) << "too huge payload, can't include tag";
-//         return oscore_err_out_of_memory;
-//     }
-// #if (LOG_ENABLED_DBG)
-//     logd() << "plaintext";
-//     log_hex(scratch, scratch_size);
-// #endif
-// #endif
-//     //////////////////////////////////
-
-//     auto nonce = use_piv ? 
-//         construct_nonce(kid, piv) :
-//         construct_nonce(req_kid, req_piv);
-//     auto aad = construct_aad(req_kid, req_piv);
-//     auto key = construct_key(sender_id);
-    
-//     //////////////////////////////////
-
-// #if (COAP_OSCORE_NO_SCRATCH)
-//     if (!shoc::ccm_encrypt<shoc::Aes>(
-//         key.data(),
-//         nonce.data(),
-//         aad.data(), aad.size(),
-//         payload + payload_size, TAG_SIZE,
-//         payload,
-//         payload, payload_size))
-//     {
-//         loge(LOG_ENABLED_ERR) << "CCM encryption failed";
-//         return oscore_err_crypto_fail;
-//     };
-//     write_idx += TAG_SIZE;
-    
-//     oscore.resize(write_idx);
-//     oscore.parse();
-// #else
-//     if (!shoc::ccm_encrypt<shoc::Aes128>(
-//         key.data(),
-//         nonce.data(),
-//         aad.data(), aad.size(),
-//         scratch + scratch_size, TAG_SIZE,
-//         scratch,
-//         scratch, scratch_size))
-//     {
-//         loge(LOG_ENABLED_ERR) << "CCM encryption failed";
-//         return oscore_err_crypto_fail;
-//     };
-//     scratch_size += TAG_SIZE;
-//     oscore.set_payload(scratch, scratch_size);
-// #endif
-
-// #if (LOG_ENABLED_DBG)
-//     logd() << "ciphertext";
-//     log_hex(scratch, scratch_size);
-// #endif
-
-//     if (use_piv)
-//         ++sequence_number;
-
-//     return oscore_err_ok;
-// }
-
-// OscoreErr Security::protect_req(const Packet &packet, Packet &oscore)
-// {
-//     auto [piv_buf, piv_len] = construct_piv_buffer(sequence_number);
-//     auto piv = construct_piv(piv_buf, piv_len);
-
-//     return protect(packet, oscore, true, true, !id_context.empty(), piv, sender_id, piv, sender_id);
-// }
-
-// OscoreErr Security::protect_rsp(const Packet &packet, Packet &oscore, bool use_piv, bool use_kid)
-// {
-//     auto [piv_buf, piv_len] = construct_piv_buffer(sequence_number);
-//     auto piv = construct_piv(piv_buf, piv_len);
-
-//     auto [req_piv_buf, req_piv_len] = construct_piv_buffer(replay_window.latest());
-//     auto req_piv = construct_piv(req_piv_buf, req_piv_len);
-
-//     return protect(packet, oscore, use_piv, use_kid, false, piv, sender_id, req_piv, recipient_id);
-// }
-
-// OscoreErr Security::verify(
-//     const Packet &oscore, 
-//           Packet &packet, 
-//     bool use_piv,
-//     span piv,
-//     span kid,
-//     span req_piv,
-//     span req_kid)
-// {
-//     if (kid.size() > KID_SIZE) {
-//         logw() << "kid.size() is greater than maximum: " << kid.size() << " > " << KID_SIZE;
-//         return oscore_err_illegal_kid_length;
-//     }
-//     if (piv.size() > PIV_SIZE) {
-//         logw() << "piv.size() is greater than maximum: " << piv.size() << " > " << PIV_SIZE;
-//         return oscore_err_illegal_piv_length;
-//     }
-//     if (req_kid.size() > KID_SIZE) {
-//         logw() << "req_kid.size() is greater than maximum: " << req_kid.size() << " > " << KID_SIZE;
-//         return oscore_err_illegal_kid_length;
-//     }
-//     if (req_piv.size() > PIV_SIZE) {
-//         logw() << "req_piv.size() is greater than maximum: " << req_piv.size() << " > " << PIV_SIZE;
-//         return oscore_err_illegal_piv_length;
-//     }
-
-//     //////////////////////////////////
-
-//     auto nonce = use_piv ? 
-//         construct_nonce(kid, piv) :
-//         construct_nonce(req_kid, req_piv);
-//     auto aad = construct_aad(req_kid, req_piv);
-//     auto key = construct_key(recipient_id);
-    
-//     //////////////////////////////////
-
-//     packet.clear();
-//     packet.init(
-//         oscore.get_ver(), 
-//         oscore.get_type(),
-//         oscore.get_code(), 
-//         oscore.get_id(), 
-//         oscore.get_token().data(), 
-//         oscore.get_tkl());
-
-//     if (!copy_options(oscore, packet)) {
-//         loge(LOG_ENABLED_ERR) << "failed to retrieve non-E options from OSCORE packet";
-//         return oscore_err_out_of_memory;
-//     }
-
-//     //////////////////////////////////
-
-//     uint8_t scratch[imp::oscore_scratch_size];
-
-//     auto payload = oscore.get_payload();
-
-//     if (payload.size() < TAG_SIZE) {
-//         loge(LOG_ENABLED_ERR) << "payload size is smaller than minimum tag size: " << payload.size() << " < " << TAG_SIZE;
-//         return oscore_err_illegal_tag_length;
-//     }
-//     auto payload_size = payload.size() - TAG_SIZE;
-
-//     if (payload_size > sizeof(scratch)) {
-//         loge(LOG_ENABLED_ERR) << "not enough scratch memory to decrypt payload: " << payload_size << " > " << sizeof(scratch);
-//         return oscore_err_out_of_memory;
-//     }
-
-//     if (!shoc::ccm_decrypt<shoc::Aes128>(
-//         key.data(),
-//         nonce.data(),
-//         aad.data(), aad.size(),
-//         payload.data() + payload_size, TAG_SIZE,
-//         payload.data(),
-//         scratch, payload_size))
-//     {
-//         loge(LOG_ENABLED_ERR) << "CCM decryption failed";
-//         return oscore_err_crypto_fail;
-//     };
-
-//     //////////////////////////////////
-
-//     packet.opt_delete(option_num_oscore);
-//     packet.set_code(Code(scratch[0]));
-
-//     for (auto opt : OptRange<OptIter>(scratch + 1, scratch + payload_size)) {
-//         packet.opt_insert(opt);
-//     }
-//     return oscore_err_ok;
-// }
-
-// OscoreErr Security::verify_req(const Packet &oscore, Packet &packet)
-// {
-//     auto opt = oscore.opt_get(option_num_oscore);
-//     auto piv = OscoreOption{opt.dat, opt.len}.get_piv();
-
-//     auto seqn = construct_seqn<uint32_t>(piv);
-
-//     if (!replay_window.check(seqn)) {
-//         loge(LOG_ENABLED_ERR) << "sequence number replay: " << seqn;
-//         return oscore_err_replay;
-//     }
-//     auto ret = verify(oscore, packet, false, piv, recipient_id, piv, recipient_id);
-
-//     if (ret == oscore_err_ok)
-//         replay_window.update(seqn);
-
-//     return ret;
-// }
-
-// OscoreErr Security::verify_rsp(const Packet &oscore, Packet &packet)
-// {
-//     auto opt = oscore.opt_get(option_num_oscore);
-//     auto piv = OscoreOption{opt.dat, opt.len}.get_piv();
-
-//     auto [req_piv_buf, req_piv_len] = construct_piv_buffer(sequence_number - 1);
-//     auto req_piv = construct_piv(req_piv_buf, req_piv_len);
-
-//     return verify(oscore, packet, !piv.empty(), piv, recipient_id, req_piv, sender_id);
-// }
-    
-// }
\ No newline at end of file
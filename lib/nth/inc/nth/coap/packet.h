@@ -7,6 +7,8 @@
 
 namespace nth::coap {
 
+struct packet_builder;
+
 struct packet_view {
 
     // ANCHOR Member types
@@ -24,7 +26,7 @@ struct packet_view {
 
     // ANCHOR Constructors
 
-    constexpr packet_view() = delete;
+    constexpr packet_view() = default;
     constexpr packet_view(ospan buf) : buf{buf} 
     { 
         assert(buf.size() >= min_hdl);
@@ -70,6 +72,7 @@ struct packet_view {
     constexpr void clear();
     constexpr error parse();
     constexpr error parse(ispan raw);
+    static constexpr error validate(ispan raw);
 
     constexpr byte get_ver() const                      { return (buf[0] & 0xc0) >> 6; }
     constexpr byte get_type() const                     { return (buf[0] & 0x30) >> 4; }
@@ -89,6 +92,7 @@ struct packet_view {
     constexpr void set_id(word id) const        { buf[2] = id >> 8; buf[3] = id; }
     constexpr bool set_token(ispan tok);
     constexpr bool set_payload(ispan pld);
+    constexpr ospan alloc_payload(size_t n);
 
     constexpr option opt_next(option opt) const;
     constexpr option opt_get(option_num num) const;
@@ -102,7 +106,11 @@ private:
     constexpr const_pointer tok_cbegin() const      { return begin() + min_hdl; }
     constexpr const_pointer opt_cbegin() const      { return begin() + min_hdl + get_tkl(); }
     constexpr const_pointer opt_cend() const        { return end() - pld_offset; }
-    constexpr error parse_option(const_pointer& p, word& delta);
+    constexpr void parse_option(word num, word prev, const_pointer at);
+    static constexpr error scan_header(ispan raw);
+    template<class Fn>
+    static constexpr error scan_options(const_pointer p, const_pointer end, const_pointer& pld, Fn&& fn);
+    friend packet_builder;
 protected:
     static constexpr size_t min_hdl = 4;        // Minimum header length
     static constexpr size_t max_tkl = 8;        // Maximum token length
@@ -259,34 +267,18 @@ constexpr void packet_view::clear()
  */
 constexpr error packet_view::parse()
 {
-    using enum error;
-
     flush();
-    
-    if (size() < min_hdl)
-        return too_short_header;
-
-    if (get_ver() != imp::version)
-        return invalid_version;
-    
-    if (get_tkl() > max_tkl)
-        return invalid_token_length;
-
-    if (get_tkl() > size() - min_hdl)
-        return too_short_token;
 
-    auto p = opt_cbegin();
-    word delta = 0;
+    if (error e = scan_header(*this); e != error::ok)
+        return e;
 
-    while (p < end() && *p != pld_mark) {
-        if (error e = parse_option(p, delta); e != ok)
-            return e;
-    }
-    if (p == end() || ++p < end()) {
-        pld_offset = word(end() - p);
-        return ok;
-    }
-    return too_short_payload;
+    const_pointer pld;
+    error e = scan_options(opt_cbegin(), end(), pld, [this] (word num, word prev, const_pointer at) {
+        parse_option(num, prev, at);
+    });
+    if (e == error::ok)
+        pld_offset = word(end() - pld);
+    return e;
 }
 
 /**
@@ -303,7 +295,96 @@ constexpr error packet_view::parse(ispan raw)
 }
 
 /**
- * @brief Parse next option from given start position and delta. If 
+ * @brief Check raw message validity without copying and caching 
+ * anything, same checks as `parse()` does. Cheap way to reject 
+ * malformed datagrams before they take a packet buffer.
+ * 
+ * @param raw Raw message
+ * @return Error status
+ */
+constexpr error packet_view::validate(ispan raw)
+{
+    if (error e = scan_header(raw); e != error::ok)
+        return e;
+    const_pointer pld;
+    return scan_options(raw.data() + min_hdl + (raw[0] & 0x0f), raw.data() + raw.size(), pld, [] (word, word, const_pointer) {});
+}
+
+/**
+ * @brief Check fixed header and token length.
+ * 
+ * @param raw Raw message
+ * @return Error status
+ */
+constexpr error packet_view::scan_header(ispan raw)
+{
+    if (raw.size() < min_hdl)
+        return error::too_short_header;
+    auto tkl = size_t(raw[0] & 0x0f);
+    if ((raw[0] >> 6) != imp::version)
+        return error::invalid_version;
+    if (tkl > max_tkl)
+        return error::invalid_token_length;
+    if (tkl > raw.size() - min_hdl)
+        return error::too_short_token;
+    return error::ok;
+}
+
+/**
+ * @brief Single pass over options up to payload marker. Extended delta 
+ * and length fields are decoded through lookup of their size by nibble 
+ * instead of nested branches, and all bounds are checked once per option.
+ * Reserved nibble 15 (outside of payload marker), missing extended bytes 
+ * and option number overflow give `error::invalid_option`, value past 
+ * the end `error::too_short_option` and marker without payload 
+ * `error::too_short_payload`.
+ * 
+ * @param p Start of options
+ * @param end End of message
+ * @param pld Start of payload, set on success
+ * @param fn Called with number, previous number and start of every option
+ * @return Error status
+ */
+template<class Fn>
+constexpr error packet_view::scan_options(const_pointer p, const_pointer end, const_pointer& pld, Fn&& fn)
+{
+    constexpr byte ext_size[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4};
+    auto ext_value = [] (const_pointer p, byte size) -> uint32_t {
+        return size == 0 ? 0 : size == 1 ? p[0] : ((p[0] << 8) | p[1]) + 255;
+    };
+    uint32_t num = 0;
+
+    while (p < end) {
+        auto head = *p;
+        if (head == pld_mark) {
+            if (++p == end)
+                return error::too_short_payload;
+            pld = p;
+            return error::ok;
+        }
+        auto at = p++;
+        byte dx = ext_size[head >> 4];
+        byte lx = ext_size[head & 0x0f];
+        if ((dx | lx) & 4 || end - p < dx + lx)
+            return error::invalid_option;
+        auto delta = (head >> 4) + ext_value(p, dx);
+        p += dx;
+        auto len = (head & 0x0f) + ext_value(p, lx);
+        p += lx;
+        if (num + delta > 0xffff)
+            return error::invalid_option;
+        if (size_t(end - p) < len)
+            return error::too_short_option;
+        fn(word(num + delta), word(num), at);
+        num += delta;
+        p += len;
+    }
+    pld = end;
+    return error::ok;
+}
+
+/**
+ * @brief Remember option found by `scan_options()` in cache. If 
  * `NTH_COAP_OPTION_CACHE == true`, necessary info will be cached 
  * inside packet for fast access later with `opt_` functions. For any 
  * option, which is unknown to the implementation, only offset of the 
@@ -314,36 +395,23 @@ constexpr error packet_view::parse(ispan raw)
  * which indicates presence of unknown option. Quering `option_num::unknown` 
  * with `opt_get()` will just return invalid option in this case.
  * 
- * @param p Pointer to last parsed byte, for first call must be start of options
- * @param delta Previous option delta, for first call must be 0
- * @return Status 
+ * @param num Option number
+ * @param prev Previous option number, 0 for the first option
+ * @param at Start of option
  */
-constexpr error packet_view::parse_option(const_pointer& p, word& delta)
+constexpr void packet_view::parse_option(word num, word prev, const_pointer at)
 {
-    auto opt = opt_decode(p, end(), delta);
-
-    if (opt_valid(opt) == false)
-        return error::invalid_option;
-    
-    if (opt_edge(opt) > end())
-        return error::too_short_option;
-
 #if (NTH_COAP_OPTION_CACHE)
-    if (opt.num != delta) {
-        auto idx = +opt_num_to_bit(opt.num);
+    if (num != prev) {
+        auto idx = +opt_num_to_bit(num);
         set_arr_bit(opt_mask.data(), idx);
-        opt_offset[idx] = p - opt_begin();
-        opt_deltas[idx] = delta;
-        delta = opt.num;
+        opt_offset[idx] = word(at - opt_begin());
+        opt_deltas[idx] = prev;
     }
 #else
-    if (opt_num_to_bit(opt.num) == option_bit::unknown)
+    if (opt_num_to_bit(num) == option_bit::unknown)
         opt_unknown_present = true;
-    delta = opt.num;
 #endif
-    p = opt_edge(opt);
-
-    return error::ok;
 }
 
 /**
@@ -386,20 +454,36 @@ constexpr bool packet_view::set_token(ispan tok)
  * @param pld Payload
  */
 constexpr bool packet_view::set_payload(ispan pld)
+{
+    auto dst = alloc_payload(pld.size());
+    if (dst.data() == nullptr)
+        return false;
+    std::ranges::copy(pld, dst.begin());
+    return true;
+}
+
+/**
+ * @brief Replace old payload with uninitialized one of given size
+ * or delete if size is zero, so payload can be produced in place 
+ * right in the packet buffer. Calling it again with smaller size 
+ * truncates payload, keeping its beginning.
+ * 
+ * @param n Payload size
+ * @return Writable payload or span with nullptr if it doesn't fit
+ */
+constexpr ospan packet_view::alloc_payload(size_t n)
 {
     auto old_len = std::max(size(), size_type(4)) - (pld_offset + bool(pld_offset));
 
-    if (resize(old_len + pld.size() + !pld.empty()) == false)
-        return false;
+    if (resize(old_len + n + bool(n)) == false)
+        return {};
 
-    if (!pld.empty()) {
-        auto pld_dst = begin() + old_len;
+    auto pld_dst = begin() + old_len;
+    if (n)
         *pld_dst++ = pld_mark;
-        std::ranges::copy(pld, pld_dst);
-    }
-    pld_offset = word(pld.size());
+    pld_offset = word(n);
 
-    return true;
+    return {pld_dst, n};
 }
 
 /**
@@ -593,6 +677,20 @@ constexpr bool packet_view::opt_insert(option opt)
     return true;
 }
 
+/**
+ * @brief Insert option with unsigned integer value, e.g. Block2 or Observe.
+ *
+ * @param pkt Packet
+ * @param num Option number
+ * @param val Value
+ * @return True on success
+ */
+constexpr bool opt_insert_uint(packet_view& pkt, option_num num, uint32_t val)
+{
+    byte buf[4];
+    return pkt.opt_insert({buf, opt_uint_encode(val, buf), +num});
+}
+
 }
 
 #endif
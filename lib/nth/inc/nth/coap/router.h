@@ -0,0 +1,229 @@
+#ifndef NTH_COAP_ROUTER_H
+#define NTH_COAP_ROUTER_H
+
+#include "nth/coap/server.h"
+#include "nth/container/flat_map.h"
+#include <array>
+#include <string_view>
+
+namespace nth::coap {
+
+using method_handler = void(*)(server&);
+
+/**
+ * @brief Compile-time route declaration: full Uri-Path with segments
+ * separated by '/' (leading and repeated separators are ignored, so ""
+ * and "/" are the root) and handlers for each method.
+ *
+ */
+struct route {
+    std::string_view path;
+    method_handler get  = nullptr;
+    method_handler post = nullptr;
+    method_handler put  = nullptr;
+    method_handler del  = nullptr;
+};
+
+namespace imp {
+
+/**
+ * @brief Call function for every non-empty segment of a path.
+ *
+ */
+template<class Fn>
+constexpr void route_segments(std::string_view path, Fn&& fn)
+{
+    while (!path.empty()) {
+        auto n = path.find('/');
+        auto seg = path.substr(0, n);
+        if (!seg.empty())
+            fn(seg);
+        if (n == path.npos)
+            break;
+        path.remove_prefix(n + 1);
+    }
+}
+
+/**
+ * @brief Upper bound of trie nodes for given routes: root plus every segment.
+ *
+ */
+constexpr size_t route_nodes(std::span<const route> routes)
+{
+    size_t n = 1;
+    for (const auto& it : routes)
+        route_segments(it.path, [&n] (std::string_view) { ++n; });
+    return n;
+}
+
+}
+
+/**
+ * @brief Uri-Path dispatch table built at compile time from array of
+ * routes. Path segments form a trie, but instead of per-node child lists
+ * every edge (parent node, segment) is stored in a single open addressing
+ * table at most half full, so each segment of request costs one hash and
+ * usually one string comparison no matter how many resources there are.
+ * Method handlers live in trie nodes, indexed directly by request code.
+ * Nodes of intermediate segments, which aren't routes themselves, are
+ * marked undeclared and not found as resources.
+ * Use nth::coap::make_router to size it automatically.
+ *
+ * @tparam Nodes Maximum number of trie nodes
+ */
+template<size_t Nodes>
+struct router {
+
+    static constexpr size_t npos = size_t(-1);
+
+    constexpr router(std::span<const route> routes)
+    {
+        for (const auto& it : routes) {
+            size_t node = 0;
+            imp::route_segments(it.path, [&] (std::string_view seg) {
+                auto next = child(node, seg);
+                if (next == npos) {
+                    assert(len < Nodes);
+                    next = len++;
+                    insert(node, seg, next);
+                }
+                node = next;
+            });
+            nodes[node] = {{it.get, it.post, it.put, it.del}, true};
+        }
+    }
+
+    constexpr size_t size() const           { return len; }
+    static constexpr size_t capacity()      { return Nodes; }
+
+    /**
+     * @brief Find resource node by Uri-Path options of parsed request.
+     *
+     * @param pkt Parsed packet
+     * @return Node index or npos if there's no such resource
+     */
+    constexpr size_t locate(const packet_view& pkt) const
+    {
+        size_t node = 0;
+        for (auto opt : pkt.get_options(option_num::uri_path)) {
+            node = child(node, {reinterpret_cast<const char*>(opt.dat), opt.len});
+            if (node == npos)
+                return npos;
+        }
+        return nodes[node].declared ? node : npos;
+    }
+
+    /**
+     * @brief Find resource node by path string.
+     *
+     * @param path Path with segments separated by '/'
+     * @return Node index or npos if there's no such resource
+     */
+    constexpr size_t locate(std::string_view path) const
+    {
+        size_t node = 0;
+        imp::route_segments(path, [&] (std::string_view seg) {
+            if (node != npos)
+                node = child(node, seg);
+        });
+        return node != npos && nodes[node].declared ? node : npos;
+    }
+
+    /**
+     * @brief Get handler of node for request code.
+     *
+     * @param node Node index from 'locate'
+     * @param code Request code
+     * @return Handler or nullptr if method isn't allowed
+     */
+    constexpr method_handler handler(size_t node, byte code) const
+    {
+        assert(node < len);
+        if (code < +msg_code::get || code > +msg_code::delete_)
+            return nullptr;
+        return nodes[node].fn[code - +msg_code::get];
+    }
+
+    /**
+     * @brief Route request held by session to its handler or respond with
+     * 4.04 Not Found or 4.05 Method Not Allowed.
+     *
+     * @param s Session with parsed request
+     * @return True if handler was called
+     */
+    constexpr bool dispatch(server& s) const
+    {
+        auto& pkt = s.get_packet();
+        auto node = locate(pkt);
+        if (node == npos) {
+            s.respond({}, msg_code::not_found);
+            return false;
+        }
+        auto fn = handler(node, pkt.get_code());
+        if (!fn) {
+            s.respond({}, msg_code::method_not_allowed);
+            return false;
+        }
+        fn(s);
+        return true;
+    }
+private:
+    struct entry {
+        std::array<method_handler, 4> fn = {};
+        bool declared = false;
+    };
+    struct edge {
+        std::string_view seg;
+        uint32_t parent = 0; // parent node + 1, 0 if edge is empty
+        uint32_t child = 0;
+    };
+    static constexpr size_t hash(size_t parent, std::string_view seg)
+    {
+        uint64_t h = 0xcbf29ce484222325 ^ parent;
+        for (auto c : seg) {
+            h ^= uint8_t(c);
+            h *= 0x100000001b3;
+        }
+        return flat_hash::mix(h);
+    }
+    constexpr size_t child(size_t parent, std::string_view seg) const
+    {
+        for (auto i = hash(parent, seg) & M; edges[i].parent; i = (i + 1) & M) {
+            if (edges[i].parent == parent + 1 && edges[i].seg == seg)
+                return edges[i].child;
+        }
+        return npos;
+    }
+    constexpr void insert(size_t parent, std::string_view seg, size_t node)
+    {
+        auto i = hash(parent, seg) & M;
+        while (edges[i].parent)
+            i = (i + 1) & M;
+        edges[i] = {seg, uint32_t(parent + 1), uint32_t(node)};
+    }
+private:
+    static constexpr size_t E = std::bit_ceil(2 * Nodes);
+    static constexpr size_t M = E - 1;
+
+    entry nodes[Nodes] = {};
+    edge edges[E] = {};
+    size_t len = 1;
+};
+
+/**
+ * @brief Build router for array of routes with static storage duration,
+ * sized exactly for it.
+ *
+ * @tparam Routes Array of nth::coap::route
+ * @return Router
+ */
+template<const auto& Routes>
+constexpr auto make_router()
+{
+    constexpr auto n = imp::route_nodes(Routes);
+    return router<n>{Routes};
+}
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define NTH_COAP_SERVER_H
 
 #include "nth/coap/session.h"
+#include "nth/coap/block.h"
 // #include "nth/coap/resource.h"
 
 namespace nth::coap {
@@ -15,15 +16,20 @@ namespace nth::coap {
  * 
  */
 struct server : public session<server> {
+    constexpr void init(packet_view storage);
     constexpr bool idle() const;
+    constexpr bool serving() const;
     constexpr void advance();
-    constexpr void separate(ispan payload);
-    constexpr void piggybacked(ispan payload);
+    constexpr void separate(ispan payload, msg_code code = msg_code::content);
+    constexpr void piggybacked(ispan payload, msg_code code = msg_code::content);
     constexpr void emptyack();
-    // void respond(msg_code code, ispan payload);
-    // void respond(msg_code code);
-    // void respond();
+    constexpr void respond(ispan payload, msg_code code = msg_code::content);
+    constexpr void respond(ispan payload, msg_code code, std::span<const option> opts);
+    constexpr void respond_block(const payload_source& src, msg_code code = msg_code::content, byte szx = imp::max_block_szx);
+    constexpr block_status receive_block(const payload_sink& sink);
 private:
+    constexpr void backup();
+    constexpr void compose(bool piggyback, msg_code code);
     constexpr void handle_rrevt(rr_event ev);
     constexpr void process(rr_server_event ev);
     constexpr void process_idle(rr_server_event ev);
@@ -34,6 +40,10 @@ private:
     word bckp_id;
     byte bckp_tok[8];
     byte bckp_tkl;
+    bool bckp_blk2_set = false;
+    block_opt bckp_blk2;
+    bool echo_blk1 = false;
+    block_opt blk1;
     bool confirmable;
 
     using dispatch_fn = void (server::*)(rr_server_event);
@@ -48,25 +58,37 @@ private:
 
 // ANCHOR Definitions
 
+/**
+ * @brief Reset message and request/response layers, so session can be
+ * reused for new request even if the previous one was left without
+ * response.
+ * 
+ * @param storage Packet buffer
+ */
+constexpr void server::init(packet_view storage)
+{
+    session::init(storage);
+    state = rr_server_state::idle;
+}
+
 constexpr void server::advance()
 {
     session::advance();
 }
 
-constexpr void server::separate(ispan payload)
+constexpr void server::separate(ispan payload, msg_code code)
 {
 #if (ENABLE_PACKET)
-    pkt.setup(msg_type::ack, msg_code::content, 0, {bckp_tok, bckp_tkl});
+    compose(false, code);
     pkt.set_payload(payload);
 #endif
     process(rr_server_event::separate); 
 }
 
-constexpr void server::piggybacked(ispan payload)
+constexpr void server::piggybacked(ispan payload, msg_code code)
 {
 #if (ENABLE_PACKET)
-    pkt.clear_body();
-    pkt.set_code(msg_code::content);
+    compose(true, code);
     pkt.set_payload(payload);
 #endif
     process(rr_server_event::piggybacked);   
@@ -75,13 +97,169 @@ constexpr void server::piggybacked(ispan payload)
 constexpr void server::emptyack()
 {
 #if (ENABLE_PACKET)
-    bckp_tkl = pkt.get_tkl();
-    std::copy_n(pkt.get_token().data(), bckp_tkl, bckp_tok);
+    backup();
     pkt.setup(msg_type::ack, msg_code::empty, pkt.get_id(), {});
 #endif
     process(rr_server_event::emptyack);
 }
 
+constexpr void server::backup()
+{
+#if (ENABLE_PACKET)
+    bckp_id = pkt.get_id();
+    bckp_tkl = pkt.get_tkl();
+    std::copy_n(pkt.get_token().data(), bckp_tkl, bckp_tok);
+    bckp_blk2_set = block_get(pkt, option_num::block2, bckp_blk2);
+#endif
+}
+
+/**
+ * @brief Build response header (and Block1 echo, if request was a 
+ * block of body) in place of request, leaving payload to caller.
+ * 
+ * @param piggyback True if response goes in ACK for request
+ * @param code Response code
+ */
+constexpr void server::compose(bool piggyback, msg_code code)
+{
+#if (ENABLE_PACKET)
+    if (piggyback) {
+        pkt.clear_body();
+        pkt.set_code(code);
+    } else {
+        pkt.setup(msg_type::ack, code, 0, {bckp_tok, bckp_tkl});
+    }
+    if (echo_blk1)
+        opt_insert_uint(pkt, option_num::block1, blk1.value());
+#endif
+}
+
+/**
+ * @brief Respond to current request in the only way allowed by state:
+ * piggybacked in ACK if request was CON and it wasn't acknowledged yet,
+ * separate otherwise.
+ * 
+ * @param payload Payload
+ * @param code Response code
+ */
+constexpr void server::respond(ispan payload, msg_code code)
+{
+    if (serving())
+        piggybacked(payload, code);
+    else
+        separate(payload, code);
+}
+
+/**
+ * @brief Respond like above, with extra options, e.g. Observe for 
+ * response to registration or Content-Format.
+ * 
+ * @param payload Payload
+ * @param code Response code
+ * @param opts Options
+ */
+constexpr void server::respond(ispan payload, msg_code code, std::span<const option> opts)
+{
+    bool piggyback = serving();
+#if (ENABLE_PACKET)
+    compose(piggyback, code);
+    for (auto& it : opts)
+        pkt.opt_insert(it);
+    pkt.set_payload(payload);
+#endif
+    process(piggyback ? rr_server_event::piggybacked : rr_server_event::separate);
+}
+
+/**
+ * @brief Respond with block of body requested by Block2 option of
+ * request (RFC 7959, 2.4), reading it from source right into packet.
+ * Without Block2 in request first block is sent, or whole body without
+ * Block2 if it fits. Block size is the smallest of requested, preferred
+ * and the one fitting into packet buffer. Block past the end of body
+ * or invalid Block2 get 4.02 Bad Option instead.
+ * 
+ * @param src Body source
+ * @param code Response code
+ * @param szx Preferred block size exponent
+ */
+constexpr void server::respond_block(const payload_source& src, msg_code code, byte szx)
+{
+#if (ENABLE_PACKET)
+    auto need = size_t(4 + bckp_tkl + 18); // Header, token, Block1, Block2, Size2 and marker
+    auto room = pkt.capacity() > need ? pkt.capacity() - need : 0;
+    while (szx && (size_t(16) << szx) > room)
+        --szx;
+#endif
+
+    block_opt blk = {.szx = szx};
+    if (bckp_blk2_set) {
+        if (!bckp_blk2.valid())
+            return respond({}, msg_code::bad_option);
+        blk.szx = std::min(bckp_blk2.szx, szx);
+        blk.num = uint32_t(bckp_blk2.offset() >> (blk.szx + 4));
+    }
+    auto offset = blk.offset();
+    if (offset && offset >= src.size)
+        return respond({}, msg_code::bad_option);
+
+    auto n = std::min(blk.size(), src.size - offset);
+    blk.more = offset + n < src.size;
+    bool piggyback = serving();
+#if (ENABLE_PACKET)
+    compose(piggyback, code);
+    if (bckp_blk2_set || blk.more) {
+        opt_insert_uint(pkt, option_num::block2, blk.value());
+        if (!blk.num)
+            opt_insert_uint(pkt, option_num::size2, uint32_t(src.size));
+    }
+    auto out = pkt.alloc_payload(n);
+    if (n && out.data())
+        pkt.alloc_payload(src.read(src.ctx, offset, out));
+#endif
+    process(piggyback ? rr_server_event::piggybacked : rr_server_event::separate);
+}
+
+/**
+ * @brief Pass payload of request to sink, taking Block1 option into 
+ * account (RFC 7959, 2.5). Intermediate blocks are acknowledged with 
+ * 2.31 Continue, and final response to the last block, which caller
+ * sends as usual, carries Block1 too. Rejected or malformed blocks 
+ * get 4.08 Request Entity Incomplete or 4.00 Bad Request.
+ * 
+ * @param sink Body sink
+ * @return What caller should do next
+ */
+constexpr block_status server::receive_block(const payload_sink& sink)
+{
+#if (ENABLE_PACKET)
+    auto pld = pkt.get_payload();
+    bool has_blk1 = block_get(pkt, option_num::block1, blk1);
+#else
+    ispan pld;
+    bool has_blk1 = false;
+#endif
+    if (!has_blk1) {
+        if (sink.write(sink.ctx, 0, pld, true))
+            return block_status::complete;
+        respond({}, msg_code::request_entity_incomplete);
+        return block_status::failed;
+    }
+    if (!blk1.valid() || (blk1.more && pld.size() != blk1.size())) {
+        respond({}, msg_code::bad_request);
+        return block_status::failed;
+    }
+    if (!sink.write(sink.ctx, blk1.offset(), pld, !blk1.more)) {
+        respond({}, msg_code::request_entity_incomplete);
+        return block_status::failed;
+    }
+    echo_blk1 = true;
+    if (blk1.more) {
+        respond({}, msg_code::continue_);
+        return block_status::partial;
+    }
+    return block_status::complete;
+}
+
 constexpr void server::handle_rrevt(rr_event ev)
 {
     process(rr_server_event(ev));
@@ -99,10 +277,14 @@ constexpr void server::process_idle(rr_server_event ev)
     case rr_server_event::rx_con: 
         state = rr_server_state::serving; 
         confirmable = true; 
+        echo_blk1 = false;
+        backup();
     break;
     case rr_server_event::rx_non: 
         state = rr_server_state::separate; 
         confirmable = false; 
+        echo_blk1 = false;
+        backup();
     break;
     default: 
         app_handler(app_event_type::error, {.err = {error::unexpected_event}});
@@ -146,6 +328,11 @@ constexpr bool server::idle() const
     return state == rr_server_state::idle;
 }
 
+constexpr bool server::serving() const
+{
+    return state == rr_server_state::serving;
+}
+
 // SECTION OLD
 
 // void Server::respond(Code code, span payload)
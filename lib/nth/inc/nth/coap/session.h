@@ -25,6 +25,9 @@ struct session {
     constexpr void feed(ispan input);
     constexpr bool closed() const;
     constexpr bool finished() const;
+#if (ENABLE_PACKET)
+    constexpr const packet_view& get_packet() const { return pkt; }
+#endif
 protected:
     constexpr void advance();
     constexpr void process_rrevt(rr_event ev);
@@ -45,12 +48,12 @@ protected:
 #endif
 private:
     msg_state   state = msg_state::closed;
-    timestamp   retx_ts;
-    int         retx_count;
+    timestamp   retx_ts = 0;
+    int         retx_count = 0;
 #if (STORE_RREVT)
-    rr_event    rrevt;
+    rr_event    rrevt = rr_event::idle;
 #endif
-    bool        rx_pending;
+    bool        rx_pending = false;
 #if (STORE_RREVT)
     using dispatch_fn = void (session::*)(msg_event);
 #else
@@ -68,6 +71,9 @@ constexpr void session<T>::init(packet_view pkt_storage)
 {
     pkt = pkt_storage;
     pkt.clear();
+    state = msg_state::closed;
+    retx_count = 0;
+    rx_pending = false;
 }
 
 template<class T>
@@ -146,6 +152,7 @@ template<class T>
 constexpr void session<T>::process(msg_event ev)
 {
 #if (STORE_RREVT)
+    rrevt = rr_event::idle;
     (this->*dispatch_table[+state])(ev);
     process_rrevt(rrevt);
 #else
@@ -183,14 +190,14 @@ constexpr void session<T>::process_closed(msg_event ev)
         retx_ts = app_get_time() + imp::ack_timeout;
 #if (ENABLE_PACKET)
         pkt.set_type(msg_type::con);
-        // pkt.set_id(get_next_id()); // FIXME
+        pkt.set_id(app_next_id());
 #endif
         app_handler(app_event_type::transmission); // FIXME
     break;
     case msg_event::cmd_unreliable_send:
 #if (ENABLE_PACKET)
         pkt.set_type(msg_type::non);
-        // pkt.set_id(get_next_id()); // FIXME
+        pkt.set_id(app_next_id());
 #endif
         app_handler(app_event_type::transmission); // FIXME
     break;
@@ -0,0 +1,243 @@
+#ifndef NTH_COAP_UDP_H
+#define NTH_COAP_UDP_H
+
+#include "nth/coap/address.h"
+#include <cstring>
+#include <utility>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace nth::coap {
+
+/**
+ * @brief Non-blocking UDP socket with epoll readiness wait and batch
+ * I/O through 'recvmmsg' and 'sendmmsg', so one system call moves up
+ * to 'max_batch' datagrams. Satisfies nth::coap::transport. Linux host
+ * only. Check 'valid' after construction, socket or bind can fail.
+ *
+ */
+struct udp_socket {
+
+    static constexpr size_t max_batch = 64;
+
+    // ANCHOR Constructors
+
+    udp_socket() noexcept = default;
+    explicit udp_socket(const address& local) noexcept
+    {
+        sockaddr_storage sa;
+        auto sa_len = to_sockaddr(local, sa);
+        if (!sa_len)
+            return;
+        sock = socket(sa.ss_family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (sock < 0)
+            return;
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        epoll_event ev = {.events = EPOLLIN, .data = {.fd = sock}};
+        if (epfd < 0 ||
+            bind(sock, reinterpret_cast<const sockaddr*>(&sa), sa_len) ||
+            epoll_ctl(epfd, EPOLL_CTL_ADD, sock, &ev))
+        {
+            close();
+        }
+    }
+    udp_socket(udp_socket&& other) noexcept
+        : sock{std::exchange(other.sock, -1)}, epfd{std::exchange(other.epfd, -1)}
+    {}
+    udp_socket& operator=(udp_socket&& other) noexcept
+    {
+        if (&other != this) {
+            close();
+            sock = std::exchange(other.sock, -1);
+            epfd = std::exchange(other.epfd, -1);
+        }
+        return *this;
+    }
+    ~udp_socket() noexcept
+    {
+        close();
+    }
+
+    // ANCHOR Access
+
+    bool valid() const noexcept { return sock >= 0; }
+    int handle() const noexcept { return sock; }
+
+    /**
+     * @brief Get bound local address, useful when bound to port 0.
+     *
+     * @return Local address, unspecified type on failure
+     */
+    address local() const
+    {
+        sockaddr_storage sa;
+        socklen_t sa_len = sizeof(sa);
+        if (getsockname(sock, reinterpret_cast<sockaddr*>(&sa), &sa_len))
+            return {};
+        return from_sockaddr(sa);
+    }
+
+    // ANCHOR I/O
+
+    /**
+     * @brief Wait until socket is readable.
+     *
+     * @param timeout_ms Timeout in milliseconds, -1 to wait forever
+     * @return True if there's something to receive
+     */
+    bool wait(int timeout_ms) const
+    {
+        epoll_event ev;
+        return epoll_wait(epfd, &ev, 1, timeout_ms) > 0;
+    }
+
+    /**
+     * @brief Receive whatever is queued without blocking, up to 'out.size()'
+     * datagrams. Storage is split into equal chunks, one per datagram,
+     * longer datagrams are dropped, since truncated message may still
+     * look valid.
+     *
+     * @param out Received datagrams, data points into storage
+     * @param storage Buffer for payloads
+     * @return Number of received datagrams
+     */
+    size_t recv(std::span<datagram> out, ospan storage)
+    {
+        if (out.empty())
+            return 0;
+        size_t chunk = storage.size() / out.size();
+        size_t total = 0;
+
+        while (total < out.size()) {
+            size_t n = std::min(out.size() - total, max_batch);
+            mmsghdr msgs[max_batch];
+            iovec iov[max_batch];
+            sockaddr_storage sa[max_batch];
+            for (size_t i = 0; i < n; ++i) {
+                iov[i] = {storage.data() + (total + i) * chunk, chunk};
+                msgs[i] = {};
+                msgs[i].msg_hdr.msg_name = &sa[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(sa[i]);
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            auto ret = recvmmsg(sock, msgs, unsigned(n), MSG_DONTWAIT, nullptr);
+            if (ret <= 0)
+                break;
+            size_t kept = 0;
+            for (size_t i = 0; i < size_t(ret); ++i) {
+                if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+                    continue;
+                auto data = storage.data() + (total + kept) * chunk;
+                if (kept != i)
+                    std::memmove(data, iov[i].iov_base, msgs[i].msg_len);
+                out[total + kept++] = {from_sockaddr(sa[i]), {data, msgs[i].msg_len}};
+            }
+            total += kept;
+            if (size_t(ret) < n)
+                break;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Send batch of datagrams without blocking.
+     *
+     * @param batch Datagrams to send
+     * @return Number of datagrams sent, stops at first error (e.g. full socket buffer)
+     */
+    size_t send(std::span<const datagram> batch)
+    {
+        size_t total = 0;
+
+        while (total < batch.size()) {
+            size_t n = std::min(batch.size() - total, max_batch);
+            mmsghdr msgs[max_batch];
+            iovec iov[max_batch];
+            sockaddr_storage sa[max_batch];
+            for (size_t i = 0; i < n; ++i) {
+                auto& dg = batch[total + i];
+                iov[i] = {const_cast<byte*>(dg.data.data()), dg.data.size()};
+                msgs[i] = {};
+                msgs[i].msg_hdr.msg_name = &sa[i];
+                msgs[i].msg_hdr.msg_namelen = to_sockaddr(dg.addr, sa[i]);
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            auto ret = sendmmsg(sock, msgs, unsigned(n), MSG_DONTWAIT);
+            if (ret <= 0)
+                break;
+            total += ret;
+            if (size_t(ret) < n)
+                break;
+        }
+        return total;
+    }
+
+    // ANCHOR Address conversion
+
+    static socklen_t to_sockaddr(const address& addr, sockaddr_storage& sa)
+    {
+        sa = {};
+        switch (addr.type)
+        {
+        case addr_type::ipv4: {
+            auto& in = reinterpret_cast<sockaddr_in&>(sa);
+            in.sin_family = AF_INET;
+            in.sin_port = htons(addr.port);
+            in.sin_addr.s_addr = htonl(addr.data.u32);
+            return sizeof(in);
+        }
+        case addr_type::ipv6: {
+            auto& in6 = reinterpret_cast<sockaddr_in6&>(sa);
+            in6.sin6_family = AF_INET6;
+            in6.sin6_port = htons(addr.port);
+            std::ranges::copy(addr.data.ipv6, in6.sin6_addr.s6_addr);
+            return sizeof(in6);
+        }
+        default:
+            return 0;
+        }
+    }
+    static address from_sockaddr(const sockaddr_storage& sa)
+    {
+        address addr = {};
+        switch (sa.ss_family)
+        {
+        case AF_INET: {
+            auto& in = reinterpret_cast<const sockaddr_in&>(sa);
+            addr.type = addr_type::ipv4;
+            addr.port = ntohs(in.sin_port);
+            addr.data.u32 = ntohl(in.sin_addr.s_addr);
+        }
+        break;
+        case AF_INET6: {
+            auto& in6 = reinterpret_cast<const sockaddr_in6&>(sa);
+            addr.type = addr_type::ipv6;
+            addr.port = ntohs(in6.sin6_port);
+            std::ranges::copy(in6.sin6_addr.s6_addr, addr.data.ipv6.begin());
+        }
+        break;
+        }
+        return addr;
+    }
+private:
+    void close()
+    {
+        if (sock >= 0)
+            ::close(sock);
+        if (epfd >= 0)
+            ::close(epfd);
+        sock = epfd = -1;
+    }
+private:
+    int sock = -1;
+    int epfd = -1;
+};
+
+}
+
+#endif
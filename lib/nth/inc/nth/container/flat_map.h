@@ -0,0 +1,363 @@
+#ifndef NTH_CONTAINER_FLAT_MAP_H
+#define NTH_CONTAINER_FLAT_MAP_H
+
+#include "nth/util/storage.h"
+#include <bit>
+#include <functional>
+#include <ranges>
+#include <utility>
+
+namespace nth {
+
+/**
+ * @brief Default hash for flat containers, usable in constexpr context.
+ * Integers, enums and pointers are passed through 64-bit finalizer from
+ * MurmurHash3, contiguous ranges of integers (strings, tokens, addresses)
+ * are hashed with FNV-1a and then finalized the same way.
+ *
+ */
+struct flat_hash {
+    static constexpr size_t mix(uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccd;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53;
+        x ^= x >> 33;
+        return size_t(x);
+    }
+    template<class T>
+    requires std::integral<T> || std::is_enum_v<T>
+    constexpr size_t operator()(T x) const
+    {
+        return mix(uint64_t(x));
+    }
+    template<class T>
+    size_t operator()(T* x) const
+    {
+        return mix(uint64_t(reinterpret_cast<uintptr_t>(x)));
+    }
+    template<std::ranges::contiguous_range R>
+    requires std::integral<std::ranges::range_value_t<R>>
+    constexpr size_t operator()(const R& range) const
+    {
+        uint64_t h = 0xcbf29ce484222325;
+        for (auto it : range) {
+            h ^= uint64_t(it);
+            h *= 0x100000001b3;
+        }
+        return mix(h);
+    }
+};
+
+namespace imp {
+
+/**
+ * @brief Fixed-capacity open addressing hash table with Robin Hood
+ * linear probing. Every slot has a control value: 0 if it's empty or
+ * distance from home slot + 1. Lookup stops as soon as control value
+ * says wanted key would be richer than current slot, insertion shifts
+ * the rest of the cluster by one slot and deletion shifts following
+ * cluster back, so there are never any tombstones. Load factor can
+ * go up to 100%, but probe sequences stay short until ~90%.
+ *
+ * @tparam Value Stored type
+ * @tparam Key Key type
+ * @tparam KeyOf Function object which extracts key from stored value
+ * @tparam N Number of slots, must be power of 2
+ * @tparam Hash Hash function object
+ * @tparam Eq Key equality function object
+ */
+template<class Value, class Key, class KeyOf, size_t N, class Hash, class Eq>
+struct flat_table {
+
+    template<class U>
+    struct iterator_base {
+
+        using self              = iterator_base;
+        using value_type        = U;
+        using reference         = value_type&;
+        using pointer           = value_type*;
+        using difference_type   = ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+        using table_pointer     = std::conditional_t<std::is_const_v<U>, const flat_table*, flat_table*>;
+
+        constexpr iterator_base() = default;
+        constexpr iterator_base(const iterator_base<value_type>& other) = default;
+        constexpr iterator_base(const iterator_base<std::remove_const_t<value_type>>& other) requires std::is_const_v<value_type>
+            : tab{other.tab}, idx{other.idx}
+        {}
+        constexpr iterator_base(table_pointer tab, size_t idx)
+            : tab{tab}, idx{idx}
+        {
+            skip();
+        }
+        constexpr self&     operator++()        { ++idx; skip(); return *this; }
+        constexpr self      operator++(int)     { auto tmp = *this; ++(*this); return tmp; }
+        constexpr reference operator*() const   { return  tab->buf[idx]; }
+        constexpr pointer   operator->() const  { return &tab->buf[idx]; }
+
+        friend constexpr bool operator==(const self& lhs, const self& rhs) { return lhs.idx == rhs.idx; }
+        friend struct iterator_base<std::add_const_t<value_type>>;
+        friend flat_table;
+    private:
+        constexpr void skip()
+        {
+            while (idx < N && !tab->ctrl[idx])
+                ++idx;
+        }
+        table_pointer tab = nullptr;
+        size_t idx = N;
+    };
+
+    // ANCHOR Member types
+
+    using key_type          = Key;
+    using value_type        = Value;
+    using size_type         = size_t;
+    using hasher            = Hash;
+    using key_equal         = Eq;
+    using iterator          = iterator_base<value_type>;
+    using const_iterator    = iterator_base<const value_type>;
+    using control_type      = std::conditional_t<(N < 0xff), uint8_t, std::conditional_t<(N < 0xffff), uint16_t, uint32_t>>;
+
+    static_assert(std::forward_iterator<iterator>);
+
+    // ANCHOR Constructors
+
+    constexpr flat_table() noexcept = default;
+    constexpr flat_table(const flat_table& other) : len{other.len}
+    {
+        for (size_t i = 0; i < N; ++i)
+            if ((ctrl[i] = other.ctrl[i]))
+                ctor(&buf[i], other.buf[i]);
+    }
+    constexpr flat_table& operator=(const flat_table& other)
+    {
+        if (&other != this) {
+            clear();
+            len = other.len;
+            for (size_t i = 0; i < N; ++i)
+                if ((ctrl[i] = other.ctrl[i]))
+                    ctor(&buf[i], other.buf[i]);
+        }
+        return *this;
+    }
+
+    // ANCHOR Desctructor
+
+    constexpr ~flat_table() noexcept
+    {
+        clear();
+    }
+
+    // ANCHOR Capacity
+
+    constexpr static size_type capacity()       { return N; }
+    constexpr static size_type max_size()       { return N; }
+    constexpr size_type size() const noexcept   { return len; }
+    constexpr bool empty() const noexcept       { return len == 0; }
+    constexpr bool full() const noexcept        { return len == N; }
+
+    // ANCHOR Iterators
+
+    constexpr iterator begin() noexcept                 { return {this, 0}; }
+    constexpr const_iterator begin() const noexcept     { return {this, 0}; }
+    constexpr const_iterator cbegin() const noexcept    { return begin(); }
+    constexpr iterator end() noexcept                   { return {this, N}; }
+    constexpr const_iterator end() const noexcept       { return {this, N}; }
+    constexpr const_iterator cend() const noexcept      { return end(); }
+
+    // ANCHOR Lookup
+
+    constexpr iterator find(const key_type& key)                { return {this, locate(key)}; }
+    constexpr const_iterator find(const key_type& key) const    { return {this, locate(key)}; }
+    constexpr bool contains(const key_type& key) const          { return locate(key) != N; }
+    constexpr size_type count(const key_type& key) const        { return contains(key); }
+
+    // ANCHOR Modifiers
+
+    constexpr void clear() noexcept
+    {
+        for (size_t i = 0; i < N; ++i) {
+            if (ctrl[i]) {
+                dtor(&buf[i]);
+                ctrl[i] = 0;
+            }
+        }
+        len = 0;
+    }
+
+    /**
+     * @brief Remove element with given key.
+     *
+     * @param key Key to look for
+     * @return Number of removed elements, 0 or 1
+     */
+    constexpr size_type erase(const key_type& key)
+    {
+        auto i = locate(key);
+        if (i == N)
+            return 0;
+        remove(i);
+        return 1;
+    }
+
+    /**
+     * @brief Remove element at valid iterator. Other elements may be
+     * moved back by one slot, so all iterators are invalidated.
+     *
+     * @param pos Iterator to element
+     */
+    constexpr void erase(const_iterator pos)
+    {
+        assert(pos.idx < N && ctrl[pos.idx]);
+        remove(pos.idx);
+    }
+protected:
+    static constexpr auto M = N - 1;
+    static_assert(N > 1 && !(M & N), "flat table size must be > 1 and power of 2");
+    static constexpr size_t home(const key_type& key)   { return Hash{}(key) & M; }
+    static constexpr auto& key_of(const value_type& v)  { return KeyOf{}(v); }
+
+    constexpr size_t locate(const key_type& key) const
+    {
+        auto i = home(key);
+        for (control_type d = 1; d <= ctrl[i]; ++d, i = (i + 1) & M) {
+            if (d == ctrl[i] && Eq{}(key_of(buf[i]), key))
+                return i;
+        }
+        return N;
+    }
+
+    /**
+     * @brief Construct new element in a free slot for a key which is
+     * known to be absent. Slot is picked by Robin Hood rule and the rest
+     * of the cluster is shifted one slot forward.
+     *
+     * @return Slot index of new element or N if table is full
+     */
+    template<class... Args>
+    constexpr size_t place(const key_type& key, Args&&... args)
+    {
+        if (full())
+            return N;
+        auto i = home(key);
+        control_type d = 1;
+        while (ctrl[i] >= d) {
+            i = (i + 1) & M;
+            ++d;
+        }
+        auto e = i;
+        while (ctrl[e])
+            e = (e + 1) & M;
+        while (e != i) {
+            auto p = (e - 1) & M;
+            ctor(&buf[e], std::move(buf[p]));
+            dtor(&buf[p]);
+            ctrl[e] = ctrl[p] + 1;
+            e = p;
+        }
+        ctor(&buf[i], std::forward<Args>(args)...);
+        ctrl[i] = d;
+        ++len;
+        return i;
+    }
+
+    constexpr void remove(size_t i)
+    {
+        dtor(&buf[i]);
+        for (auto n = (i + 1) & M; ctrl[n] > 1; i = n, n = (n + 1) & M) {
+            ctor(&buf[i], std::move(buf[n]));
+            dtor(&buf[n]);
+            ctrl[i] = ctrl[n] - 1;
+        }
+        ctrl[i] = 0;
+        --len;
+    }
+protected:
+    storage<value_type, N> buf;
+    control_type ctrl[N] = {};
+    size_type len = 0;
+};
+
+struct flat_map_key {
+    template<class P>
+    constexpr auto& operator()(const P& p) const { return p.first; }
+};
+
+}
+
+/**
+ * @brief Associative container with static storage for N elements,
+ * implemented as open addressing hash table with Robin Hood probing
+ * and tombstone-free deletion. Can be used in constexpr context.
+ *
+ * @tparam K Key type
+ * @tparam V Mapped type
+ * @tparam N Maximum number of elements, must be power of 2
+ * @tparam Hash Hash function object
+ * @tparam Eq Key equality function object
+ */
+template<class K, class V, size_t N, class Hash = flat_hash, class Eq = std::equal_to<K>>
+struct flat_map : imp::flat_table<std::pair<const K, V>, K, imp::flat_map_key, N, Hash, Eq> {
+
+    using base = imp::flat_table<std::pair<const K, V>, K, imp::flat_map_key, N, Hash, Eq>;
+    using mapped_type = V;
+    using typename base::key_type;
+    using typename base::value_type;
+    using typename base::iterator;
+
+    constexpr flat_map() noexcept = default;
+    constexpr flat_map(std::initializer_list<value_type> list)
+    {
+        for (auto& it : list)
+            insert(it);
+    }
+
+    /**
+     * @brief Insert element if key doesn't exist yet.
+     *
+     * @return Iterator to element with given key and true if inserted,
+     * false if key already existed. Iterator is end() if map is full.
+     */
+    constexpr std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return try_emplace(value.first, value.second);
+    }
+
+    template<class... Args>
+    constexpr std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+    {
+        if (auto i = base::locate(key); i != N)
+            return {{this, i}, false};
+        auto i = base::place(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        return {{this, i}, i != N};
+    }
+
+    template<class M>
+    constexpr std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+    {
+        if (auto i = base::locate(key); i != N) {
+            base::buf[i].second = std::forward<M>(obj);
+            return {{this, i}, false};
+        }
+        return try_emplace(key, std::forward<M>(obj));
+    }
+
+    /**
+     * @brief Access mapped value, default constructing it if key
+     * doesn't exist. Map must not be full in that case.
+     *
+     */
+    constexpr mapped_type& operator[](const key_type& key)
+    {
+        auto it = try_emplace(key).first;
+        assert(it != base::end());
+        return it->second;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef NTH_CONTAINER_FLAT_SET_H
+#define NTH_CONTAINER_FLAT_SET_H
+
+#include "nth/container/flat_map.h"
+
+namespace nth {
+namespace imp {
+
+struct flat_set_key {
+    template<class K>
+    constexpr auto& operator()(const K& k) const { return k; }
+};
+
+}
+
+/**
+ * @brief Set with static storage for N elements, same Robin Hood 
+ * open addressing table as nth::flat_map. Elements are immutable
+ * through iterators. Can be used in constexpr context.
+ *
+ * @tparam K Key type
+ * @tparam N Maximum number of elements, must be power of 2
+ * @tparam Hash Hash function object
+ * @tparam Eq Key equality function object
+ */
+template<class K, size_t N, class Hash = flat_hash, class Eq = std::equal_to<K>>
+struct flat_set : imp::flat_table<const K, K, imp::flat_set_key, N, Hash, Eq> {
+
+    using base = imp::flat_table<const K, K, imp::flat_set_key, N, Hash, Eq>;
+    using typename base::key_type;
+    using typename base::iterator;
+
+    constexpr flat_set() noexcept = default;
+    constexpr flat_set(std::initializer_list<key_type> list)
+    {
+        for (auto& it : list)
+            insert(it);
+    }
+
+    /**
+     * @brief Insert key if it doesn't exist yet.
+     *
+     * @return Iterator to element with given key and true if inserted,
+     * false if key already existed. Iterator is end() if set is full.
+     */
+    constexpr std::pair<iterator, bool> insert(const key_type& key)
+    {
+        if (auto i = base::locate(key); i != N)
+            return {{this, i}, false};
+        auto i = base::place(key, key);
+        return {{this, i}, i != N};
+    }
+};
+
+}
+
+#endif
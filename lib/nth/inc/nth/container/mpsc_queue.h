@@ -0,0 +1,103 @@
+#ifndef NTH_CONTAINER_MPSC_QUEUE_H
+#define NTH_CONTAINER_MPSC_QUEUE_H
+
+#include "nth/util/meta.h"
+#include <atomic>
+
+namespace nth {
+
+/**
+ * @brief Hook for nodes of nth::mpsc_queue, embed it into item type by
+ * inheritance. Node must stay alive and unmodified until it's popped.
+ * 
+ */
+struct mpsc_node {
+    std::atomic<mpsc_node*> next = nullptr;
+};
+
+/**
+ * @brief Intrusive lock-free multi-producer single-consumer queue of
+ * caller-owned nodes (D. Vyukov's algorithm). Push is wait-free, a single
+ * atomic exchange, so it can be called from any thread or ISR without
+ * allocation. Pop is lock-free and must only be called from one consumer.
+ * Queue is unbounded and holds only pointers, nothing is copied. 
+ * 
+ * @tparam T Item type, must be derived from nth::mpsc_node
+ */
+template<class T>
+struct mpsc_queue {
+
+    using value_type = T;
+    using pointer = T*;
+
+    mpsc_queue() noexcept = default;
+    mpsc_queue(const mpsc_queue&) = delete;
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+    /**
+     * @brief Append node, safe to call from any number of producers.
+     * 
+     * @param item Node to append, must not be in the queue already
+     */
+    void push(pointer item) noexcept
+    {
+        push_node(static_cast<mpsc_node*>(item));
+    }
+
+    /**
+     * @brief Remove node from the front, consumer only. Might return
+     * nullptr while a producer is in the middle of push, even though 
+     * queue isn't empty, in that case just try later.
+     * 
+     * @return Front node or nullptr
+     */
+    pointer pop() noexcept
+    {
+        auto t = tail;
+        auto next = t->next.load(std::memory_order_acquire);
+        if (t == &stub) {
+            if (!next)
+                return nullptr;
+            tail = t = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail = next;
+            return static_cast<pointer>(t);
+        }
+        if (t != head.load(std::memory_order_acquire))
+            return nullptr;
+        push_node(&stub);
+        next = t->next.load(std::memory_order_acquire);
+        if (next) {
+            tail = next;
+            return static_cast<pointer>(t);
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Check if there's nothing to pop, consumer only.
+     * 
+     * @return True if queue is empty
+     */
+    bool empty() const noexcept
+    {
+        return tail == &stub && !stub.next.load(std::memory_order_acquire);
+    }
+private:
+    void push_node(mpsc_node* n) noexcept
+    {
+        n->next.store(nullptr, std::memory_order_relaxed);
+        auto prev = head.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release);
+    }
+private:
+    alignas(cache_line_size) std::atomic<mpsc_node*> head = &stub;  // Last pushed node, written by producers
+    alignas(cache_line_size) mpsc_node* tail = &stub;               // Next node to pop, owned by consumer
+    mpsc_node stub;
+};
+
+}
+
+#endif
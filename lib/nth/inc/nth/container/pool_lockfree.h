@@ -0,0 +1,166 @@
+#ifndef NTH_CONTAINER_POOL_LOCKFREE_H
+#define NTH_CONTAINER_POOL_LOCKFREE_H
+
+#include "nth/util/storage.h"
+#include <atomic>
+
+namespace nth {
+
+/**
+ * @brief Lock-free static object pool with pre-allocated memory, safe to
+ * get and release from any number of threads. Free slots are kept in
+ * Treiber stack of indices, head of which is tagged with modification
+ * counter in the upper half of the word to prevent ABA. Batch operations
+ * 'get_n' and 'release_n' take or return whole chain of slots with a
+ * single CAS. Same unique_ptr with releaser ergonomics as nth::pool.
+ *
+ * @tparam T Type of elements
+ * @tparam N Number of elements in pool
+ */
+template<class T, size_t N>
+class pool_lockfree {
+    struct releaser {
+        void operator()(T* obj) {
+            if (obj) {
+                dtor(obj);
+                auto idx = index_type(obj - ptr->buf);
+                ptr->push(idx, idx, 1);
+            }
+        }
+        pool_lockfree* ptr;
+    };
+    using word_type = size_t;
+    using index_type = uint32_t;
+    static constexpr auto half = sizeof(word_type) * 4;
+    static constexpr auto index_mask = (word_type(1) << half) - 1;
+    static constexpr auto nil = index_type(N);
+    static_assert(N < index_mask, "pool size must fit in half of the word");
+public:
+    using size_type = size_t;
+    using value_type = T;
+    using return_type = std::unique_ptr<value_type, releaser>;
+
+    // ANCHOR Constructors
+
+    pool_lockfree() noexcept
+    {
+        for (size_type i = 0; i < N; ++i)
+            next[i].store(index_type(i + 1), std::memory_order_relaxed);
+    }
+    pool_lockfree(const pool_lockfree&) = delete;
+    pool_lockfree(pool_lockfree&&) = delete;
+    pool_lockfree& operator=(const pool_lockfree&) = delete;
+    pool_lockfree& operator=(pool_lockfree&&) = delete;
+
+    // ANCHOR Capacity
+
+    constexpr static size_type capacity()   { return N; }
+    size_type left() const noexcept         { return available.load(std::memory_order_relaxed); }
+    bool empty() const noexcept             { return left() == 0; }
+    bool full() const noexcept              { return left() == N; }
+
+    // ANCHOR Modifiers
+
+    /**
+     * @brief Take one object from the pool and construct it with given arguments.
+     *
+     * @return Owning pointer, empty if pool is exhausted
+     */
+    template<typename... Args>
+    auto get(Args&&... args)
+    {
+        index_type first, last;
+        if (!pop(1, first, last))
+            return return_type(nullptr, releaser{this});
+        return return_type(ctor(&buf[first], std::forward<Args>(args)...), releaser{this});
+    }
+
+    /**
+     * @brief Take up to 'out.size()' objects from the pool with a single
+     * CAS and construct each of them with same arguments.
+     *
+     * @param out Destination for owning pointers
+     * @return Number of objects acquired, either 'out.size()' or 0 if
+     * there wasn't enough free objects at the moment
+     */
+    template<typename... Args>
+    size_type get_n(std::span<return_type> out, const Args&... args)
+    {
+        index_type first, last;
+        if (out.empty() || !pop(out.size(), first, last))
+            return 0;
+        for (auto& it : out) {
+            it = return_type(ctor(&buf[first], args...), releaser{this});
+            first = next[first].load(std::memory_order_relaxed);
+        }
+        return out.size();
+    }
+
+    /**
+     * @brief Destroy and return all non-empty objects in a batch with a single CAS.
+     *
+     * @param objs Owning pointers, all of them are empty afterwards
+     */
+    void release_n(std::span<return_type> objs)
+    {
+        index_type first = nil;
+        index_type last = nil;
+        size_type n = 0;
+
+        for (auto& it : objs) {
+            if (!it)
+                continue;
+            assert(it.get_deleter().ptr == this);
+            auto idx = index_type(it.get() - buf);
+            dtor(it.release());
+            if (first == nil)
+                last = idx;
+            else
+                next[idx].store(first, std::memory_order_relaxed);
+            first = idx;
+            ++n;
+        }
+        if (n)
+            push(first, last, n);
+    }
+private:
+    static constexpr auto index(word_type w)    { return index_type(w & index_mask); }
+    static constexpr auto tagged(word_type w, index_type idx)
+    {
+        return ((w >> half) + 1) << half | idx;
+    }
+    bool pop(size_type n, index_type& first, index_type& last)
+    {
+        auto w = head.load(std::memory_order_acquire);
+        while (true) {
+            first = index(w);
+            last = first;
+            for (size_type i = 1; i < n && last != nil; ++i)
+                last = next[last].load(std::memory_order_relaxed);
+            if (last == nil)
+                return false;
+            auto rest = next[last].load(std::memory_order_relaxed);
+            if (head.compare_exchange_weak(w, tagged(w, rest), std::memory_order_acquire, std::memory_order_acquire))
+                break;
+        }
+        available.fetch_sub(n, std::memory_order_relaxed);
+        return true;
+    }
+    void push(index_type first, index_type last, size_type n)
+    {
+        available.fetch_add(n, std::memory_order_relaxed);
+        auto w = head.load(std::memory_order_relaxed);
+        do {
+            next[last].store(index(w), std::memory_order_relaxed);
+        } while (!head.compare_exchange_weak(w, tagged(w, first), std::memory_order_release, std::memory_order_relaxed));
+    }
+private:
+    storage<T, N> buf;
+    std::atomic<index_type> next[N];
+    alignas(cache_line_size) std::atomic<word_type> head = 0;
+    alignas(cache_line_size) std::atomic<size_type> available = N;
+};
+
+}
+
+#endif
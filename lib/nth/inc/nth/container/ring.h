@@ -352,6 +352,91 @@ struct ring {
         return true; 
     }
 
+    // ANCHOR Bulk
+
+    /**
+     * @brief Copy as many elements from range as there is free space
+     * for, at most two contiguous copies.
+     *
+     * @param range Contiguous range of elements to push, e.g. span
+     * @return Number of elements pushed
+     */
+    template<std::ranges::contiguous_range R>
+    requires std::convertible_to<R&&, const_array_range>
+    constexpr size_type push_back(R&& range)
+    {
+        const_array_range array = range;
+        auto n = std::min(array.size(), capacity() - size());
+        auto one = std::min(n, N - mask(tail));
+        copy_create_forward(array.begin(), array.begin() + one, ptail());
+        copy_create_forward(array.begin() + one, array.begin() + n, pbegin());
+        tail += n;
+        return n;
+    }
+
+    /**
+     * @brief Move as many elements from the front as fit into array,
+     * at most two contiguous moves.
+     *
+     * @param array Destination for popped elements
+     * @return Number of elements popped
+     */
+    constexpr size_type pop_front(std::span<value_type> array)
+    {
+        auto n = std::min(array.size(), size());
+        auto one = std::min(n, N - mask(head));
+        auto out = move_assign_forward(pfront(), pfront() + one, array.begin());
+        move_assign_forward(pbegin(), pbegin() + (n - one), out);
+        erase_begin(n);
+        return n;
+    }
+
+    /**
+     * @brief Get contiguous free region after the last element, to be
+     * filled in place (e.g. by DMA) and then published with 'commit_back'.
+     * Might be smaller than requested if free space wraps around or
+     * there's not enough of it. Only for trivial types, because
+     * elements in this region are not constructed.
+     *
+     * @param n Maximum number of elements to reserve
+     * @return Writable region, possibly empty
+     */
+    constexpr array_range reserve_back(size_type n = N) requires std::is_trivial_v<value_type>
+    {
+        return {ptail(), std::min({n, capacity() - size(), N - mask(tail)})};
+    }
+
+    /**
+     * @brief Append n elements previously written into region returned by 'reserve_back'.
+     *
+     * @param n Number of elements to append
+     */
+    constexpr void commit_back(size_type n) requires std::is_trivial_v<value_type>
+    {
+        assert(capacity() - size() >= n);
+        tail += n;
+    }
+
+    /**
+     * @brief Get contiguous region of elements starting from the front,
+     * to be read in place (e.g. by DMA) and then released with 'consume_front'.
+     *
+     * @return Readable region, same as 'array_one'
+     */
+    constexpr array_range peek_front()              { return array_one(); }
+    constexpr const_array_range peek_front() const  { return array_one(); }
+
+    /**
+     * @brief Remove n elements from the front, usually after reading them
+     * in place from 'peek_front'.
+     *
+     * @param n Number of elements to remove
+     */
+    constexpr void consume_front(size_type n)
+    {
+        erase_begin(n);
+    }
+
     constexpr void rotate(const_iterator new_begin)
     {
         assert(valid(new_begin));
@@ -0,0 +1,388 @@
+#ifndef NTH_CONTAINER_RING_LOCKFREE_H
+#define NTH_CONTAINER_RING_LOCKFREE_H
+
+#include "nth/util/storage.h"
+#include <atomic>
+
+namespace nth {
+
+/**
+ * @brief Lock-free single-producer single-consumer ring buffer with
+ * unmasked indices logic, same as nth::ring. Producer only writes tail
+ * and consumer only writes head, both are on separate cache lines
+ * together with cached copy of opposite index, so shared line is only
+ * touched when cached value says ring looks full or empty. Can be shared
+ * between ISR and thread, or between two threads on host.
+ *
+ * @tparam T Type of elements
+ * @tparam N Maximum number of elements, must be power of 2
+ */
+template<class T, size_t N>
+struct spsc_ring {
+
+    // ANCHOR Member types
+
+    using value_type                = T;
+    using size_type                 = size_t;
+    using pointer                   = value_type*;
+    using reference                 = value_type&;
+    using const_reference           = const value_type&;
+    using universal_reference       = value_type&&;
+    using array_range               = std::span<value_type>;
+    using const_array_range         = std::span<const value_type>;
+
+    // ANCHOR Constructors
+
+    spsc_ring() noexcept = default;
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    // ANCHOR Desctructor
+
+    ~spsc_ring() noexcept
+    {
+        for (auto i = head.load(std::memory_order_relaxed); i != tail.load(std::memory_order_relaxed); ++i)
+            dtor(on(i));
+    }
+
+    // ANCHOR Capacity
+
+    constexpr static size_type capacity()   { return N; }
+    constexpr static size_type max_size()   { return N; }
+
+    /**
+     * @brief Number of elements, only a snapshot if called while
+     * producer or consumer is active.
+     *
+     * @return Number of elements
+     */
+    size_type size() const noexcept
+    {
+        auto h = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - h;
+    }
+    bool empty() const noexcept   { return size() == 0; }
+    bool full() const noexcept    { return size() == capacity(); }
+
+    // ANCHOR Producer
+
+    bool push_back(const_reference x)
+    {
+        return emplace_back(x);
+    }
+
+    bool push_back(universal_reference x)
+    {
+        return emplace_back(std::move(x));
+    }
+
+    /**
+     * @brief Construct element at the back, producer only.
+     *
+     * @return True on success, false if ring is full
+     */
+    template<class... Args>
+    bool emplace_back(Args&&... args)
+    {
+        auto t = tail.load(std::memory_order_relaxed);
+        if (!vacant(t, 1))
+            return false;
+        ctor(on(t), std::forward<Args>(args)...);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Copy as many elements from range as there is free space
+     * for and publish them at once, producer only.
+     *
+     * @param range Contiguous range of elements to push, e.g. span
+     * @return Number of elements pushed
+     */
+    template<std::ranges::contiguous_range R>
+    requires std::convertible_to<R&&, const_array_range>
+    size_type push_back(R&& range)
+    {
+        const_array_range array = range;
+        auto t = tail.load(std::memory_order_relaxed);
+        vacant(t, array.size());
+        auto n = std::min(array.size(), N - (t - head_cached));
+        auto one = std::min(n, N - mask(t));
+        copy_create_forward(array.begin(), array.begin() + one, on(t));
+        copy_create_forward(array.begin() + one, array.begin() + n, pbegin());
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Get contiguous free region after the last element to be
+     * filled in place and published with 'commit_back', producer only.
+     * Only for trivial types, because elements in region are not constructed.
+     *
+     * @param n Maximum number of elements to reserve
+     * @return Writable region, possibly empty
+     */
+    array_range reserve_back(size_type n = N) requires std::is_trivial_v<value_type>
+    {
+        auto t = tail.load(std::memory_order_relaxed);
+        vacant(t, n);
+        return {on(t), std::min({n, N - (t - head_cached), N - mask(t)})};
+    }
+
+    /**
+     * @brief Publish n elements written into region from 'reserve_back', producer only.
+     *
+     * @param n Number of elements to append
+     */
+    void commit_back(size_type n) requires std::is_trivial_v<value_type>
+    {
+        auto t = tail.load(std::memory_order_relaxed);
+        assert(N - (t - head_cached) >= n);
+        tail.store(t + n, std::memory_order_release);
+    }
+
+    // ANCHOR Consumer
+
+    /**
+     * @brief Move front element out and remove it, consumer only.
+     *
+     * @param item Destination
+     * @return True on success, false if ring is empty
+     */
+    bool get_front(reference item)
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        if (!occupied(h, 1))
+            return false;
+        item = std::move(*on(h));
+        dtor(on(h));
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Move as many elements from the front as fit into array and
+     * release their slots at once, consumer only.
+     *
+     * @param array Destination for popped elements
+     * @return Number of elements popped
+     */
+    size_type pop_front(std::span<value_type> array)
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        occupied(h, array.size());
+        auto n = std::min(array.size(), tail_cached - h);
+        auto one = std::min(n, N - mask(h));
+        auto out = move_assign_forward(on(h), on(h) + one, array.begin());
+        move_assign_forward(pbegin(), pbegin() + (n - one), out);
+        dtor_n(on(h), one);
+        dtor_n(pbegin(), n - one);
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Get contiguous region of elements starting from the front
+     * to be read in place and released with 'consume_front', consumer only.
+     *
+     * @return Readable region, possibly empty
+     */
+    array_range peek_front()
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        occupied(h, N);
+        return {on(h), std::min(tail_cached - h, N - mask(h))};
+    }
+
+    /**
+     * @brief Remove n elements from the front, usually after reading
+     * them in place from 'peek_front', consumer only.
+     *
+     * @param n Number of elements to remove
+     */
+    void consume_front(size_type n)
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        assert(tail_cached - h >= n);
+        auto one = std::min(n, N - mask(h));
+        dtor_n(on(h), one);
+        dtor_n(pbegin(), n - one);
+        head.store(h + n, std::memory_order_release);
+    }
+private:
+    static constexpr auto M = N - 1;
+    static_assert(N > 1 && !(M & N), "ring size must be > 1 and power of 2");
+    static constexpr auto mask(size_type val)   { return val & M; }
+    auto on(size_type idx)            { return &buf[mask(idx)]; }
+    auto pbegin()                     { return &buf[0]; }
+    bool vacant(size_type t, size_type n)
+    {
+        if (N - (t - head_cached) >= n)
+            return true;
+        head_cached = head.load(std::memory_order_acquire);
+        return N - (t - head_cached) >= n;
+    }
+    bool occupied(size_type h, size_type n)
+    {
+        if (tail_cached - h >= n)
+            return true;
+        tail_cached = tail.load(std::memory_order_acquire);
+        return tail_cached - h >= n;
+    }
+private:
+    alignas(cache_line_size) std::atomic<size_type> tail = 0;   // Written by producer
+    size_type head_cached = 0;                                  // Producer's copy of head
+    alignas(cache_line_size) std::atomic<size_type> head = 0;   // Written by consumer
+    size_type tail_cached = 0;                                  // Consumer's copy of tail
+    alignas(cache_line_size) storage<T, N> buf;
+};
+
+/**
+ * @brief Lock-free multi-producer single-consumer ring buffer. Every
+ * slot has its own sequence number, producers claim slots by CAS on
+ * tail and publish them through the sequence, so a slow producer only
+ * delays consumer at its own slot, but never corrupts the ring. Same
+ * power of 2 masking as nth::ring.
+ *
+ * @tparam T Type of elements
+ * @tparam N Maximum number of elements, must be power of 2
+ */
+template<class T, size_t N>
+struct mpsc_ring {
+
+    // ANCHOR Member types
+
+    using value_type                = T;
+    using size_type                 = size_t;
+    using reference                 = value_type&;
+    using const_reference           = const value_type&;
+    using universal_reference       = value_type&&;
+
+    // ANCHOR Constructors
+
+    mpsc_ring() noexcept
+    {
+        for (size_type i = 0; i < N; ++i)
+            slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+    mpsc_ring(const mpsc_ring&) = delete;
+    mpsc_ring& operator=(const mpsc_ring&) = delete;
+
+    // ANCHOR Desctructor
+
+    ~mpsc_ring() noexcept
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        while (slots[mask(h)].seq.load(std::memory_order_relaxed) == h + 1)
+            dtor(slots[mask(h++)].get());
+    }
+
+    // ANCHOR Capacity
+
+    constexpr static size_type capacity()   { return N; }
+    constexpr static size_type max_size()   { return N; }
+
+    /**
+     * @brief Number of claimed slots, only a snapshot if called while
+     * producers or consumer are active.
+     *
+     * @return Number of elements
+     */
+    size_type size() const noexcept
+    {
+        auto h = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - h;
+    }
+    bool empty() const noexcept { return size() == 0; }
+    bool full() const noexcept  { return size() == capacity(); }
+
+    // ANCHOR Producer
+
+    bool push_back(const_reference x)
+    {
+        return emplace_back(x);
+    }
+
+    bool push_back(universal_reference x)
+    {
+        return emplace_back(std::move(x));
+    }
+
+    /**
+     * @brief Construct element at the back, safe to call from any number of producers.
+     *
+     * @return True on success, false if ring is full
+     */
+    template<class... Args>
+    bool emplace_back(Args&&... args)
+    {
+        auto t = tail.load(std::memory_order_relaxed);
+        while (true) {
+            auto& s = slots[mask(t)];
+            auto dif = ptrdiff_t(s.seq.load(std::memory_order_acquire) - t);
+            if (dif == 0) {
+                if (tail.compare_exchange_weak(t, t + 1, std::memory_order_relaxed)) {
+                    ctor(s.get(), std::forward<Args>(args)...);
+                    s.seq.store(t + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                t = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // ANCHOR Consumer
+
+    /**
+     * @brief Move front element out and remove it, consumer only.
+     *
+     * @param item Destination
+     * @return True on success, false if ring is empty or front slot is not published yet
+     */
+    bool get_front(reference item)
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        auto& s = slots[mask(h)];
+        if (s.seq.load(std::memory_order_acquire) != h + 1)
+            return false;
+        item = std::move(*s.get());
+        dtor(s.get());
+        s.seq.store(h + N, std::memory_order_release);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Move as many published elements from the front as fit into array, consumer only.
+     *
+     * @param array Destination for popped elements
+     * @return Number of elements popped
+     */
+    size_type pop_front(std::span<value_type> array)
+    {
+        size_type n = 0;
+        while (n < array.size() && get_front(array[n]))
+            ++n;
+        return n;
+    }
+private:
+    static constexpr auto M = N - 1;
+    static_assert(N > 1 && !(M & N), "ring size must be > 1 and power of 2");
+    static constexpr auto mask(size_type val) { return val & M; }
+    struct slot {
+        auto get() { return &val[0]; }
+        std::atomic<size_type> seq;
+        storage<T, 1> val;
+    };
+private:
+    alignas(cache_line_size) std::atomic<size_type> tail = 0;   // Claimed by producers
+    alignas(cache_line_size) std::atomic<size_type> head = 0;   // Written by consumer
+    alignas(cache_line_size) slot slots[N];
+};
+
+}
+
+#endif
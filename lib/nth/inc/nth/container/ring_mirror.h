@@ -0,0 +1,211 @@
+#ifndef NTH_CONTAINER_RING_MIRROR_H
+#define NTH_CONTAINER_RING_MIRROR_H
+
+#include "nth/util/meta.h"
+#include <bit>
+#include <utility>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace nth {
+
+/**
+ * @brief Byte ring buffer backed by virtual memory mirroring: the same
+ * memfd pages are mapped twice back to back, so any readable or writable
+ * region is always contiguous and there is no need for 'linearize' or
+ * 'array_two'. Indices are unmasked like in nth::ring. Linux host only.
+ * Capacity is rounded up to power of 2 number of bytes, which is at least
+ * one page. Check 'valid' after construction, mapping can fail.
+ */
+struct ring_mirror {
+
+    // ANCHOR Member types
+
+    using value_type                = byte;
+    using size_type                 = size_t;
+    using pointer                   = value_type*;
+    using array_range               = std::span<value_type>;
+    using const_array_range         = std::span<const value_type>;
+
+    // ANCHOR Constructors
+
+    ring_mirror() noexcept = default;
+    explicit ring_mirror(size_type min_capacity) noexcept
+    {
+        auto page = size_type(sysconf(_SC_PAGESIZE));
+        auto cap = std::bit_ceil(std::max(min_capacity, page));
+        auto fd = memfd_create("nth_ring_mirror", MFD_CLOEXEC);
+        if (fd < 0)
+            return;
+        if (ftruncate(fd, cap) == 0) {
+            auto base = mmap(nullptr, cap * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (base != MAP_FAILED) {
+                auto one = mmap(base, cap, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+                auto two = mmap(static_cast<byte*>(base) + cap, cap, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+                if (one == base && two != MAP_FAILED) {
+                    buf = static_cast<byte*>(base);
+                    len = cap;
+                } else {
+                    munmap(base, cap * 2);
+                }
+            }
+        }
+        close(fd);
+    }
+    ring_mirror(const ring_mirror&) = delete;
+    ring_mirror(ring_mirror&& other) noexcept
+        : buf{std::exchange(other.buf, nullptr)}
+        , len{std::exchange(other.len, 0)}
+        , head{std::exchange(other.head, 0)}
+        , tail{std::exchange(other.tail, 0)}
+    {}
+
+    // ANCHOR Desctructor
+
+    ~ring_mirror() noexcept
+    {
+        unmap();
+    }
+
+    // ANCHOR Assingment operator
+
+    ring_mirror& operator=(const ring_mirror&) = delete;
+    ring_mirror& operator=(ring_mirror&& other) noexcept
+    {
+        if (&other != this) {
+            unmap();
+            buf     = std::exchange(other.buf, nullptr);
+            len     = std::exchange(other.len, 0);
+            head    = std::exchange(other.head, 0);
+            tail    = std::exchange(other.tail, 0);
+        }
+        return *this;
+    }
+
+    // ANCHOR Capacity
+
+    bool valid() const noexcept             { return buf; }
+    size_type capacity() const noexcept     { return len; }
+    size_type max_size() const noexcept     { return len; }
+    size_type size() const noexcept         { return tail - head; }
+    bool empty() const noexcept             { return tail == head; }
+    bool full() const noexcept              { return size() == capacity(); }
+    constexpr bool linear() const noexcept  { return true; }
+
+    // ANCHOR Iterators
+
+    pointer begin() noexcept                { return pfront(); }
+    const byte* begin() const noexcept      { return pfront(); }
+    pointer end() noexcept                  { return pfront() + size(); }
+    const byte* end() const noexcept        { return pfront() + size(); }
+
+    // ANCHOR Access
+
+    byte& operator[](size_type i)               { return pfront()[i]; }
+    byte operator[](size_type i) const          { return pfront()[i]; }
+    byte& front()                               { return pfront()[0]; }
+    byte front() const                          { return pfront()[0]; }
+    byte& back()                                { return pfront()[size() - 1]; }
+    byte back() const                           { return pfront()[size() - 1]; }
+    array_range array_one()                     { return {pfront(), size()}; }
+    const_array_range array_one() const         { return {pfront(), size()}; }
+    array_range array_two()                     { return {}; }
+    const_array_range array_two() const         { return {}; }
+    pointer linearize()                         { return empty() ? nullptr : pfront(); }
+
+    // ANCHOR Modifiers
+
+    void clear() noexcept
+    {
+        head = tail = 0;
+    }
+
+    /**
+     * @brief Copy as many bytes as there is free space for.
+     *
+     * @param array Bytes to push
+     * @return Number of bytes pushed
+     */
+    size_type push_back(const_array_range array)
+    {
+        auto n = std::min(array.size(), capacity() - size());
+        std::copy_n(array.data(), n, ptail());
+        tail += n;
+        return n;
+    }
+
+    /**
+     * @brief Copy as many bytes from the front as fit into array and remove them.
+     *
+     * @param array Destination for popped bytes
+     * @return Number of bytes popped
+     */
+    size_type pop_front(array_range array)
+    {
+        auto n = std::min(array.size(), size());
+        std::copy_n(pfront(), n, array.data());
+        head += n;
+        return n;
+    }
+
+    /**
+     * @brief Get all free space as one contiguous region, to be filled
+     * in place (e.g. with 'read') and published with 'commit_back'.
+     *
+     * @param n Maximum number of bytes to reserve
+     * @return Writable region, possibly empty
+     */
+    array_range reserve_back(size_type n = SIZE_MAX)
+    {
+        return {ptail(), std::min(n, capacity() - size())};
+    }
+
+    /**
+     * @brief Append n bytes previously written into region returned by 'reserve_back'.
+     *
+     * @param n Number of bytes to append
+     */
+    void commit_back(size_type n)
+    {
+        assert(capacity() - size() >= n);
+        tail += n;
+    }
+
+    /**
+     * @brief Get all stored bytes as one contiguous region.
+     *
+     * @return Readable region, same as 'array_one'
+     */
+    array_range peek_front()                { return array_one(); }
+    const_array_range peek_front() const    { return array_one(); }
+
+    /**
+     * @brief Remove n bytes from the front, usually after parsing them
+     * in place from 'peek_front'.
+     *
+     * @param n Number of bytes to remove
+     */
+    void consume_front(size_type n)
+    {
+        assert(size() >= n);
+        head += n;
+    }
+private:
+    size_type mask(size_type val) const     { return val & (len - 1); }
+    pointer pfront() const                  { return buf + mask(head); }
+    pointer ptail() const                   { return buf + mask(tail); }
+    void unmap() noexcept
+    {
+        if (buf)
+            munmap(buf, len * 2);
+    }
+private:
+    byte* buf = nullptr;
+    size_type len = 0;
+    size_type head = 0;
+    size_type tail = 0;
+};
+
+}
+
+#endif
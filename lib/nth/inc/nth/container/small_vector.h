@@ -0,0 +1,382 @@
+#ifndef NTH_CONTAINER_SMALL_VECTOR_H
+#define NTH_CONTAINER_SMALL_VECTOR_H
+
+#include "nth/util/storage.h"
+
+namespace nth {
+
+/**
+ * @brief Vector with inline storage for N elements, which spills to heap
+ * when it grows past that and stays there until 'shrink_to_fit'. Growth,
+ * insertion and erasure relocate elements with memmove if they are
+ * trivially relocatable (see nth::is_trivially_relocatable_v), otherwise
+ * with move construction and destruction. Heap is allocated through
+ * std::allocator, so running out of memory terminates.
+ *
+ * @tparam T Type of elements
+ * @tparam N Number of elements stored inline
+ */
+template<class T, size_t N>
+struct small_vector {
+
+    // ANCHOR Member types
+
+    using value_type                = T;
+    using size_type                 = size_t;
+    using difference_type           = ptrdiff_t;
+    using pointer                   = value_type*;
+    using const_pointer             = const value_type*;
+    using reference                 = value_type&;
+    using const_reference           = const value_type&;
+    using universal_reference       = value_type&&;
+    using iterator                  = pointer;
+    using const_iterator            = const_pointer;
+    using reverse_iterator          = std::reverse_iterator<iterator>;
+    using const_reverse_iterator    = std::reverse_iterator<const_iterator>;
+
+    // ANCHOR Constructors
+
+    constexpr small_vector() noexcept : ptr{buf} {}
+    constexpr small_vector(const small_vector& other) : small_vector()
+    {
+        assign(other.begin(), other.end());
+    }
+    constexpr small_vector(small_vector&& other) noexcept : small_vector()
+    {
+        steal(other);
+    }
+    constexpr explicit small_vector(size_type n) : small_vector()
+    {
+        resize(n);
+    }
+    constexpr explicit small_vector(size_type n, const_reference x) : small_vector()
+    {
+        assign(n, x);
+    }
+    template <std::forward_iterator It>
+    constexpr small_vector(It first, It last) : small_vector()
+    {
+        assign(first, last);
+    }
+    constexpr small_vector(std::span<const value_type> array) : small_vector()
+    {
+        assign(array);
+    }
+    constexpr small_vector(std::initializer_list<value_type> ilist) : small_vector()
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    // ANCHOR Destructor
+
+    constexpr ~small_vector() noexcept
+    {
+        clear();
+        release();
+    }
+
+    // ANCHOR Assingment operator
+
+    constexpr small_vector& operator=(const small_vector& other)
+    {
+        if (&other != this)
+            assign(other.begin(), other.end());
+        return *this;
+    }
+    constexpr small_vector& operator=(small_vector&& other) noexcept
+    {
+        if (&other != this) {
+            clear();
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+    constexpr small_vector& operator=(std::span<const value_type> array)
+    {
+        assign(array);
+        return *this;
+    }
+
+    // ANCHOR Assign
+
+    constexpr void assign(size_type n, const_reference x)
+    {
+        clear();
+        insert(begin(), n, x);
+    }
+    template <std::forward_iterator It>
+    constexpr void assign(It first, It last)
+    {
+        clear();
+        insert(begin(), first, last);
+    }
+    constexpr void assign(std::span<const value_type> array)
+    {
+        assign(array.begin(), array.end());
+    }
+
+    // ANCHOR Capacity
+
+    constexpr static size_type inline_capacity()    { return N; }
+    constexpr size_type capacity() const noexcept   { return cap; }
+    constexpr size_type size() const noexcept       { return len; }
+    constexpr bool empty() const noexcept           { return len == 0; }
+    constexpr bool is_inline() const noexcept       { return ptr == buf; }
+
+    /**
+     * @brief Make sure there's space for at least n elements without
+     * further reallocation.
+     *
+     * @param n Number of elements
+     */
+    constexpr void reserve(size_type n)
+    {
+        if (n > cap)
+            reallocate(n);
+    }
+
+    /**
+     * @brief Move elements back to inline storage if they fit there,
+     * or to heap block of exact size otherwise.
+     *
+     */
+    constexpr void shrink_to_fit()
+    {
+        if (!is_inline() && len < cap)
+            reallocate(len);
+    }
+
+    // ANCHOR Iterators
+
+    constexpr iterator begin() noexcept                 { return ptr; }
+    constexpr const_iterator begin() const noexcept     { return ptr; }
+    constexpr const_iterator cbegin() const noexcept    { return begin(); }
+    constexpr iterator end() noexcept                   { return ptr + len; }
+    constexpr const_iterator end() const noexcept       { return ptr + len; }
+    constexpr const_iterator cend() const noexcept      { return end(); }
+
+    constexpr reverse_iterator rbegin() noexcept                { return std::reverse_iterator(end()); }
+    constexpr const_reverse_iterator rbegin() const noexcept    { return std::reverse_iterator(end()); }
+    constexpr const_reverse_iterator crbegin() const noexcept   { return rbegin(); }
+    constexpr reverse_iterator rend() noexcept                  { return std::reverse_iterator(begin()); }
+    constexpr const_reverse_iterator rend() const noexcept      { return std::reverse_iterator(begin()); }
+    constexpr const_reverse_iterator crend() const noexcept     { return rend(); }
+
+    // ANCHOR Access
+
+    constexpr reference operator[](size_type i)             { assert(size() > i); return ptr[i]; }
+    constexpr const_reference operator[](size_type i) const { assert(size() > i); return ptr[i]; }
+    constexpr reference front()                             { assert(!empty()); return ptr[0]; }
+    constexpr const_reference front() const                 { assert(!empty()); return ptr[0]; }
+    constexpr reference back()                              { assert(!empty()); return ptr[len - 1]; }
+    constexpr const_reference back() const                  { assert(!empty()); return ptr[len - 1]; }
+    constexpr pointer data() noexcept                       { return ptr; }
+    constexpr const_pointer data() const noexcept           { return ptr; }
+
+    // ANCHOR Modifiers
+
+    constexpr void resize(size_type n)
+    {
+        impl_resize(n);
+    }
+
+    constexpr void resize(size_type n, const_reference x)
+    {
+        impl_resize(n, x);
+    }
+
+    constexpr void clear() noexcept
+    {
+        dtor_n(begin(), size());
+        len = 0;
+    }
+
+    constexpr void push_back(const_reference x)
+    {
+        emplace_back(x);
+    }
+
+    constexpr void push_back(universal_reference x)
+    {
+        emplace_back(std::move(x));
+    }
+
+    template<class... Args>
+    constexpr reference emplace_back(Args&&... args)
+    {
+        if (len == cap) {
+            value_type tmp(std::forward<Args>(args)...);
+            reallocate(grow(len + 1));
+            return *ctor(end_inc(), std::move(tmp));
+        }
+        return *ctor(end_inc(), std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    constexpr iterator emplace(const_iterator pos, Args&&... args)
+    {
+        assert(begin() <= pos && pos <= end());
+        if (pos == end())
+            return &emplace_back(std::forward<Args>(args)...);
+        value_type tmp(std::forward<Args>(args)...);
+        return ctor(impl_insert_gap(pos - begin(), 1), std::move(tmp));
+    }
+
+    constexpr iterator insert(const_iterator pos, const_reference x)
+    {
+        return emplace(pos, x);
+    }
+
+    constexpr iterator insert(const_iterator pos, universal_reference x)
+    {
+        return emplace(pos, std::move(x));
+    }
+
+    constexpr iterator insert(const_iterator pos, size_type n, const_reference x)
+    {
+        if (!n)
+            return cast_itr(pos);
+        value_type tmp(x);
+        auto ret = impl_insert_gap(pos - begin(), n);
+        ctor_n(ret, n, tmp);
+        return ret;
+    }
+
+    template<std::forward_iterator It>
+    constexpr iterator insert(const_iterator pos, It first, It last)
+    {
+        auto ret = impl_insert_gap(pos - begin(), std::distance(first, last));
+        copy_create_forward(first, last, ret);
+        return ret;
+    }
+
+    constexpr iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    constexpr void pop_back()
+    {
+        assert(empty() == false);
+        dtor(begin() + --len);
+    }
+
+    constexpr iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    constexpr iterator erase(const_iterator first, const_iterator last)
+    {
+        assert(begin() <= first && first <= last && last <= end());
+        auto head = cast_itr(first);
+        auto tail = cast_itr(last);
+        dtor(head, tail);
+        relocate_forward(tail, end(), head);
+        len -= last - first;
+        return head;
+    }
+
+    constexpr void swap(small_vector& other) noexcept
+    {
+        auto tmp    = std::move(other);
+        other       = std::move(*this);
+        *this       = std::move(tmp);
+    }
+private:
+    static constexpr iterator cast_itr(const_iterator itr)
+    {
+        return const_cast<iterator>(itr);
+    }
+
+    constexpr size_type grow(size_type need) const
+    {
+        return std::max(need, 2 * cap);
+    }
+
+    constexpr pointer end_inc()
+    {
+        return ptr + len++;
+    }
+
+    template<class... Args>
+    constexpr void impl_resize(size_type n, Args&&... args)
+    {
+        if (n > len) {
+            reserve(n);
+            ctor_n(end(), n - len, std::forward<Args>(args)...);
+        } else {
+            dtor_n(begin() + n, len - n);
+        }
+        len = n;
+    }
+
+    /**
+     * @brief Open uninitialized gap of n elements at idx, reallocating
+     * if needed, in which case both halves are relocated straight into
+     * the new block.
+     *
+     * @return Pointer to the first element of the gap
+     */
+    constexpr iterator impl_insert_gap(size_type idx, size_type n)
+    {
+        assert(idx <= len);
+        if (len + n > cap) {
+            auto new_cap = grow(len + n);
+            auto p = std::allocator<value_type>{}.allocate(new_cap);
+            relocate_forward(begin(), begin() + idx, p);
+            relocate_forward(begin() + idx, end(), p + idx + n);
+            release();
+            ptr = p;
+            cap = new_cap;
+        } else {
+            relocate_backward(begin() + idx, end(), end() + n);
+        }
+        len += n;
+        return begin() + idx;
+    }
+
+    constexpr void reallocate(size_type n)
+    {
+        assert(n >= len);
+        auto p = n <= N ? pointer(buf) : std::allocator<value_type>{}.allocate(n);
+        if (p == ptr)
+            return;
+        relocate_forward(begin(), end(), p);
+        release();
+        ptr = p;
+        cap = std::max(n, N);
+    }
+
+    constexpr void release()
+    {
+        if (!is_inline())
+            std::allocator<value_type>{}.deallocate(ptr, cap);
+        ptr = buf;
+        cap = N;
+    }
+
+    constexpr void steal(small_vector& other)
+    {
+        if (other.is_inline()) {
+            relocate_forward(other.begin(), other.end(), begin());
+        } else {
+            ptr = other.ptr;
+            cap = other.cap;
+            other.ptr = other.buf;
+            other.cap = N;
+        }
+        len = other.len;
+        other.len = 0;
+    }
+private:
+    pointer ptr;
+    size_type len = 0;
+    size_type cap = N;
+    storage<T, N> buf;
+};
+
+}
+
+#endif
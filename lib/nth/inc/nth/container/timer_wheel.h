@@ -0,0 +1,207 @@
+#ifndef NTH_CONTAINER_TIMER_WHEEL_H
+#define NTH_CONTAINER_TIMER_WHEEL_H
+
+#include "nth/util/bit.h"
+
+namespace nth {
+
+/**
+ * @brief Intrusive hook for nth::timer_wheel, embed it into object with
+ * deadline by inheritance or as a member. Node must not be moved or
+ * destroyed while it is scheduled.
+ *
+ * @tparam Tick Tick type, unsigned integer which is allowed to wrap around
+ */
+template<std::unsigned_integral Tick>
+struct timer_node {
+    constexpr timer_node() = default;
+    constexpr timer_node(const timer_node&) = delete;
+    constexpr timer_node& operator=(const timer_node&) = delete;
+    constexpr bool active() const noexcept  { return next; }
+    constexpr Tick deadline() const noexcept { return when; }
+private:
+    template<std::unsigned_integral, size_t, size_t>
+    friend struct timer_wheel;
+    constexpr void unlink()
+    {
+        next->prev = prev;
+        prev->next = next;
+        next = prev = nullptr;
+    }
+    timer_node* next = nullptr;
+    timer_node* prev = nullptr;
+    Tick when = 0;
+};
+
+/**
+ * @brief Hierarchical hashed timer wheel. Level L has 2^Bits slots,
+ * each covering 2^(Bits * L) ticks, so deadlines up to 2^(Bits * Levels)
+ * ticks ahead are kept without any scanning, farther ones are parked in
+ * the last slot of the top level and re-placed when reached. Schedule
+ * and cancel are O(1), 'advance' moves time forward and fires all
+ * expired nodes of a slot as a batch, cascading nodes of upper level
+ * slot down when lower level wraps. Nodes are intrusive doubly linked
+ * lists, so nothing is allocated.
+ *
+ * @tparam Tick Tick type, unsigned integer which is allowed to wrap around
+ * @tparam Bits Log2 of number of slots per level
+ * @tparam Levels Number of levels
+ */
+template<std::unsigned_integral Tick = uint32_t, size_t Bits = 6, size_t Levels = 4>
+struct timer_wheel {
+
+    static_assert(Bits > 0 && Levels > 0 && Bits * Levels <= bit_size<Tick>, "wheel range must fit in Tick");
+
+    using tick_type = Tick;
+    using node_type = timer_node<Tick>;
+
+    constexpr timer_wheel(tick_type now = 0) : now{now}
+    {
+        for (auto& it : slots)
+            it.next = it.prev = &it;
+    }
+    constexpr timer_wheel(const timer_wheel&) = delete;
+    constexpr timer_wheel& operator=(const timer_wheel&) = delete;
+    constexpr ~timer_wheel()
+    {
+        clear();
+    }
+
+    static constexpr size_t slot_count()            { return size_t(1) << Bits; }
+    static constexpr size_t level_count()           { return Levels; }
+    constexpr tick_type time() const noexcept       { return now; }
+    constexpr size_t size() const noexcept          { return len; }
+    constexpr bool empty() const noexcept           { return len == 0; }
+
+    /**
+     * @brief Schedule node to fire at given tick, reschedule if it's
+     * already active. Deadlines in the past fire on the next tick.
+     *
+     * @param node Node to schedule
+     * @param deadline Absolute tick
+     */
+    constexpr void schedule(node_type& node, tick_type deadline)
+    {
+        if (node.active())
+            cancel(node);
+        node.when = deadline;
+        place(node, tick_type(now + 1));
+        ++len;
+    }
+
+    /**
+     * @brief Schedule node to fire after given number of ticks from now.
+     *
+     * @param node Node to schedule
+     * @param delay Relative number of ticks
+     */
+    constexpr void schedule_in(node_type& node, tick_type delay)
+    {
+        schedule(node, tick_type(now + delay));
+    }
+
+    /**
+     * @brief Remove node from the wheel if it's active.
+     *
+     * @param node Node to cancel
+     * @return True if node was active
+     */
+    constexpr bool cancel(node_type& node)
+    {
+        if (!node.active())
+            return false;
+        node.unlink();
+        --len;
+        return true;
+    }
+
+    /**
+     * @brief Move time forward tick by tick until given time and fire
+     * expired nodes. Each node is unlinked before callback, so it can
+     * be rescheduled from there.
+     *
+     * @param to Absolute tick to advance to
+     * @param fire Callback invoked with node reference for every expired node
+     * @return Number of fired nodes
+     */
+    template<class Fn>
+    constexpr size_t advance(tick_type to, Fn&& fire)
+    {
+        size_t fired = 0;
+        while (now != to) {
+            if (empty()) {
+                now = to;
+                break;
+            }
+            now = tick_type(now + 1);
+            for (size_t lvl = Levels - 1; lvl > 0; --lvl) {
+                if (now & mask(Bits * lvl))
+                    continue;
+                auto& head = slot(lvl, now);
+                while (head.next != &head) {
+                    auto& node = *head.next;
+                    node.unlink();
+                    place(node, now);
+                }
+            }
+            auto& head = slot(0, now);
+            while (head.next != &head) {
+                auto& node = *head.next;
+                node.unlink();
+                --len;
+                ++fired;
+                fire(node);
+            }
+        }
+        return fired;
+    }
+
+    /**
+     * @brief Cancel all nodes.
+     *
+     */
+    constexpr void clear()
+    {
+        for (auto& head : slots)
+            while (head.next != &head)
+                head.next->unlink();
+        len = 0;
+    }
+private:
+    static constexpr tick_type mask(size_t bits)
+    {
+        if (bits >= bit_size<Tick>)
+            return tick_type(-1);
+        return tick_type((tick_type(1) << bits) - 1);
+    }
+    constexpr node_type& slot(size_t lvl, tick_type t)
+    {
+        return slots[(lvl << Bits) + ((t >> (Bits * lvl)) & mask(Bits))];
+    }
+    constexpr void place(node_type& node, tick_type earliest)
+    {
+        using signed_type = std::make_signed_t<tick_type>;
+        auto target = node.when;
+        if (signed_type(target - earliest) < 0)
+            target = earliest;
+        auto delta = tick_type(target - now);
+        size_t lvl = 0;
+        while (lvl < Levels - 1 && delta > mask(Bits * (lvl + 1)))
+            ++lvl;
+        if (delta > mask(Bits * Levels))
+            target = tick_type(now + mask(Bits * Levels));
+        auto& head = slot(lvl, target);
+        node.next = &head;
+        node.prev = head.prev;
+        head.prev->next = &node;
+        head.prev = &node;
+    }
+private:
+    node_type slots[Levels << Bits];
+    tick_type now;
+    size_t len = 0;
+};
+
+}
+
+#endif
@@ -96,13 +96,13 @@ public:
     static constexpr size_t key_size    = nk * sizeof(word);
 public:
     constexpr context() = default;
-    constexpr context(span_i<key_size> key) { init(key); }
+    constexpr context(ispan<key_size> key) { init(key); }
     constexpr ~context()                    { deinit(); }
 public:
-    constexpr void init(span_i<key_size> key);
+    constexpr void init(ispan<key_size> key);
     constexpr void deinit();
-    constexpr void encrypt(span_i<block_size> in, span_o<block_size> out);
-    constexpr void decrypt(span_i<block_size> in, span_o<block_size> out);
+    constexpr void encrypt(ispan<block_size> in, ospan<block_size> out);
+    constexpr void decrypt(ispan<block_size> in, ospan<block_size> out);
 private:
     constexpr void add_round_key(const word* key);
     constexpr void sub_bytes();
@@ -117,7 +117,7 @@ private:
 };
 
 template<type T> 
-constexpr void context<T>::init(span_i<key_size> key)
+constexpr void context<T>::init(ispan<key_size> key)
 {
     size_t i = 0;
 
@@ -147,7 +147,7 @@ constexpr void context<T>::deinit()
 }
 
 template<type T> 
-constexpr void context<T>::encrypt(span_i<block_size> in, span_o<block_size> out)
+constexpr void context<T>::encrypt(ispan<block_size> in, ospan<block_size> out)
 {
     copy(state, in.data(), sizeof(state));
 
@@ -167,7 +167,7 @@ constexpr void context<T>::encrypt(span_i<block_size> in, span_o<block_size> out
 }
 
 template<type T> 
-constexpr void context<T>::decrypt(span_i<block_size> in, span_o<block_size> out)
+constexpr void context<T>::decrypt(ispan<block_size> in, ospan<block_size> out)
 {
     copy(state, in.data(), sizeof(state));
 
@@ -273,9 +273,9 @@ constexpr void context<T>::inv_mix_columns()
 
 }
 
-using aes128 = impl::aes::context<impl::aes::type_128>;
-using aes192 = impl::aes::context<impl::aes::type_192>;
-using aes256 = impl::aes::context<impl::aes::type_256>;
+using aes128 = imp::aes::context<imp::aes::type_128>;
+using aes192 = imp::aes::context<imp::aes::type_192>;
+using aes256 = imp::aes::context<imp::aes::type_256>;
 
 }
 
@@ -1,9 +1,9 @@
-#ifndef SHOC_HASH_MD4_H
-#define SHOC_HASH_MD4_H
+#ifndef NTH_CRYPTO_HASH_MD4_H
+#define NTH_CRYPTO_HASH_MD4_H
 
-#include "shoc/util.h"
+#include "nth/crypto/util.h"
 
-namespace shoc {
+namespace nth {
 
 /**
  * @brief Choose function, used in SHA and MD.
@@ -39,8 +39,8 @@ private:
     static constexpr size_t pad_start = block_size - 8;
 public:
     constexpr void init();
-    constexpr void feed(span_i<> in);
-    constexpr void stop(span_o<hash_size> out);
+    constexpr void feed(ispan<> in);
+    constexpr void stop(ospan<hash_size> out);
     constexpr void wipe();
 private:
     constexpr void pad();
@@ -65,7 +65,7 @@ constexpr void md4::init()
     block_idx = length_high = length_low = 0;
 }
 
-constexpr void md4::feed(span_i<> in)
+constexpr void md4::feed(ispan<> in)
 {
     for (auto it : in) {
         block[block_idx++] = it;
@@ -76,7 +76,7 @@ constexpr void md4::feed(span_i<> in)
     }
 }
 
-constexpr void md4::stop(span_o<hash_size> out)
+constexpr void md4::stop(ospan<hash_size> out)
 {
     pad();
     for (size_t i = 0; i < state_size; ++i)
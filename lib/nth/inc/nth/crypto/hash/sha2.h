@@ -1,10 +1,10 @@
-#ifndef SHOC_HASH_SHA2_H
-#define SHOC_HASH_SHA2_H
+#ifndef NTH_CRYPTO_HASH_SHA2_H
+#define NTH_CRYPTO_HASH_SHA2_H
 
-#include "shoc/hash/md4.h"
+#include "nth/crypto/hash/md4.h"
 
-namespace shoc {
-namespace impl::sha2 {
+namespace nth {
+namespace imp::sha2 {
 
 constexpr uint32_t sigma_0(uint32_t x)  { return ror(x, 7)  ^ ror(x, 18) ^ (x >> 3);  }
 constexpr uint32_t sigma_1(uint32_t x)  { return ror(x, 17) ^ ror(x, 19) ^ (x >> 10); }
@@ -88,8 +88,8 @@ private:
     static constexpr size_t pad_start = block_size - sizeof(word) * 2;
 public:
     constexpr void init();
-    constexpr void feed(span_i<> in);
-    constexpr void stop(span_o<base::hash_size> out);
+    constexpr void feed(ispan<> in);
+    constexpr void stop(ospan<base::hash_size> out);
     constexpr void wipe();
 private:
     constexpr void pad();
@@ -110,18 +110,18 @@ constexpr void context<T>::init()
             state[i] = src[i];
     };
     switch (T) {
-        case type_224: init_hash(impl::sha2::table_224); break;
-        case type_256: init_hash(impl::sha2::table_256); break;
-        case type_384: init_hash(impl::sha2::table_384); break;
-        case type_512: init_hash(impl::sha2::table_512); break;
-        case type_512_224: init_hash(impl::sha2::table_512_224); break;
-        case type_512_256: init_hash(impl::sha2::table_512_256); break;
+        case type_224: init_hash(imp::sha2::table_224); break;
+        case type_256: init_hash(imp::sha2::table_256); break;
+        case type_384: init_hash(imp::sha2::table_384); break;
+        case type_512: init_hash(imp::sha2::table_512); break;
+        case type_512_224: init_hash(imp::sha2::table_512_224); break;
+        case type_512_256: init_hash(imp::sha2::table_512_256); break;
     }
     block_idx = length_high = length_low = 0;
 }
 
 template<type T>
-constexpr void context<T>::feed(span_i<> in)
+constexpr void context<T>::feed(ispan<> in)
 {
     for (auto it : in) {
         block[block_idx++] = it;
@@ -133,13 +133,13 @@ constexpr void context<T>::feed(span_i<> in)
 }
 
 template<type T>
-constexpr void context<T>::stop(span_o<base::hash_size> out)
+constexpr void context<T>::stop(ospan<base::hash_size> out)
 {
     pad();
     // for (size_t i = 0; i < base::hash_size / sizeof(word); ++i)
     //     putbe<word>(state[i], &out[i * sizeof(word)]);
     for (int i = 0, j = -8; i < (int) base::hash_size; ++i, j -= 8)
-        out[i] = state[i / sizeof(word)] >> (j & utl::bit_wrap<word>());
+        out[i] = state[i / sizeof(word)] >> (j & (sizeof(word) * 8 - 1));
     wipe();
 }
 
@@ -231,12 +231,12 @@ constexpr void context<T>::step()
 
 }
 
-using sha224 = impl::sha2::context<impl::sha2::type_224>;
-using sha256 = impl::sha2::context<impl::sha2::type_256>;
-using sha384 = impl::sha2::context<impl::sha2::type_384>;
-using sha512 = impl::sha2::context<impl::sha2::type_512>;
-using sha512_224 = impl::sha2::context<impl::sha2::type_512_224>;
-using sha512_256 = impl::sha2::context<impl::sha2::type_512_256>;
+using sha224 = imp::sha2::context<imp::sha2::type_224>;
+using sha256 = imp::sha2::context<imp::sha2::type_256>;
+using sha384 = imp::sha2::context<imp::sha2::type_384>;
+using sha512 = imp::sha2::context<imp::sha2::type_512>;
+using sha512_224 = imp::sha2::context<imp::sha2::type_512_224>;
+using sha512_256 = imp::sha2::context<imp::sha2::type_512_256>;
 
 }
 
@@ -1,27 +1,27 @@
-#ifndef SHOC_KDF_HKDF_H
-#define SHOC_KDF_HKDF_H
+#ifndef NTH_CRYPTO_KDF_HKDF_H
+#define NTH_CRYPTO_KDF_HKDF_H
 
-#include "shoc/mac/hmac.h"
+#include "nth/crypto/mac/hmac.h"
 
-namespace shoc {
-namespace impl::hkdf {
+namespace nth {
+namespace imp::hkdf {
 template<size_t N>
 inline constexpr byte default_salt[N] = {};
 }
 
 template<class H>
 constexpr bool hkdf(
-    span_o<> okm,
-    span_i<> ikm,
-    span_i<> salt,
-    span_i<> info)
+    ospan<> okm,
+    ispan<> ikm,
+    ispan<> salt,
+    ispan<> info)
 {
     hmac_ctx<H> hmac;
     byte prk[H::hash_size];
     byte t[H::hash_size];
 
     if (salt.empty())
-        salt = impl::hkdf::default_salt<H::hash_size>;
+        salt = imp::hkdf::default_salt<H::hash_size>;
 
     hmac.init(salt);
     hmac.feed(ikm);
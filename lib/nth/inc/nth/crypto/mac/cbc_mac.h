@@ -1,9 +1,9 @@
-#ifndef SHOC_MAC_CBC_MAC_H
-#define SHOC_MAC_CBC_MAC_H
+#ifndef NTH_CRYPTO_MAC_CBC_MAC_H
+#define NTH_CRYPTO_MAC_CBC_MAC_H
 
-#include "shoc/util.h"
+#include "nth/crypto/util.h"
 
-namespace shoc {
+namespace nth {
 
 /**
  * @brief Calculate and save CBC-MAC in running block buffer.
@@ -16,7 +16,7 @@ namespace shoc {
  * @return Last position within block buffer
  */
 template<class E>
-constexpr size_t cbc_mac(E& ciph, span_o<E::block_size> buf, span_i<> aad, size_t pos)
+constexpr size_t cbc_mac(E& ciph, ospan<E::block_size> buf, ispan<> aad, size_t pos)
 {
     for (auto it : aad) {
         buf[pos] ^= it;
@@ -38,7 +38,7 @@ constexpr size_t cbc_mac(E& ciph, span_o<E::block_size> buf, span_i<> aad, size_
  * @param pos Start position within block buffer
  */
 template<class E>
-constexpr void cbc_mac_padded(E& ciph, span_o<E::block_size> buf, span_i<> aad, size_t pos)
+constexpr void cbc_mac_padded(E& ciph, ospan<E::block_size> buf, ispan<> aad, size_t pos)
 {
     if (size_t i = cbc_mac(ciph, buf, aad, pos)) {
         for (; i < E::block_size; ++i)
@@ -1,12 +1,12 @@
-#ifndef SHOC_MAC_HMAC_H
-#define SHOC_MAC_HMAC_H
+#ifndef NTH_CRYPTO_MAC_HMAC_H
+#define NTH_CRYPTO_MAC_HMAC_H
 
-#include "shoc/util.h"
+#include "nth/crypto/util.h"
 
-namespace shoc {
+namespace nth {
 
 template<class H>
-constexpr void hmac(span_i<> key, span_i<> msg, span_o<H::hash_size> digest)
+constexpr void hmac(ispan<> key, ispan<> msg, ospan<H::hash_size> digest)
 {
     H hash;
     byte k_ipad[H::block_size] = {};
@@ -42,9 +42,9 @@ constexpr void hmac(span_i<> key, span_i<> msg, span_o<H::hash_size> digest)
 
 template<class H>
 struct hmac_ctx : consumer<hmac_ctx<H>, H::hash_size> {
-    constexpr void init(span_i<> key);
-    constexpr void feed(span_i<> msg);
-    constexpr void stop(span_o<H::hash_size> out);
+    constexpr void init(ispan<> key);
+    constexpr void feed(ispan<> msg);
+    constexpr void stop(ospan<H::hash_size> out);
     constexpr void wipe();
 private:
     H hash;
@@ -52,7 +52,7 @@ private:
 };
 
 template<class H>
-constexpr void hmac_ctx<H>::init(span_i<> key)
+constexpr void hmac_ctx<H>::init(ispan<> key)
 {
     auto key_ptr = key.data();
     auto key_len = key.size();
@@ -78,13 +78,13 @@ constexpr void hmac_ctx<H>::init(span_i<> key)
 }
 
 template<class H>
-constexpr void hmac_ctx<H>::feed(span_i<> msg)
+constexpr void hmac_ctx<H>::feed(ispan<> msg)
 {
     hash.feed(msg);
 }
 
 template<class H>
-constexpr void hmac_ctx<H>::stop(span_o<H::hash_size> out)
+constexpr void hmac_ctx<H>::stop(ospan<H::hash_size> out)
 {
     hash.stop(out);
     hash.init();
@@ -1,10 +1,10 @@
-#ifndef SHOC_MODE_CCM_H
-#define SHOC_MODE_CCM_H
+#ifndef NTH_CRYPTO_MODE_CCM_H
+#define NTH_CRYPTO_MODE_CCM_H
 
-#include "shoc/mac/cbc_mac.h"
-#include "shoc/mode/ctr.h"
+#include "nth/crypto/mac/cbc_mac.h"
+#include "nth/crypto/mode/ctr.h"
 
-namespace shoc {
+namespace nth {
 
 /**
  * @brief Check if CCM tag length is invalid.
@@ -32,8 +32,8 @@ constexpr bool ccm_tag_length_invalid(size_t len)
  */
 template<class E, size_t L>
 constexpr void ccm_ctr(E& ciph, 
-    span_o<16> a_0, 
-    span_i<15 - L> nonce, 
+    ospan<16> a_0, 
+    ispan<15 - L> nonce, 
     const byte* in, 
           byte* out, size_t len)
 {
@@ -74,10 +74,10 @@ constexpr void ccm_ctr(E& ciph,
  */
 template<class E, size_t L>
 constexpr void ccm_auth(E& ciph, 
-    span_o<16> block,
-    span_i<15 - L> nonce, 
-    span_i<> in,
-    span_i<> aad,
+    ospan<16> block,
+    ispan<15 - L> nonce, 
+    ispan<> in,
+    ispan<> aad,
     size_t tag_len)
 {
     static_assert(L > 1 && L < 9, "invalid length field size");
@@ -128,16 +128,17 @@ constexpr void ccm_auth(E& ciph,
 }
 
 /**
- * @brief Encrypt with block cipher in counter with CBC-MAC mode. 
- * Number of counter-bytes is configurable. All pointers MUST be valid, 
- * except when relevant length is 0. Text length can be arbitrary.
+ * @brief Encrypt with block cipher in counter with CBC-MAC mode using
+ * already initialized cipher, so key schedule can be computed once and 
+ * reused for many messages. Number of counter-bytes is configurable. 
+ * All pointers MUST be valid, except when relevant length is 0. Input 
+ * and output may be the same buffer.
  * 
  * @tparam E Block cipher
  * @tparam L Counter size, default is 2
- * @param key Key
+ * @param ciph Cipher object, must be already initialized
  * @param nonce Nonce, MUST be of length 15 - L
  * @param aad Additional authenticated data
- * @param aad.size() Additional authenticated data length
  * @param tag Output tag
  * @param in Plain text
  * @param out Cipher txt
@@ -146,17 +147,16 @@ constexpr void ccm_auth(E& ciph,
  */
 template<class E, size_t L = 2>
 constexpr bool ccm_encrypt(
-    span_i<E::key_size> key, 
-    span_i<15 - L> nonce,
-    span_i<> aad,
-    span_o<> tag,
+    E& ciph, 
+    ispan<15 - L> nonce,
+    ispan<> aad,
+    ospan<> tag,
     const byte *in, 
           byte *out, size_t len)
 {
     if (ccm_tag_length_invalid(tag.size()))
         return false;
 
-    E ciph {key};
     byte block[16];
 
     ccm_auth<E, L>(ciph, block, nonce, {in, len}, aad, tag.size());
@@ -168,15 +168,46 @@ constexpr bool ccm_encrypt(
 }
 
 /**
- * @brief Decrypt with block cipher in counter with CBC-MAC mode. 
+ * @brief Encrypt with block cipher in counter with CBC-MAC mode. 
  * Number of counter-bytes is configurable. All pointers MUST be valid, 
- * except when relevant length is 0.
+ * except when relevant length is 0. Text length can be arbitrary.
  * 
  * @tparam E Block cipher
  * @tparam L Counter size, default is 2
  * @param key Key
  * @param nonce Nonce, MUST be of length 15 - L
  * @param aad Additional authenticated data
+ * @param aad.size() Additional authenticated data length
+ * @param tag Output tag
+ * @param in Plain text
+ * @param out Cipher txt
+ * @param len Text length
+ * @return true on success, false if tag length is invalid
+ */
+template<class E, size_t L = 2>
+constexpr bool ccm_encrypt(
+    ispan<E::key_size> key, 
+    ispan<15 - L> nonce,
+    ispan<> aad,
+    ospan<> tag,
+    const byte *in, 
+          byte *out, size_t len)
+{
+    E ciph {key};
+    return ccm_encrypt<E, L>(ciph, nonce, aad, tag, in, out, len);
+}
+
+/**
+ * @brief Decrypt with block cipher in counter with CBC-MAC mode using
+ * already initialized cipher. Number of counter-bytes is configurable. 
+ * All pointers MUST be valid, except when relevant length is 0. Input 
+ * and output may be the same buffer.
+ * 
+ * @tparam E Block cipher
+ * @tparam L Counter size, default is 2
+ * @param ciph Cipher object, must be already initialized
+ * @param nonce Nonce, MUST be of length 15 - L
+ * @param aad Additional authenticated data
  * @param tag Input tag
  * @param in Cipher text
  * @param out Plain txt
@@ -185,17 +216,16 @@ constexpr bool ccm_encrypt(
  */
 template<class E, size_t L = 2>
 constexpr bool ccm_decrypt(
-    span_i<E::key_size> key, 
-    span_i<15 - L> nonce,
-    span_i<> aad, 
-    span_i<> tag,
+    E& ciph, 
+    ispan<15 - L> nonce,
+    ispan<> aad, 
+    ispan<> tag,
     const byte *in,
           byte *out, size_t len)
 {
     if (ccm_tag_length_invalid(tag.size()))
         return false;
 
-    E ciph {key};
     byte block[16];
     byte mac[16];
 
@@ -213,6 +243,35 @@ constexpr bool ccm_decrypt(
     return true;
 }
 
+/**
+ * @brief Decrypt with block cipher in counter with CBC-MAC mode. 
+ * Number of counter-bytes is configurable. All pointers MUST be valid, 
+ * except when relevant length is 0.
+ * 
+ * @tparam E Block cipher
+ * @tparam L Counter size, default is 2
+ * @param key Key
+ * @param nonce Nonce, MUST be of length 15 - L
+ * @param aad Additional authenticated data
+ * @param tag Input tag
+ * @param in Cipher text
+ * @param out Plain txt
+ * @param len Text length
+ * @return true on success, false if tag length is invalid or authentication failed
+ */
+template<class E, size_t L = 2>
+constexpr bool ccm_decrypt(
+    ispan<E::key_size> key, 
+    ispan<15 - L> nonce,
+    ispan<> aad, 
+    ispan<> tag,
+    const byte *in,
+          byte *out, size_t len)
+{
+    E ciph {key};
+    return ccm_decrypt<E, L>(ciph, nonce, aad, tag, in, out, len);
+}
+
 }
 
 #endif
\ No newline at end of file
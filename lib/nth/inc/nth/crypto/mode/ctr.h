@@ -1,9 +1,9 @@
-#ifndef SHOC_MODE_CTR_H
-#define SHOC_MODE_CTR_H
+#ifndef NTH_CRYPTO_MODE_CTR_H
+#define NTH_CRYPTO_MODE_CTR_H
 
-#include "shoc/util.h"
+#include "nth/crypto/util.h"
 
-namespace shoc {
+namespace nth {
 
 /**
  * @brief Increment counter bytes in a block, used in block-cipher mode
@@ -33,7 +33,7 @@ constexpr void incc(byte (&block)[B])
  * @param ciph Cipher object, must be already initialized
  */
 template<class E, size_t L = 4>
-constexpr void ctrf(span_i<E::block_size> iv, const byte* in, byte* out, size_t len, E& ciph)
+constexpr void ctrf(ispan<E::block_size> iv, const byte* in, byte* out, size_t len, E& ciph)
 {
     byte buf[E::block_size];
     byte ctr[E::block_size];
@@ -62,7 +62,7 @@ constexpr void ctrf(span_i<E::block_size> iv, const byte* in, byte* out, size_t
  * @param len Text length
  */
 template<class E, size_t L = 4>
-constexpr void ctr_encrypt(span_i<E::key_size> key, span_i<E::block_size> iv, const byte* in, byte* out, size_t len)
+constexpr void ctr_encrypt(ispan<E::key_size> key, ispan<E::block_size> iv, const byte* in, byte* out, size_t len)
 {
     E ciph {key};
     ctrf<E, L>(iv, in, out, len, ciph);   
@@ -81,7 +81,7 @@ constexpr void ctr_encrypt(span_i<E::key_size> key, span_i<E::block_size> iv, co
  * @param len Text length
  */
 template<class E, size_t L = 4>
-constexpr void ctr_decrypt(span_i<E::key_size> key, span_i<E::block_size> iv, const byte* in, byte* out, size_t len)
+constexpr void ctr_decrypt(ispan<E::key_size> key, ispan<E::block_size> iv, const byte* in, byte* out, size_t len)
 {
     ctr_encrypt<E, L>(key, iv, in, out, len);
 }
@@ -44,11 +44,16 @@ struct cobs_pipe_encoder {
 protected:
     constexpr void step(byte b, cobs_write_handler write)
     {
-        if (code == 0xfe || !b) {
+        if (code == 0xfe) {
             code++;
             write(&code, code);
             code = 0;
-            if (!b) return;
+        }
+        if (!b) {
+            code++;
+            write(&code, code);
+            code = 0;
+            return;
         }
         buf[code++] = b;
     }
@@ -58,45 +63,221 @@ protected:
 };
 
 /**
- * @brief Incremental COBS encoder with integrated CRC-32-IEEE 802.3 checksum.
+ * @brief Default CRC engine for COBS: CRC-32-IEEE 802.3 (CRC-32/ISO-HDLC)
+ * with 256 element lookup table.
+ */
+using cobs_crc_default = crc_fast_policy<uint32_t, 0x04c11db7, 0xffffffff, 0xffffffff, true, true>;
+
+/**
+ * @brief Incremental COBS encoder with integrated checksum.
  * 
- * Enhances 'cobs_pipe_encoder' by computing a CRC (polynomial 0x04C11DB7) on 
- * input data, adding integrity check to the frames, which is often a requirement 
- * for serial interfaces. The checksum is COBS-encoded as if it was appended in 
- * little-endian byte order to the input. In theory, must be more efficient than 
- * calculating checksum separatery (1 pass through data instead of 2).
+ * Enhances 'cobs_pipe_encoder' by computing a CRC on input data, adding 
+ * integrity check to the frames, which is often a requirement for serial 
+ * interfaces. The checksum is COBS-encoded as if it was appended in 
+ * little-endian byte order to the input. In theory, must be more efficient 
+ * than calculating checksum separatery (1 pass through data instead of 2). 
+ * CRC engine is chosen at compile time, so that size/speed tradeoff can be 
+ * made per target, e.g. 'crc_nibble_policy' or hardware CRC for firmware.
  *
  * @note Final chunk includes 0x00 delimiter.
+ * 
+ * @tparam Crc CRC policy
  */
-struct cobs_pipe_encoder_with_crc : cobs_pipe_encoder {
+template<crc_policy Crc = cobs_crc_default>
+struct basic_cobs_pipe_encoder_with_crc : cobs_pipe_encoder {
 
     constexpr void reset()
     {
         code = 0;
-        crc = 0xffffffff;
+        crc = Crc::start();
     }
     constexpr void sink(std::span<const byte> in, cobs_write_handler write)
     {
         for (auto b : in) {
             step(b, write);
-            crc = imp::crc_table<uint32_t(0x04c11db7)>[(crc ^ b) & 0xff] ^ (crc >> 8);
+            crc = Crc::feed(crc, {&b, 1});
         }
     }
     constexpr void stop(cobs_write_handler write)
     {
-        crc ^= 0xffffffff;
-        step(byte(crc >>  0), write);
-        step(byte(crc >>  8), write);
-        step(byte(crc >> 16), write);
-        step(byte(crc >> 24), write);
+        crc = Crc::stop(crc);
+        for (size_t i = 0; i < sizeof(crc); ++i)
+            step(byte(crc >> i * 8), write);
         buf[code++] = 0;
         write(&code, code + 1);
         reset();
     }
 private:
-    uint32_t crc = 0xffffffff;
+    typename Crc::value_type crc = Crc::start();
 };
 
+/**
+ * @brief Incremental COBS encoder with integrated CRC-32-IEEE 802.3 
+ * checksum (polynomial 0x04C11DB7), see 'basic_cobs_pipe_encoder_with_crc'.
+ */
+using cobs_pipe_encoder_with_crc = basic_cobs_pipe_encoder_with_crc<>;
+
+namespace imp {
+
+/**
+ * @brief Common COBS and COBS/R encoder with write callback. Input is 
+ * given as a list of fragments (scatter/gather) with optional trailing 
+ * fragment, but is encoded as if it was contiguous. Written chunks point 
+ * directly into input fragments, so there are no per-byte callbacks. 
+ * COBS/R differs only in the last block: if its last data byte is not 
+ * less than the block code, that byte replaces the code, saving one 
+ * byte per frame.
+ * 
+ * @tparam reduced Use COBS/R
+ * @param[in] in List of input fragments to encode.
+ * @param[in] tail Additional fragment to encode after the list, e.g. checksum.
+ * @param[in] write Function to call for writing the encoded bytes.
+ * @return Total number of bytes written, including the COBS control bytes.
+ */
+template<bool reduced>
+constexpr size_t cobs_encode(std::span<const std::span<const byte>> in, std::span<const byte> tail, cobs_write_handler write)
+{
+    auto seg = [&] (size_t i) { return i < in.size() ? in[i] : tail; };
+    auto end = in.size();
+    auto code = byte(1);
+    auto written = size_t(0);
+    auto sidx = size_t(0);
+    auto pdat = seg(0).data();
+    auto write_chunk = [&] (size_t idx, const byte* p) {
+        written += write(&code, 1);
+        for (; sidx != idx; pdat = seg(++sidx).data())
+            written += write(pdat, seg(sidx).data() + seg(sidx).size() - pdat);
+        written += write(pdat, p - pdat);
+    };
+    for (size_t i = 0; i <= end; ++i) {
+        for (const auto& b : seg(i)) {
+            if (code == 0xff) {
+                write_chunk(i, &b);
+                pdat = &b;
+                code = 1;
+            }
+            if (!b) {
+                write_chunk(i, &b);
+                pdat = &b + 1;
+                code = 1;
+            } else {
+                ++code;
+            }
+        }
+    }
+    auto pend = seg(end).data() + seg(end).size();
+    if constexpr (reduced) {
+        auto last = end;
+        while (code > 1 && seg(last).empty())
+            --last;
+        if (code > 1 && seg(last).back() >= code) {
+            end = last;
+            pend = &seg(last).back();
+            code = *pend;
+        }
+    }
+    write_chunk(end, pend);
+    return written;
+}
+
+/**
+ * @brief Common COBS and COBS/R encoder into output buffer. Input is 
+ * given as a list of fragments (scatter/gather) with optional trailing 
+ * fragment, but is encoded as if it was contiguous.
+ * 
+ * @tparam reduced Use COBS/R
+ * @param[in] in List of input fragments to encode.
+ * @param[in] tail Additional fragment to encode after the list, e.g. checksum.
+ * @param[out] out Output span for the encoded data.
+ * @return Size of the encoded output. Zero if output span is too small.
+ */
+template<bool reduced>
+constexpr size_t cobs_encode(std::span<const std::span<const byte>> in, std::span<const byte> tail, std::span<byte> out)
+{
+    auto size = tail.size();
+    for (auto frag : in)
+        size += frag.size();
+    if (out.size() < size + 1) {
+        return 0;
+    }
+    auto code = byte(1);
+    auto plen = out.begin();
+    auto pdat = out.begin() + 1;
+    for (size_t i = 0; i <= in.size(); ++i) {
+        for (auto b : i < in.size() ? in[i] : tail) {
+            if (code == 0xff) {
+                plen[0] = code; 
+                plen = pdat++; 
+                code = 1;
+            }
+            if (!b) {
+                plen[0] = code; 
+                plen = pdat++; 
+                code = 1;
+            }
+            if (pdat + bool(b) > out.end()) {
+                return 0;
+            }
+            if (b) {
+                *pdat++ = b;
+                ++code;
+            }
+        }
+    }
+    if constexpr (reduced) {
+        if (code > 1 && pdat[-1] >= code)
+            code = *--pdat;
+    }
+    *plen = code;
+    return pdat - out.begin();
+}
+
+/**
+ * @brief Common COBS and COBS/R decoder into output buffer.
+ * 
+ * @tparam reduced Use COBS/R
+ * @param[in] in Input span of encoded bytes, without 0x00 delimiter.
+ * @param[out] out Output span for the decoded data.
+ * @return Size of the decoded output. Zero if output span is too small or input is malformed.
+ */
+template<bool reduced>
+constexpr size_t cobs_decode(std::span<const byte> in, std::span<byte> out)
+{
+    auto pin = in.begin();
+    auto out_size = size_t(0);
+
+    while (pin != in.end()) {
+        auto code = *pin++;
+        auto left = size_t(in.end() - pin);
+        auto size = size_t(code - 1);
+        auto tail = size < left && code != 0xff;
+        auto cut = size > left;
+        if (!code) {
+            return 0;
+        }
+        if (cut) {
+            if (!reduced)
+                return 0;
+            size = left;
+        }
+        if (out.size() - out_size < size + tail + cut) {
+            return 0;
+        }
+        for (auto end = pin + size; pin != end; ++pin) {
+            if (!*pin)
+                return 0;
+            out[out_size++] = *pin;
+        }
+        if (cut)
+            out[out_size++] = code;
+        else if (tail)
+            out[out_size++] = 0;
+    }
+    return out_size;
+}
+
+}
+
 /**
  * @brief Encode data using Consistent Overhead Byte Stuffing (COBS) with a custom output function.
  *
@@ -112,23 +293,7 @@ private:
  */
 constexpr size_t cobs_encode(std::span<const byte> in, cobs_write_handler write)
 {
-    auto pdat = in.data();
-    auto code = byte(1);
-    auto written = size_t(0);
-    auto write_chunk = [&] (const byte* p) {
-        written += write(&code, 1);
-        written += write(pdat, p - pdat);
-    };
-    for (const auto& b : in) {
-        if (code == 0xff || !b) {
-            write_chunk(&b);
-            pdat = &b + !b;
-            code = 1;
-        }
-        if (b) ++code;
-    }
-    write_chunk(in.data() + in.size());
-    return written;
+    return imp::cobs_encode<false>({&in, 1}, {}, write);
 }
 
 /**
@@ -145,70 +310,69 @@ constexpr size_t cobs_encode(std::span<const byte> in, cobs_write_handler write)
  */
 constexpr size_t cobs_encode(std::span<const byte> in, std::span<byte> out)
 {
-    if (out.size() < in.size() + 1) {
-        return 0;
-    }
-    auto code = byte(1);
-    auto plen = out.begin();
-    auto pdat = out.begin() + 1;
-    for (auto b : in) {
-        if (code == 0xff || !b) {
-            plen[0] = code; 
-            plen = pdat++; 
-            code = 1;
-        }
-        if (pdat + bool(b) > out.end()) {
-            return 0;
-        }
-        if (b) {
-            *pdat++ = b;
-            ++code;
-        }
-    }
-    *plen = code;
-    return pdat - out.begin();
+    return imp::cobs_encode<false>({&in, 1}, {}, out);
+}
+
+/**
+ * @brief Decode COBS frame directly into an output buffer.
+ *
+ * @param[in] in Input span of encoded bytes, without 0x00 delimiter.
+ * @param[out] out Output span for the decoded data.
+ * @return Size of the decoded output. Zero if output span is too small, input is 
+ * malformed or frame is empty.
+ */
+constexpr size_t cobs_decode(std::span<const byte> in, std::span<byte> out)
+{
+    return imp::cobs_decode<false>(in, out);
 }
 
 /**
- * @brief Encode data with write callback using COBS with an appended CRC-32-IEEE 802.3.
+ * @brief Encode data with write callback using COBS with an appended CRC.
  *
- * Enhances 'cobs_encode' by computing a CRC (polynomial 0x04C11DB7) on input data on-the-fly, 
- * adding integrity check to the frames, which is often a requirement for transmission over 
- * serial interfaces. The checksum is COBS-encoded as if it was appended in little-endian 
- * byte order to the input. In theory, must be more efficient than calculating checksum
- * separatery (1 pass through data instead of 2). @note Does NOT write 0x00 delimiter.
+ * Enhances 'cobs_encode' by computing a CRC (by default CRC-32-IEEE 802.3, polynomial 
+ * 0x04C11DB7) on input data on-the-fly, adding integrity check to the frames, which is 
+ * often a requirement for transmission over serial interfaces. The checksum is COBS-encoded 
+ * as if it was appended in little-endian byte order to the input. In theory, must be more 
+ * efficient than calculating checksum separatery (1 pass through data instead of 2). 
+ * @note Does NOT write 0x00 delimiter.
  *
+ * @tparam Crc CRC policy
  * @param[in] in Input span of bytes to encode.
  * @param[in] write Function to call for writing the encoded bytes.
  * @return Total number of bytes written, including the COBS control bytes.
  */
+template<crc_policy Crc = cobs_crc_default>
 constexpr size_t cobs_encode_with_crc(std::span<const byte> in, cobs_write_handler write)
 {
-    auto crc = uint32_t(0xffffffff);
+    auto crc = Crc::start();
     auto code = byte(1);
     auto ptmp = in.data();
     auto written = size_t(0);
     auto step = [&] (const byte& b) {
-        if (code == 0xff || !b) {
+        if (code == 0xff) {
             written += write(&code, 1);
             written += write(ptmp, &b - ptmp);
-            ptmp = &b + !b;
+            ptmp = &b;
             code = 1;
         }
-        if (b) ++code;
+        if (!b) {
+            written += write(&code, 1);
+            written += write(ptmp, &b - ptmp);
+            ptmp = &b + 1;
+            code = 1;
+        } else {
+            ++code;
+        }
     };
     for (const auto& b : in) {
         step(b);
-        crc = imp::crc_table<uint32_t(0x04c11db7)>[(crc ^ b) & 0xff] ^ (crc >> 8);
+        crc = Crc::feed(crc, {&b, 1});
     }
-    crc ^= 0xffffffff;
+    crc = Crc::stop(crc);
     auto pdat = ptmp;
-    auto cb = std::array {
-        byte(crc >>  0),
-        byte(crc >>  8),
-        byte(crc >> 16),
-        byte(crc >> 24),
-    };
+    auto cb = std::array<byte, sizeof(crc)> {};
+    for (size_t i = 0; i < cb.size(); ++i)
+        cb[i] = byte(crc >> i * 8);
     ptmp = cb.data();
     for (const auto& b : cb) step(b);
     written += write(&code, 1);
@@ -218,29 +382,37 @@ constexpr size_t cobs_encode_with_crc(std::span<const byte> in, cobs_write_handl
 }
 
 /**
- * @brief Encode data into output buffer using COBS with an appended CRC-32-IEEE 802.3.
+ * @brief Encode data into output buffer using COBS with an appended CRC.
  *
- * Enhances 'cobs_encode' by computing a CRC (polynomial 0x04C11DB7) on input data on-the-fly, 
- * adding integrity check to the frames, which is often a requirement for transmission over 
- * serial interfaces. The checksum is COBS-encoded as if it was appended in little-endian 
- * byte order to the input. In theory, must be more efficient than calculating checksum
- * separatery (1 pass through data instead of 2). @note Does NOT write 0x00 delimiter.
+ * Enhances 'cobs_encode' by computing a CRC (by default CRC-32-IEEE 802.3, polynomial 
+ * 0x04C11DB7) on input data on-the-fly, adding integrity check to the frames, which is 
+ * often a requirement for transmission over serial interfaces. The checksum is COBS-encoded 
+ * as if it was appended in little-endian byte order to the input. In theory, must be more 
+ * efficient than calculating checksum separatery (1 pass through data instead of 2). 
+ * @note Does NOT write 0x00 delimiter.
  *
+ * @tparam Crc CRC policy
  * @param[in] in Input span of bytes to encode.
  * @param[out] out Output span for the encoded data.
  * @return Size of the encoded output, including CRC. Zero if output span is too small.
  */
+template<crc_policy Crc = cobs_crc_default>
 constexpr size_t cobs_encode_with_crc(std::span<const byte> in, std::span<byte> out)
 {
-    if (out.size() < in.size() + 5) {
+    auto crc = Crc::start();
+    if (out.size() < in.size() + sizeof(crc) + 1) {
         return 0;
     }
-    auto crc = uint32_t(0xffffffff);
     auto code = byte(1);
     auto plen = out.begin();
     auto pdat = out.begin() + 1;
     auto step = [&] (byte b) {
-        if (code == 0xff || !b) {
+        if (code == 0xff) {
+            plen[0] = code;
+            plen = pdat++;
+            code = 1;
+        }
+        if (!b) {
             plen[0] = code;
             plen = pdat++;
             code = 1;
@@ -255,19 +427,386 @@ constexpr size_t cobs_encode_with_crc(std::span<const byte> in, std::span<byte>
         return true;
     };
     for (auto b : in) {
-        crc = imp::crc_table<uint32_t(0x04c11db7)>[(crc ^ b) & 0xff] ^ (crc >> 8);
+        crc = Crc::feed(crc, {&b, 1});
         if (step(b) == false) return 0;
     }
-    crc ^= 0xffffffff;
-    for (auto b : { byte(crc >>  0), byte(crc >>  8), 
-                    byte(crc >> 16), byte(crc >> 24) }) 
-    {
-        if (step(b) == false) return 0;
+    crc = Crc::stop(crc);
+    for (size_t i = 0; i < sizeof(crc); ++i) {
+        if (step(byte(crc >> i * 8)) == false) return 0;
     }
     *plen = code;
     return pdat - out.begin();
 }
 
+// ANCHOR Vectored
+
+/**
+ * @brief Encode fragmented data as a single COBS frame with a custom output function.
+ *
+ * Scatter/gather version of 'cobs_encode': fragments (e.g. header and payload) 
+ * are encoded as if they were concatenated, but without copying them into a 
+ * staging buffer. Output is written in chunks pointing directly into input 
+ * fragments, so there is no per-byte callback overhead. @note Does NOT write 
+ * 0x00 delimiter.
+ *
+ * @param[in] in List of input fragments to encode.
+ * @param[in] write Function to call for writing the encoded bytes.
+ * @return Total number of bytes written, including the COBS control bytes.
+ */
+constexpr size_t cobs_encode(std::span<const std::span<const byte>> in, cobs_write_handler write)
+{
+    return imp::cobs_encode<false>(in, {}, write);
+}
+
+/**
+ * @brief Encode fragmented data as a single COBS frame directly into an output buffer.
+ * @note Does NOT write 0x00 delimiter.
+ *
+ * @param[in] in List of input fragments to encode.
+ * @param[out] out Output span for the encoded data.
+ * @return Size of the encoded output. Zero if output span is too small.
+ */
+constexpr size_t cobs_encode(std::span<const std::span<const byte>> in, std::span<byte> out)
+{
+    return imp::cobs_encode<false>(in, {}, out);
+}
+
+/**
+ * @brief Encode fragmented data as a single COBS frame with an appended CRC and
+ * a custom output function. CRC is calculated per fragment before encoding, 
+ * which avoids per-byte CRC updates. @note Does NOT write 0x00 delimiter.
+ *
+ * @tparam Crc CRC policy
+ * @param[in] in List of input fragments to encode.
+ * @param[in] write Function to call for writing the encoded bytes.
+ * @return Total number of bytes written, including the COBS control bytes.
+ */
+template<crc_policy Crc = cobs_crc_default>
+constexpr size_t cobs_encode_with_crc(std::span<const std::span<const byte>> in, cobs_write_handler write)
+{
+    auto crc = Crc::start();
+    for (auto frag : in)
+        crc = Crc::feed(crc, frag);
+    crc = Crc::stop(crc);
+    auto cb = std::array<byte, sizeof(crc)> {};
+    for (size_t i = 0; i < cb.size(); ++i)
+        cb[i] = byte(crc >> i * 8);
+    return imp::cobs_encode<false>(in, cb, write);
+}
+
+/**
+ * @brief Encode fragmented data as a single COBS frame with an appended CRC 
+ * directly into an output buffer. @note Does NOT write 0x00 delimiter.
+ *
+ * @tparam Crc CRC policy
+ * @param[in] in List of input fragments to encode.
+ * @param[out] out Output span for the encoded data.
+ * @return Size of the encoded output, including CRC. Zero if output span is too small.
+ */
+template<crc_policy Crc = cobs_crc_default>
+constexpr size_t cobs_encode_with_crc(std::span<const std::span<const byte>> in, std::span<byte> out)
+{
+    auto crc = Crc::start();
+    for (auto frag : in)
+        crc = Crc::feed(crc, frag);
+    crc = Crc::stop(crc);
+    auto cb = std::array<byte, sizeof(crc)> {};
+    for (size_t i = 0; i < cb.size(); ++i)
+        cb[i] = byte(crc >> i * 8);
+    return imp::cobs_encode<false>(in, cb, out);
+}
+
+// ANCHOR COBS/R
+
+/**
+ * @brief Incremental COBS/R encoder of byte streams with internal buffering.
+ * 
+ * Same as 'cobs_pipe_encoder', but uses reduced COBS variant: if the last 
+ * byte of the frame is not less than the code of the last block, it takes 
+ * place of that code. For short frames it usually saves 1 byte per frame.
+ * 
+ * @note Final chunk includes 0x00 delimiter.
+ */
+struct cobsr_pipe_encoder : cobs_pipe_encoder {
+
+    constexpr void stop(cobs_write_handler write)
+    {
+        auto size = code;
+        if (size && buf[size - 1] >= size + 1) {
+            code = buf[--size];
+        } else {
+            code = size + 1;
+        }
+        buf[size] = 0;
+        write(&code, size + 2);
+        reset();
+    }
+};
+
+/**
+ * @brief Encode data using reduced COBS (COBS/R) with a custom output function.
+ * @note Does NOT write 0x00 delimiter.
+ *
+ * @param[in] in Input span of bytes to encode.
+ * @param[in] write Function to call for writing the encoded bytes.
+ * @return Total number of bytes written, including the COBS control bytes.
+ */
+constexpr size_t cobsr_encode(std::span<const byte> in, cobs_write_handler write)
+{
+    return imp::cobs_encode<true>({&in, 1}, {}, write);
+}
+
+/**
+ * @brief Encode data using reduced COBS (COBS/R) directly into an output buffer.
+ * @note Does NOT write 0x00 delimiter.
+ *
+ * @param[in] in Input span of bytes to encode.
+ * @param[out] out Output span for the encoded data.
+ * @return Size of the encoded output. Zero if output span is too small.
+ */
+constexpr size_t cobsr_encode(std::span<const byte> in, std::span<byte> out)
+{
+    return imp::cobs_encode<true>({&in, 1}, {}, out);
+}
+
+/**
+ * @brief Encode fragmented data as a single COBS/R frame with a custom output function.
+ * @note Does NOT write 0x00 delimiter.
+ *
+ * @param[in] in List of input fragments to encode.
+ * @param[in] write Function to call for writing the encoded bytes.
+ * @return Total number of bytes written, including the COBS control bytes.
+ */
+constexpr size_t cobsr_encode(std::span<const std::span<const byte>> in, cobs_write_handler write)
+{
+    return imp::cobs_encode<true>(in, {}, write);
+}
+
+/**
+ * @brief Encode fragmented data as a single COBS/R frame directly into an output buffer.
+ * @note Does NOT write 0x00 delimiter.
+ *
+ * @param[in] in List of input fragments to encode.
+ * @param[out] out Output span for the encoded data.
+ * @return Size of the encoded output. Zero if output span is too small.
+ */
+constexpr size_t cobsr_encode(std::span<const std::span<const byte>> in, std::span<byte> out)
+{
+    return imp::cobs_encode<true>(in, {}, out);
+}
+
+/**
+ * @brief Decode COBS/R frame directly into an output buffer.
+ *
+ * @param[in] in Input span of encoded bytes, without 0x00 delimiter.
+ * @param[out] out Output span for the decoded data.
+ * @return Size of the decoded output. Zero if output span is too small, input is 
+ * malformed or frame is empty.
+ */
+constexpr size_t cobsr_decode(std::span<const byte> in, std::span<byte> out)
+{
+    return imp::cobs_decode<true>(in, out);
+}
+
+// ANCHOR COBS/ZPE
+
+namespace imp {
+
+/**
+ * @brief COBS/ZPE (zero pair elimination) block codes:
+ * [0x01 - 0xdf] (code - 1) data bytes followed by single zero;
+ * [0xe0]        223 data bytes without zero;
+ * [0xe1 - 0xff] (code - 0xe1) data bytes followed by pair of zeros.
+ * As in COBS, the frame is encoded as if it had additional trailing 
+ * zero, which isn't transmitted and is removed by decoder.
+ */
+inline constexpr byte cobs_zpe_full     = 0xe0;
+inline constexpr byte cobs_zpe_pair     = 0xe1;
+inline constexpr size_t cobs_zpe_run    = cobs_zpe_full - 1;
+inline constexpr size_t cobs_zpe_run_2  = 0xff - cobs_zpe_pair;
+
+}
+
+/**
+ * @brief Incremental COBS/ZPE encoder of byte streams with internal buffering.
+ * 
+ * Encodes pairs of zeros, which are common in short binary records, using 
+ * a single code byte. Since pair can be detected only after the next byte 
+ * arrives, block ending with zero is held until then. 
+ * 
+ * @note Final chunk includes 0x00 delimiter.
+ */
+struct cobs_zpe_pipe_encoder : cobs_pipe_encoder {
+
+    constexpr void reset()
+    {
+        code = 0;
+        zero = false;
+        full = false;
+    }
+    constexpr void sink(std::span<const byte> in, cobs_write_handler write)
+    {
+        for (auto b : in) step(b, write);
+    }
+    constexpr void stop(cobs_write_handler write)
+    {
+        if (zero) {
+            if (code <= imp::cobs_zpe_run_2) {
+                flush(imp::cobs_zpe_pair + code, write, true);
+                reset();
+                return;
+            }
+            flush(code + 1, write);
+        } else if (full) {
+            buf[0] = 0;
+            write(buf, 1);
+            reset();
+            return;
+        }
+        flush(code + 1, write, true);
+        reset();
+    }
+private:
+    constexpr void flush(byte c, cobs_write_handler write, bool last = false)
+    {
+        auto size = code;
+        buf[size] = 0;
+        code = c;
+        write(&code, size + 1 + last);
+        code = 0;
+    }
+    constexpr void step(byte b, cobs_write_handler write)
+    {
+        full = false;
+        if (zero) {
+            zero = false;
+            if (!b && code <= imp::cobs_zpe_run_2) {
+                flush(imp::cobs_zpe_pair + code, write);
+                return;
+            }
+            flush(code + 1, write);
+        }
+        if (!b) {
+            zero = true;
+            return;
+        }
+        buf[code++] = b;
+        if (code == imp::cobs_zpe_run) {
+            flush(imp::cobs_zpe_full, write);
+            full = true;
+        }
+    }
+private:
+    bool zero = false;
+    bool full = false;
+};
+
+/**
+ * @brief Encode data using COBS with zero pair elimination (COBS/ZPE) directly 
+ * into an output buffer. @note Does NOT write 0x00 delimiter.
+ *
+ * @param[in] in Input span of bytes to encode.
+ * @param[out] out Output span for the encoded data.
+ * @return Size of the encoded output. Zero if output span is too small.
+ */
+constexpr size_t cobs_zpe_encode(std::span<const byte> in, std::span<byte> out)
+{
+    if (out.empty()) {
+        return 0;
+    }
+    auto size = size_t(0);
+    auto zero = false;
+    auto plen = out.begin();
+    auto pdat = out.begin() + 1;
+    auto next = [&] (byte code) {
+        *plen = code;
+        plen = pdat++;
+        size = 0;
+        return pdat <= out.end();
+    };
+    for (auto b : in) {
+        if (size == imp::cobs_zpe_run && !next(imp::cobs_zpe_full)) {
+            return 0;
+        }
+        if (zero) {
+            zero = false;
+            if (!b && size <= imp::cobs_zpe_run_2) {
+                if (!next(imp::cobs_zpe_pair + size))
+                    return 0;
+                continue;
+            }
+            if (!next(size + 1)) {
+                return 0;
+            }
+        }
+        if (!b) {
+            zero = true;
+            continue;
+        }
+        if (pdat == out.end()) {
+            return 0;
+        }
+        *pdat++ = b;
+        ++size;
+    }
+    if (zero) {
+        if (size <= imp::cobs_zpe_run_2) {
+            *plen = imp::cobs_zpe_pair + size;
+            return pdat - out.begin();
+        }
+        if (!next(size + 1)) {
+            return 0;
+        }
+    }
+    *plen = size == imp::cobs_zpe_run ? imp::cobs_zpe_full : size + 1;
+    return pdat - out.begin();
+}
+
+/**
+ * @brief Decode COBS/ZPE frame directly into an output buffer.
+ *
+ * @param[in] in Input span of encoded bytes, without 0x00 delimiter.
+ * @param[out] out Output span for the decoded data.
+ * @return Size of the decoded output. Zero if output span is too small, input is 
+ * malformed or frame is empty.
+ */
+constexpr size_t cobs_zpe_decode(std::span<const byte> in, std::span<byte> out)
+{
+    auto pin = in.begin();
+    auto out_size = size_t(0);
+
+    while (pin != in.end()) {
+        auto code = *pin++;
+        auto size = size_t(code - 1);
+        auto tail = size_t(1);
+        if (code >= imp::cobs_zpe_pair) {
+            size = code - imp::cobs_zpe_pair;
+            tail = 2;
+        } else if (code == imp::cobs_zpe_full) {
+            tail = 0;
+        } else if (!code) {
+            return 0;
+        }
+        if (size > size_t(in.end() - pin)) {
+            return 0;
+        }
+        if (pin + size == in.end() && tail) {
+            --tail;
+        }
+        if (out.size() - out_size < size + tail) {
+            return 0;
+        }
+        for (auto end = pin + size; pin != end; ++pin) {
+            if (!*pin)
+                return 0;
+            out[out_size++] = *pin;
+        }
+        while (tail--)
+            out[out_size++] = 0;
+    }
+    return out_size;
+}
+
 // ANCHOR WIP
 
 using cobs_decoder_handler = void(const byte* data, size_t size, size_t left);
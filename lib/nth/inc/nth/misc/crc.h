@@ -32,6 +32,117 @@ inline constexpr auto crc_table = [] ()
     return table;
 }();
 
+/**
+ * @brief Lookup table with 16 elements for reciprocal CRC, processing 
+ * one nibble at a time. Same as 'crc_table' but for 4-bit dividends,
+ * i.e. every 16-th element of it.
+ * 
+ * @param poly Polynomial
+ */
+template<std::integral auto poly>
+inline constexpr auto crc_table_nibble = [] () 
+{
+    using T = decltype(poly);
+    std::array<T, 16> table = {};
+    for (int dividend = 0; dividend < 16; ++dividend) {
+        T remainder = dividend;
+        for (int i = 4; i; --i) {
+            if (remainder & 1)
+                remainder = (remainder >> 1) ^ bitswap(poly);
+            else
+                remainder = (remainder >> 1);
+        }
+        table[dividend] = remainder;
+    }
+    return table;
+}();
+
+/**
+ * @brief Pair of lookup tables with 16 elements each for reciprocal CRC,
+ * processing one byte at a time. Since table is linear, entry for byte 
+ * equals XOR of entries for its low and high nibbles, so 'crc_table' 
+ * can be reduced to 'crc_table[0x0..0xf]' and 'crc_table[0x00..0xf0]'.
+ * 
+ * @param poly Polynomial
+ */
+template<std::integral auto poly>
+inline constexpr auto crc_table_hybrid = [] () 
+{
+    using T = decltype(poly);
+    std::array<std::array<T, 16>, 2> table = {};
+    for (int i = 0; i < 16; ++i) {
+        table[0][i] = crc_table<poly>[i];
+        table[1][i] = crc_table<poly>[i << 4];
+    }
+    return table;
+}();
+
+/**
+ * @brief Multiply two polynomials modulo CRC polynomial. Both operands
+ * and result are in normal (non-reflected) bit order, i.e. MSB holds 
+ * coefficient of x^(bits - 1).
+ * 
+ * @tparam T Integer type
+ * @tparam poly Polynomial
+ * @param a First multiplier
+ * @param b Second multiplier
+ * @return a * b mod poly
+ */
+template<std::integral T, T poly>
+constexpr T crc_mulmod(T a, T b)
+{
+    constexpr T topbit = T(1) << (sizeof(T) * 8 - 1);
+
+    T ret = 0;
+    for (T m = topbit; m; m >>= 1) {
+        ret = ret & topbit ? (ret << 1) ^ poly : (ret << 1);
+        if (a & m)
+            ret ^= b;
+    }
+    return ret;
+}
+
+/**
+ * @brief Table of x^(2^k) mod poly for each bit of size_t, plus 3 more
+ * for bytes to bits conversion in 'crc_x8n'. Used to compute x^n mod 
+ * poly in O(log(n)) multiplications, which in turn shifts CRC register 
+ * by n zero bits without processing them.
+ * 
+ * @param poly Polynomial
+ */
+template<std::integral auto poly>
+inline constexpr auto crc_x2n_table = [] () 
+{
+    using T = decltype(poly);
+    std::array<T, sizeof(size_t) * 8 + 3> table = {};
+    T p = 2; // x^1
+    for (auto& t : table) {
+        t = p;
+        p = crc_mulmod<T, poly>(p, p);
+    }
+    return table;
+}();
+
+/**
+ * @brief Calculate x^(8 * n) mod poly, i.e. operator which advances 
+ * CRC register over n zero bytes.
+ * 
+ * @tparam T Integer type
+ * @tparam poly Polynomial
+ * @param n Number of bytes
+ * @return x^(8 * n) mod poly
+ */
+template<std::integral T, T poly>
+constexpr T crc_x8n(size_t n)
+{
+    T ret = 1; // x^0
+    for (size_t k = 3; n; n >>= 1, ++k) {
+        if (n & 1)
+            ret = crc_mulmod<T, poly>(crc_x2n_table<poly>[k], ret);
+    }
+    return ret;
+}
+
 }
 
 // ANCHOR Slow
@@ -189,6 +300,479 @@ constexpr T crc_fast(std::span<const byte> data)
     return crc_fast_stop<T, xorout, refout>(val);
 }
 
+// ANCHOR Nibble
+
+/**
+ * @brief Get prepared (reflected) initial value.
+ * 
+ * @tparam T Integer type
+ * @tparam init Initial value
+ * @return Reflected initial value
+ */
+template<std::integral T, T init>
+constexpr T crc_nibble_init()
+{
+    return bitswap(init);
+}
+
+/**
+ * @brief Calculate running CRC using 16 element lookup table, 
+ * starting with a given value.
+ * 
+ * @tparam T Integer type
+ * @tparam poly Polynomial
+ * @tparam refin Reflect input bytes
+ * @param val Running CRC value
+ * @param data Data to calculate CRC on
+ * @return CRC value
+ */
+template<std::integral T, T poly, bool refin>
+constexpr T crc_nibble_feed(T val, std::span<const byte> data)
+{
+    for (auto b : data) {
+        if constexpr (!refin)
+            b = bitswap(b);
+        val ^= b;
+        val = imp::crc_table_nibble<poly>[val & 0xf] ^ (val >> 4);
+        val = imp::crc_table_nibble<poly>[val & 0xf] ^ (val >> 4);
+    }
+    return val;
+}
+
+/**
+ * @brief Finalize CRC result by optional reflection and xoring. 
+ * 
+ * @tparam T Integer type
+ * @tparam xorout Value to XOR with
+ * @tparam refout Reflection flag
+ * @param val Current value
+ * @return Final CRC value
+ */
+template<std::integral T, T xorout, bool refout>
+constexpr T crc_nibble_stop(T val)
+{
+    return crc_fast_stop<T, xorout, refout>(val);
+}
+
+/**
+ * @brief Calculate CRC using 16 element lookup table. Takes 2 
+ * lookups per byte, but requires only 16 x sizeof(T) bytes,
+ * middle ground between slow and fast versions.
+ * 
+ * @tparam T Integer type
+ * @tparam poly Polynomial
+ * @tparam init Initial value
+ * @tparam xorout Value to XOR with final result
+ * @tparam refin Reflect input bytes
+ * @tparam refout Reflect output value
+ * @param data Data to calculate CRC on
+ * @return CRC value
+ */
+template<std::integral T, T poly, T init, T xorout, bool refin, bool refout>
+constexpr T crc_nibble(std::span<const byte> data)
+{
+    auto val = crc_nibble_feed<T, poly, refin>(bitswap(init), data);
+    return crc_nibble_stop<T, xorout, refout>(val);
+}
+
+// ANCHOR Hybrid
+
+/**
+ * @brief Get prepared (reflected) initial value.
+ * 
+ * @tparam T Integer type
+ * @tparam init Initial value
+ * @return Reflected initial value
+ */
+template<std::integral T, T init>
+constexpr T crc_hybrid_init()
+{
+    return bitswap(init);
+}
+
+/**
+ * @brief Calculate running CRC using pair of 16 element lookup 
+ * tables, starting with a given value.
+ * 
+ * @tparam T Integer type
+ * @tparam poly Polynomial
+ * @tparam refin Reflect input bytes
+ * @param val Running CRC value
+ * @param data Data to calculate CRC on
+ * @return CRC value
+ */
+template<std::integral T, T poly, bool refin>
+constexpr T crc_hybrid_feed(T val, std::span<const byte> data)
+{
+    for (auto b : data) {
+        if constexpr (!refin)
+            b = bitswap(b);
+        b ^= val;
+        val = imp::crc_table_hybrid<poly>[0][b & 0xf] ^ 
+              imp::crc_table_hybrid<poly>[1][b >> 4] ^ (val >> 8);
+    }
+    return val;
+}
+
+/**
+ * @brief Finalize CRC result by optional reflection and xoring. 
+ * 
+ * @tparam T Integer type
+ * @tparam xorout Value to XOR with
+ * @tparam refout Reflection flag
+ * @param val Current value
+ * @return Final CRC value
+ */
+template<std::integral T, T xorout, bool refout>
+constexpr T crc_hybrid_stop(T val)
+{
+    return crc_fast_stop<T, xorout, refout>(val);
+}
+
+/**
+ * @brief Calculate CRC using pair of 16 element lookup tables. 
+ * Both lookups per byte are independent, so it's close to fast 
+ * version in speed, but requires only 32 x sizeof(T) bytes.
+ * 
+ * @tparam T Integer type
+ * @tparam poly Polynomial
+ * @tparam init Initial value
+ * @tparam xorout Value to XOR with final result
+ * @tparam refin Reflect input bytes
+ * @tparam refout Reflect output value
+ * @param data Data to calculate CRC on
+ * @return CRC value
+ */
+template<std::integral T, T poly, T init, T xorout, bool refin, bool refout>
+constexpr T crc_hybrid(std::span<const byte> data)
+{
+    auto val = crc_hybrid_feed<T, poly, refin>(bitswap(init), data);
+    return crc_hybrid_stop<T, xorout, refout>(val);
+}
+
+// ANCHOR Policy
+
+/**
+ * @brief Interface of CRC engine, which allows to choose size/speed 
+ * tradeoff at compile time in algorithms which need CRC internally,
+ * e.g. COBS encoder. Custom engines, like hardware CRC peripheral 
+ * wrappers, must follow it too. Value returned by start() and passed 
+ * to feed() and stop() is opaque and may have any bit order.
+ * 
+ * @tparam C Policy type
+ */
+template<class C>
+concept crc_policy = requires (typename C::value_type val, std::span<const byte> data) {
+    { C::start() }          -> std::same_as<typename C::value_type>;
+    { C::feed(val, data) }  -> std::same_as<typename C::value_type>;
+    { C::stop(val) }        -> std::same_as<typename C::value_type>;
+};
+
+/**
+ * @brief CRC policy without lookup table.
+ */
+template<std::integral T, T poly, T init, T xorout, bool refin, bool refout>
+struct crc_slow_policy {
+    using value_type = T;
+    static constexpr T start()                                  { return crc_slow_init<T, init>(); }
+    static constexpr T feed(T val, std::span<const byte> data)  { return crc_slow_feed<T, poly, refin>(val, data); }
+    static constexpr T stop(T val)                              { return crc_slow_stop<T, xorout, refout>(val); }
+};
+
+/**
+ * @brief CRC policy with 16 element lookup table.
+ */
+template<std::integral T, T poly, T init, T xorout, bool refin, bool refout>
+struct crc_nibble_policy {
+    using value_type = T;
+    static constexpr T start()                                  { return crc_nibble_init<T, init>(); }
+    static constexpr T feed(T val, std::span<const byte> data)  { return crc_nibble_feed<T, poly, refin>(val, data); }
+    static constexpr T stop(T val)                              { return crc_nibble_stop<T, xorout, refout>(val); }
+};
+
+/**
+ * @brief CRC policy with pair of 16 element lookup tables.
+ */
+template<std::integral T, T poly, T init, T xorout, bool refin, bool refout>
+struct crc_hybrid_policy {
+    using value_type = T;
+    static constexpr T start()                                  { return crc_hybrid_init<T, init>(); }
+    static constexpr T feed(T val, std::span<const byte> data)  { return crc_hybrid_feed<T, poly, refin>(val, data); }
+    static constexpr T stop(T val)                              { return crc_hybrid_stop<T, xorout, refout>(val); }
+};
+
+/**
+ * @brief CRC policy with 256 element lookup table.
+ */
+template<std::integral T, T poly, T init, T xorout, bool refin, bool refout>
+struct crc_fast_policy {
+    using value_type = T;
+    static constexpr T start()                                  { return crc_fast_init<T, init>(); }
+    static constexpr T feed(T val, std::span<const byte> data)  { return crc_fast_feed<T, poly, refin>(val, data); }
+    static constexpr T stop(T val)                              { return crc_fast_stop<T, xorout, refout>(val); }
+};
+
+// ANCHOR Preset
+
+namespace imp {
+
+/**
+ * @brief Lookup table with 256 elements for non-reflected CRC, MSB-to-LSB 
+ * with left shift. Complement of 'crc_table', so that CRC with non-reflected 
+ * input can be calculated without reflecting every input byte.
+ * 
+ * @param poly Polynomial
+ */
+template<std::integral auto poly>
+inline constexpr auto crc_table_normal = [] () 
+{
+    using T = decltype(poly);
+    constexpr T topbit = T(1) << (sizeof(T) * 8 - 1);
+    std::array<T, 256> table = {};
+    for (int dividend = 0; dividend < 256; ++dividend) {
+        T remainder = T(dividend) << (sizeof(T) * 8 - 8);
+        for (int i = 8; i; --i) {
+            if (remainder & topbit)
+                remainder = (remainder << 1) ^ poly;
+            else
+                remainder = (remainder << 1);
+        }
+        table[dividend] = remainder;
+    }
+    return table;
+}();
+
+}
+
+/**
+ * @brief Full CRC model description in terms of Rocksoft parameters,
+ * can be used as template argument to select algorithm by name.
+ * 
+ * @tparam T Integer type
+ */
+template<std::integral T>
+struct crc_preset {
+    using value_type = T;
+    T poly;         // Polynomial
+    T init;         // Initial value
+    T xorout;       // Value to XOR with final result
+    bool refin;     // Reflect input bytes
+    bool refout;    // Reflect output value
+    T check;        // CRC of ASCII "123456789"
+};
+
+/**
+ * @brief CRC policy for a given preset with 256 element lookup table 
+ * in preset's own bit order. Unlike 'crc_fast_policy', running value 
+ * is reflected only when input is reflected, so no per-byte bitswap 
+ * is needed for non-reflected presets.
+ * 
+ * @tparam P CRC preset
+ */
+template<crc_preset P>
+struct crc_preset_policy {
+    using value_type = typename decltype(P)::value_type;
+    using T = value_type;
+
+    static constexpr T start()
+    {
+        if constexpr (P.refin)
+            return bitswap(P.init);
+        else
+            return P.init;
+    }
+    static constexpr T feed(T val, std::span<const byte> data)
+    {
+        if constexpr (P.refin) {
+            for (auto b : data)
+                val = imp::crc_table<P.poly>[(val ^ b) & 0xff] ^ T(val >> 8);
+        } else {
+            constexpr auto shift = sizeof(T) * 8 - 8;
+            for (auto b : data)
+                val = imp::crc_table_normal<P.poly>[(val >> shift) ^ b] ^ T(val << 8);
+        }
+        return val;
+    }
+    static constexpr T stop(T val)
+    {
+        if constexpr (P.refin != P.refout)
+            val = bitswap(val);
+        return val ^ P.xorout;
+    }
+};
+
+/**
+ * @brief Streaming CRC calculator for a given preset. Data can be fed
+ * in arbitrary pieces, final value is available at any moment.
+ * 
+ * @tparam P CRC preset
+ */
+template<crc_preset P>
+struct crc_state {
+
+    using policy = crc_preset_policy<P>;
+    using value_type = typename policy::value_type;
+
+    constexpr void reset()
+    {
+        val = policy::start();
+    }
+    constexpr crc_state& update(std::span<const byte> data)
+    {
+        val = policy::feed(val, data);
+        return *this;
+    }
+    constexpr value_type value() const
+    {
+        return policy::stop(val);
+    }
+private:
+    value_type val = policy::start();
+};
+
+/**
+ * @brief Calculate CRC for a given preset, e.g. 'crc<crc32>(data)'.
+ * 
+ * @tparam P CRC preset
+ * @param data Data to calculate CRC on
+ * @return CRC value
+ */
+template<crc_preset P>
+constexpr auto crc(std::span<const byte> data)
+{
+    using policy = crc_preset_policy<P>;
+    return policy::stop(policy::feed(policy::start(), data));
+}
+
+// ANCHOR Catalogue
+
+// Parameters and check values from https://reveng.sourceforge.io/crc-catalogue/all.htm
+
+inline constexpr crc_preset<uint8_t>  crc8_autosar            = { 0x2f, 0xff, 0xff, false, false, 0xdf }; // CRC-8/AUTOSAR
+inline constexpr crc_preset<uint8_t>  crc8_bluetooth          = { 0xa7, 0x00, 0x00, true,  true,  0x26 }; // CRC-8/BLUETOOTH
+inline constexpr crc_preset<uint8_t>  crc8_cdma2000           = { 0x9b, 0xff, 0x00, false, false, 0xda }; // CRC-8/CDMA2000
+inline constexpr crc_preset<uint8_t>  crc8_darc               = { 0x39, 0x00, 0x00, true,  true,  0x15 }; // CRC-8/DARC
+inline constexpr crc_preset<uint8_t>  crc8_dvb_s2             = { 0xd5, 0x00, 0x00, false, false, 0xbc }; // CRC-8/DVB-S2
+inline constexpr crc_preset<uint8_t>  crc8_gsm_a              = { 0x1d, 0x00, 0x00, false, false, 0x37 }; // CRC-8/GSM-A
+inline constexpr crc_preset<uint8_t>  crc8_gsm_b              = { 0x49, 0x00, 0xff, false, false, 0x94 }; // CRC-8/GSM-B
+inline constexpr crc_preset<uint8_t>  crc8_hitag              = { 0x1d, 0xff, 0x00, false, false, 0xb4 }; // CRC-8/HITAG
+inline constexpr crc_preset<uint8_t>  crc8_i_432_1            = { 0x07, 0x00, 0x55, false, false, 0xa1 }; // CRC-8/I-432-1
+inline constexpr crc_preset<uint8_t>  crc8_i_code             = { 0x1d, 0xfd, 0x00, false, false, 0x7e }; // CRC-8/I-CODE
+inline constexpr crc_preset<uint8_t>  crc8_lte                = { 0x9b, 0x00, 0x00, false, false, 0xea }; // CRC-8/LTE
+inline constexpr crc_preset<uint8_t>  crc8_maxim_dow          = { 0x31, 0x00, 0x00, true,  true,  0xa1 }; // CRC-8/MAXIM-DOW
+inline constexpr crc_preset<uint8_t>  crc8_mifare_mad         = { 0x1d, 0xc7, 0x00, false, false, 0x99 }; // CRC-8/MIFARE-MAD
+inline constexpr crc_preset<uint8_t>  crc8_nrsc_5             = { 0x31, 0xff, 0x00, false, false, 0xf7 }; // CRC-8/NRSC-5
+inline constexpr crc_preset<uint8_t>  crc8_opensafety         = { 0x2f, 0x00, 0x00, false, false, 0x3e }; // CRC-8/OPENSAFETY
+inline constexpr crc_preset<uint8_t>  crc8_rohc               = { 0x07, 0xff, 0x00, true,  true,  0xd0 }; // CRC-8/ROHC
+inline constexpr crc_preset<uint8_t>  crc8_sae_j1850          = { 0x1d, 0xff, 0xff, false, false, 0x4b }; // CRC-8/SAE-J1850
+inline constexpr crc_preset<uint8_t>  crc8_smbus              = { 0x07, 0x00, 0x00, false, false, 0xf4 }; // CRC-8/SMBUS
+inline constexpr crc_preset<uint8_t>  crc8_tech_3250          = { 0x1d, 0xff, 0x00, true,  true,  0x97 }; // CRC-8/TECH-3250
+inline constexpr crc_preset<uint8_t>  crc8_wcdma              = { 0x9b, 0x00, 0x00, true,  true,  0x25 }; // CRC-8/WCDMA
+
+inline constexpr crc_preset<uint16_t> crc16_arc               = { 0x8005, 0x0000, 0x0000, true,  true,  0xbb3d }; // CRC-16/ARC
+inline constexpr crc_preset<uint16_t> crc16_cdma2000          = { 0xc867, 0xffff, 0x0000, false, false, 0x4c06 }; // CRC-16/CDMA2000
+inline constexpr crc_preset<uint16_t> crc16_cms               = { 0x8005, 0xffff, 0x0000, false, false, 0xaee7 }; // CRC-16/CMS
+inline constexpr crc_preset<uint16_t> crc16_dds_110           = { 0x8005, 0x800d, 0x0000, false, false, 0x9ecf }; // CRC-16/DDS-110
+inline constexpr crc_preset<uint16_t> crc16_dect_r            = { 0x0589, 0x0000, 0x0001, false, false, 0x007e }; // CRC-16/DECT-R
+inline constexpr crc_preset<uint16_t> crc16_dect_x            = { 0x0589, 0x0000, 0x0000, false, false, 0x007f }; // CRC-16/DECT-X
+inline constexpr crc_preset<uint16_t> crc16_dnp               = { 0x3d65, 0x0000, 0xffff, true,  true,  0xea82 }; // CRC-16/DNP
+inline constexpr crc_preset<uint16_t> crc16_en_13757          = { 0x3d65, 0x0000, 0xffff, false, false, 0xc2b7 }; // CRC-16/EN-13757
+inline constexpr crc_preset<uint16_t> crc16_genibus           = { 0x1021, 0xffff, 0xffff, false, false, 0xd64e }; // CRC-16/GENIBUS
+inline constexpr crc_preset<uint16_t> crc16_gsm               = { 0x1021, 0x0000, 0xffff, false, false, 0xce3c }; // CRC-16/GSM
+inline constexpr crc_preset<uint16_t> crc16_ibm_3740          = { 0x1021, 0xffff, 0x0000, false, false, 0x29b1 }; // CRC-16/IBM-3740
+inline constexpr crc_preset<uint16_t> crc16_ibm_sdlc          = { 0x1021, 0xffff, 0xffff, true,  true,  0x906e }; // CRC-16/IBM-SDLC
+inline constexpr crc_preset<uint16_t> crc16_iso_iec_14443_3_a = { 0x1021, 0xc6c6, 0x0000, true,  true,  0xbf05 }; // CRC-16/ISO-IEC-14443-3-A
+inline constexpr crc_preset<uint16_t> crc16_kermit            = { 0x1021, 0x0000, 0x0000, true,  true,  0x2189 }; // CRC-16/KERMIT
+inline constexpr crc_preset<uint16_t> crc16_lj1200            = { 0x6f63, 0x0000, 0x0000, false, false, 0xbdf4 }; // CRC-16/LJ1200
+inline constexpr crc_preset<uint16_t> crc16_m17               = { 0x5935, 0xffff, 0x0000, false, false, 0x772b }; // CRC-16/M17
+inline constexpr crc_preset<uint16_t> crc16_maxim_dow         = { 0x8005, 0x0000, 0xffff, true,  true,  0x44c2 }; // CRC-16/MAXIM-DOW
+inline constexpr crc_preset<uint16_t> crc16_mcrf4xx           = { 0x1021, 0xffff, 0x0000, true,  true,  0x6f91 }; // CRC-16/MCRF4XX
+inline constexpr crc_preset<uint16_t> crc16_modbus            = { 0x8005, 0xffff, 0x0000, true,  true,  0x4b37 }; // CRC-16/MODBUS
+inline constexpr crc_preset<uint16_t> crc16_nrsc_5            = { 0x080b, 0xffff, 0x0000, true,  true,  0xa066 }; // CRC-16/NRSC-5
+inline constexpr crc_preset<uint16_t> crc16_opensafety_a      = { 0x5935, 0x0000, 0x0000, false, false, 0x5d38 }; // CRC-16/OPENSAFETY-A
+inline constexpr crc_preset<uint16_t> crc16_opensafety_b      = { 0x755b, 0x0000, 0x0000, false, false, 0x20fe }; // CRC-16/OPENSAFETY-B
+inline constexpr crc_preset<uint16_t> crc16_profibus          = { 0x1dcf, 0xffff, 0xffff, false, false, 0xa819 }; // CRC-16/PROFIBUS
+inline constexpr crc_preset<uint16_t> crc16_riello            = { 0x1021, 0xb2aa, 0x0000, true,  true,  0x63d0 }; // CRC-16/RIELLO
+inline constexpr crc_preset<uint16_t> crc16_spi_fujitsu       = { 0x1021, 0x1d0f, 0x0000, false, false, 0xe5cc }; // CRC-16/SPI-FUJITSU
+inline constexpr crc_preset<uint16_t> crc16_t10_dif           = { 0x8bb7, 0x0000, 0x0000, false, false, 0xd0db }; // CRC-16/T10-DIF
+inline constexpr crc_preset<uint16_t> crc16_teledisk          = { 0xa097, 0x0000, 0x0000, false, false, 0x0fb3 }; // CRC-16/TELEDISK
+inline constexpr crc_preset<uint16_t> crc16_tms37157          = { 0x1021, 0x89ec, 0x0000, true,  true,  0x26b1 }; // CRC-16/TMS37157
+inline constexpr crc_preset<uint16_t> crc16_umts              = { 0x8005, 0x0000, 0x0000, false, false, 0xfee8 }; // CRC-16/UMTS
+inline constexpr crc_preset<uint16_t> crc16_usb               = { 0x8005, 0xffff, 0xffff, true,  true,  0xb4c8 }; // CRC-16/USB
+inline constexpr crc_preset<uint16_t> crc16_xmodem            = { 0x1021, 0x0000, 0x0000, false, false, 0x31c3 }; // CRC-16/XMODEM
+
+inline constexpr crc_preset<uint32_t> crc32_aixm              = { 0x814141ab, 0x00000000, 0x00000000, false, false, 0x3010bf7f }; // CRC-32/AIXM
+inline constexpr crc_preset<uint32_t> crc32_autosar           = { 0xf4acfb13, 0xffffffff, 0xffffffff, true,  true,  0x1697d06a }; // CRC-32/AUTOSAR
+inline constexpr crc_preset<uint32_t> crc32_base91_d          = { 0xa833982b, 0xffffffff, 0xffffffff, true,  true,  0x87315576 }; // CRC-32/BASE91-D
+inline constexpr crc_preset<uint32_t> crc32_bzip2             = { 0x04c11db7, 0xffffffff, 0xffffffff, false, false, 0xfc891918 }; // CRC-32/BZIP2
+inline constexpr crc_preset<uint32_t> crc32_cd_rom_edc        = { 0x8001801b, 0x00000000, 0x00000000, true,  true,  0x6ec2edc4 }; // CRC-32/CD-ROM-EDC
+inline constexpr crc_preset<uint32_t> crc32_cksum             = { 0x04c11db7, 0x00000000, 0xffffffff, false, false, 0x765e7680 }; // CRC-32/CKSUM
+inline constexpr crc_preset<uint32_t> crc32_iscsi             = { 0x1edc6f41, 0xffffffff, 0xffffffff, true,  true,  0xe3069283 }; // CRC-32/ISCSI
+inline constexpr crc_preset<uint32_t> crc32_iso_hdlc          = { 0x04c11db7, 0xffffffff, 0xffffffff, true,  true,  0xcbf43926 }; // CRC-32/ISO-HDLC
+inline constexpr crc_preset<uint32_t> crc32_jamcrc            = { 0x04c11db7, 0xffffffff, 0x00000000, true,  true,  0x340bc6d9 }; // CRC-32/JAMCRC
+inline constexpr crc_preset<uint32_t> crc32_mef               = { 0x741b8cd7, 0xffffffff, 0x00000000, true,  true,  0xd2c22f51 }; // CRC-32/MEF
+inline constexpr crc_preset<uint32_t> crc32_mpeg_2            = { 0x04c11db7, 0xffffffff, 0x00000000, false, false, 0x0376e6e7 }; // CRC-32/MPEG-2
+inline constexpr crc_preset<uint32_t> crc32_xfer              = { 0x000000af, 0x00000000, 0x00000000, false, false, 0xbd0be338 }; // CRC-32/XFER
+
+inline constexpr crc_preset<uint64_t> crc64_ecma_182          = { 0x42f0e1eba9ea3693, 0x0000000000000000, 0x0000000000000000, false, false, 0x6c40df5f0b497347 }; // CRC-64/ECMA-182
+inline constexpr crc_preset<uint64_t> crc64_go_iso            = { 0x000000000000001b, 0xffffffffffffffff, 0xffffffffffffffff, true,  true,  0xb90956c775a41001 }; // CRC-64/GO-ISO
+inline constexpr crc_preset<uint64_t> crc64_ms                = { 0x259c84cba6426349, 0xffffffffffffffff, 0x0000000000000000, true,  true,  0x75d4b74f024eceea }; // CRC-64/MS
+inline constexpr crc_preset<uint64_t> crc64_we                = { 0x42f0e1eba9ea3693, 0xffffffffffffffff, 0xffffffffffffffff, false, false, 0x62ec59e3f1a4f00a }; // CRC-64/WE
+inline constexpr crc_preset<uint64_t> crc64_xz                = { 0x42f0e1eba9ea3693, 0xffffffffffffffff, 0xffffffffffffffff, true,  true,  0x995dc9bbdf1939fa }; // CRC-64/XZ
+
+inline constexpr auto crc32     = crc32_iso_hdlc;
+inline constexpr auto crc32c    = crc32_iscsi;
+
+// ANCHOR Combine
+
+/**
+ * @brief Combine CRCs of two adjacent blocks A and B into CRC of their 
+ * concatenation A|B, knowing only the length of B. Allows to compute 
+ * CRC of independent chunks in any order (or in parallel) and merge 
+ * results afterwards. Takes O(log(len_b)) polynomial multiplications, 
+ * powers of x are precomputed at compile time. Input reflection is 
+ * irrelevant here, because reflected zero byte is still zero, 
+ * it's kept only for symmetry with other functions.
+ * 
+ * @tparam T Integer type
+ * @tparam poly Polynomial
+ * @tparam init Initial value
+ * @tparam xorout Value to XOR with final result
+ * @tparam refin Reflect input bytes
+ * @tparam refout Reflect output value
+ * @param crc_a Final CRC value of the first block
+ * @param crc_b Final CRC value of the second block
+ * @param len_b Length of the second block in bytes
+ * @return CRC value of both blocks
+ */
+template<std::integral T, T poly, T init, T xorout, bool refin, bool refout>
+constexpr T crc_combine(T crc_a, T crc_b, size_t len_b)
+{
+    T val = crc_a ^ xorout;
+    if constexpr (refout)
+        val = bitswap(val);
+    val = imp::crc_mulmod<T, poly>(imp::crc_x8n<T, poly>(len_b), val ^ init);
+    if constexpr (refout)
+        val = bitswap(val);
+    return val ^ crc_b;
+}
+
+/**
+ * @brief Combine CRCs of two adjacent blocks for a given preset.
+ * 
+ * @tparam P CRC preset
+ * @param crc_a Final CRC value of the first block
+ * @param crc_b Final CRC value of the second block
+ * @param len_b Length of the second block in bytes
+ * @return CRC value of both blocks
+ */
+template<crc_preset P>
+constexpr auto crc_combine(decltype(P.check) crc_a, decltype(P.check) crc_b, size_t len_b)
+{
+    using T = decltype(P.check);
+    return crc_combine<T, P.poly, P.init, P.xorout, P.refin, P.refout>(crc_a, crc_b, len_b);
+}
+
 }
 
 #endif
\ No newline at end of file
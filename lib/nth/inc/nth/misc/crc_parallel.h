@@ -0,0 +1,64 @@
+#ifndef NTH_MISC_CRC_PARALLEL_H
+#define NTH_MISC_CRC_PARALLEL_H
+
+#include "nth/misc/crc.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace nth {
+
+/**
+ * @brief Calculate CRC of a large buffer using multiple threads. Buffer is
+ * split into equal contiguous chunks, each one is processed by 'crc_fast'
+ * on its own thread (first chunk on the calling thread) and then results
+ * are merged in order with 'crc_combine'. Host-only, requires threads.
+ *
+ * @tparam T Integer type
+ * @tparam poly Polynomial
+ * @tparam init Initial value
+ * @tparam xorout Value to XOR with final result
+ * @tparam refin Reflect input bytes
+ * @tparam refout Reflect output value
+ * @param data Data to calculate CRC on
+ * @param threads Maximum number of threads, 0 means hardware concurrency
+ * @param min_chunk Minimum chunk size in bytes, to not spawn threads for tiny inputs
+ * @return CRC value
+ */
+template<std::integral T, T poly, T init, T xorout, bool refin, bool refout>
+T crc_parallel(std::span<const byte> data, size_t threads = 0, size_t min_chunk = 0x10000)
+{
+    if (!threads)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    auto n = std::clamp<size_t>(data.size() / std::max<size_t>(min_chunk, 1), 1, threads);
+    if (n == 1)
+        return crc_fast<T, poly, init, xorout, refin, refout>(data);
+
+    auto chunk = data.size() / n;
+    auto part = [&] (size_t i) {
+        return i == n - 1 ? data.subspan(i * chunk) : data.subspan(i * chunk, chunk);
+    };
+    std::vector<T> res(n);
+    std::vector<std::thread> pool;
+    pool.reserve(n - 1);
+
+    for (size_t i = 1; i < n; ++i) {
+        pool.emplace_back([&, i] {
+            res[i] = crc_fast<T, poly, init, xorout, refin, refout>(part(i));
+        });
+    }
+    res[0] = crc_fast<T, poly, init, xorout, refin, refout>(part(0));
+
+    for (auto& t : pool)
+        t.join();
+
+    auto val = res[0];
+    for (size_t i = 1; i < n; ++i)
+        val = crc_combine<T, poly, init, xorout, refin, refout>(val, res[i], part(i).size());
+    return val;
+}
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef NTH_UTIL_ARENA_H
+#define NTH_UTIL_ARENA_H
+
+#include "nth/util/meta.h"
+#include "nth/util/scope.h"
+#include <memory_resource>
+
+namespace nth {
+
+/**
+ * @brief Monotonic bump allocator over caller-supplied buffer. Individual
+ * deallocation is a no-op, memory is reclaimed all at once with 'reset' 
+ * or back to a saved point with 'rewind', e.g. with 'scope' guard which 
+ * releases everything allocated during its lifetime. Exposes interface
+ * of std::pmr::memory_resource, so standard containers can use it. When
+ * used as memory_resource and buffer is exhausted, behaves like 
+ * std::pmr::null_memory_resource, otherwise use 'try_allocate' which 
+ * returns nullptr.
+ * 
+ */
+struct arena : std::pmr::memory_resource {
+
+    using mark_type = size_t;
+
+    arena(std::span<byte> buf) noexcept : buf{buf} {}
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    size_t capacity() const noexcept    { return buf.size(); }
+    size_t used() const noexcept        { return top; }
+    size_t available() const noexcept   { return buf.size() - top; }
+
+    /**
+     * @brief Allocate memory block.
+     * 
+     * @param size Number of bytes
+     * @param align Alignment, must be power of 2
+     * @return Pointer to memory or nullptr if there's not enough space 
+     */
+    void* try_allocate(size_t size, size_t align = alignof(std::max_align_t)) noexcept
+    {
+        auto base = reinterpret_cast<uintptr_t>(buf.data());
+        auto pos = ((base + top + align - 1) & ~(align - 1)) - base;
+        if (pos > buf.size() || buf.size() - pos < size)
+            return nullptr;
+        top = pos + size;
+        return buf.data() + pos;
+    }
+
+    /**
+     * @brief Release everything allocated from the arena.
+     * 
+     */
+    void reset() noexcept
+    {
+        top = 0;
+    }
+
+    /**
+     * @brief Save current allocation point.
+     * 
+     * @return Mark to pass to 'rewind'
+     */
+    mark_type mark() const noexcept
+    {
+        return top;
+    }
+
+    /**
+     * @brief Release everything allocated after mark was taken.
+     * 
+     * @param m Mark from 'mark'
+     */
+    void rewind(mark_type m) noexcept
+    {
+        assert(m <= top);
+        top = m;
+    }
+
+    /**
+     * @brief Make guard, which rewinds the arena to current point when
+     * it goes out of scope.
+     * 
+     * @return Scope guard
+     */
+    [[nodiscard]] auto scope() noexcept
+    {
+        return scope_guard{[this, m = mark()] { rewind(m); }};
+    }
+private:
+    void* do_allocate(size_t size, size_t align) override
+    {
+        auto p = try_allocate(size, align);
+        return p ? p : std::pmr::null_memory_resource()->allocate(size, align);
+    }
+    void do_deallocate(void*, size_t, size_t) override 
+    {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+private:
+    std::span<byte> buf;
+    size_t top = 0;
+};
+
+}
+
+#endif
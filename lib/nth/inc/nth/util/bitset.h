@@ -5,6 +5,11 @@
 
 #include "nth/util/bit.h"
 #include <array>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 namespace nth {
 namespace imp {
@@ -52,6 +57,65 @@ constexpr auto bit_tree_struct()
     return arr;
 }
 
+/**
+ * @brief Find first word which is not fully set. At runtime scans 16
+ * bytes at a time with SIMD compare, if target supports it (SSE2 or 
+ * AArch64 NEON), tail and constexpr evaluation use plain loop.
+ * 
+ * @tparam T Word type
+ * @param p Pointer to words
+ * @param n Number of words
+ * @return Index of word or n if all are full
+ */
+template<class T>
+constexpr size_t bit_scan_not_full(const T* p, size_t n)
+{
+    size_t i = 0;
+#if defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+    if !consteval {
+        constexpr auto step = 16 / sizeof(T);
+        for (; i + step <= n; i += step) {
+#if defined(__SSE2__)
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(-1))) != 0xffff)
+                break;
+#else
+            if (vminvq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p + i))) != 0xff)
+                break;
+#endif
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (p[i] != int_bits_full<T>)
+            break;
+    }
+    return i;
+}
+
+/**
+ * @brief Call function for every word touched by bit range [first, last),
+ * with mask of bits in the range for that word.
+ * 
+ * @tparam T Word type
+ * @param first First bit
+ * @param last Bit after the last one
+ * @param f Function taking word index and mask
+ */
+template<class T>
+constexpr void bit_range_words(size_t first, size_t last, auto&& f)
+{
+    while (first < last) {
+        size_t lo = first & int_bits_wrap<T>;
+        size_t hi = std::min<size_t>(bit_size<T>, lo + last - first);
+        T mask = int_bits_full<T> << lo;
+        if (hi < bit_size<T>)
+            mask &= bit_mask<T>(hi);
+        f(first >> int_bits_log2<T>, mask);
+        first += hi - lo;
+    }
+}
+
 }
 
 /**
@@ -126,10 +190,52 @@ struct bitset {
             }
         }
     }
+    constexpr void set(size_t first, size_t last)
+    {
+        assert(first <= last && last <= N);
+        imp::bit_range_words<T>(first, last, [this] (size_t i, T mask) {
+            buf[i] |= mask;
+            if (buf[i] == int_bits_full<T>)
+                mark_full(i);
+        });
+    }
+    constexpr void clr(size_t first, size_t last)
+    {
+        assert(first <= last && last <= N);
+        imp::bit_range_words<T>(first, last, [this] (size_t i, T mask) {
+            if (buf[i] == int_bits_full<T>)
+                mark_not_full(i);
+            buf[i] &= ~mask;
+        });
+    }
+    constexpr size_t count() const
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < levels[0].size; ++i)
+            n += std::popcount(to_unsigned(buf[i]));
+        return n - (levels[0].size * bit_size<T> - N);
+    }
+    constexpr size_t find_next_set(size_t pos) const
+    {
+        assert(pos <= N);
+        if (pos == N)
+            return N;
+        size_t i = pos >> int_bits_log2<T>;
+        T word = buf[i] & T(int_bits_full<T> << (pos & int_bits_wrap<T>));
+        while (!word) {
+            if (++i == levels[0].size)
+                return N;
+            word = buf[i];
+        }
+        return std::min<size_t>((i << int_bits_log2<T>) + cnttz(word), N);
+    }
     constexpr auto acquire_any()
     {
         const auto& end = levels.back();
-        for (size_t i = 0; i < end.size; ++i) {
+        size_t i = 0;
+        if constexpr (levels.back().size * sizeof(T) >= 32)
+            i = imp::bit_scan_not_full(buf + end.head, end.size);
+        for (; i < end.size; ++i) {
             if (buf[end.head + i] != int_bits_full<T>) {
                 if constexpr (depth() == 1) {
                     size_t pos = cnttz(~buf[i]);
@@ -153,18 +259,39 @@ private:
 #if (NTH_UTIL_BITSET_REMAINDER_STORED)
         for (const auto& [head, size, remainder] : levels) {
             if (remainder)
-                buf[head + size - 1] = ~(bit(remainder) - 1);
+                buf[head + size - 1] = ~bit_mask<T>(remainder);
         }
 #else
         size_t bits = N;
         for (const auto& [head, size] : levels) {
             auto remainder = bits & int_bits_wrap<T>;
             if (remainder)
-                buf[head + size - 1] = ~(bit(remainder) - 1);
+                buf[head + size - 1] = ~bit_mask<T>(remainder);
             bits = int_bits_ceil_div<T>(bits);
         }
 #endif
     }
+    constexpr void mark_full(size_t pos)
+    {
+        for (auto it = levels.begin() + 1; it != levels.end(); ++it) {
+            auto bit = pos & int_bits_wrap<T>;
+            pos = pos >> int_bits_log2<T>;
+            set_bit(buf[it->head + pos], bit);
+            if (buf[it->head + pos] != int_bits_full<T>)
+                break;
+        }
+    }
+    constexpr void mark_not_full(size_t pos)
+    {
+        for (auto it = levels.begin() + 1; it != levels.end(); ++it) {
+            auto bit = pos & int_bits_wrap<T>;
+            pos = pos >> int_bits_log2<T>;
+            bool full = buf[it->head + pos] == int_bits_full<T>;
+            clr_bit(buf[it->head + pos], bit);
+            if (!full)
+                break;
+        }
+    }
     static constexpr auto levels = imp::bit_tree_struct<T, N, G>();
 private:
     T buf[words()] = {};
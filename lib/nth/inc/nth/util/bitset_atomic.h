@@ -0,0 +1,207 @@
+#ifndef NTH_UTIL_BITSET_ATOMIC_H
+#define NTH_UTIL_BITSET_ATOMIC_H
+
+#include "nth/util/bitset.h"
+#include <atomic>
+
+namespace nth {
+
+/**
+ * @brief Thread-safe version of nth::bitset with the same compile-time
+ * tree of levels, where every word is atomic. Bits on the bottom level
+ * are exact and are changed with CAS or fetch_or/fetch_and. Bits on
+ * upper levels ("word below is full") are hints: after marking parent
+ * as full the child is checked again and mark is rolled back if someone
+ * freed a bit in between, so a free bit is never hidden. Stale "not full"
+ * hints are repaired by 'acquire_any' when it descends into full word.
+ *
+ * @tparam T Word type for storage array, must be lock-free atomic
+ * @tparam N Number of used bits from array
+ * @tparam G Grow point, maximum number of words on the top level (after this tree adds level at compile-time)
+ */
+template<class T, size_t N, size_t G>
+struct bitset_atomic {
+    static_assert(std::atomic<T>::is_always_lock_free);
+    bitset_atomic()                     { init_mask(); }
+    bitset_atomic(const bitset_atomic&) = delete;
+    bitset_atomic& operator=(const bitset_atomic&) = delete;
+    constexpr static size_t capacity()  { return N; }
+    constexpr static size_t depth()     { return levels.size(); }
+    constexpr static size_t words()     { return levels.back().head + levels.back().size; }
+
+    /**
+     * @brief Clear all bits, not thread-safe.
+     *
+     */
+    void reset()
+    {
+        for (auto& it : buf)
+            it.store(0, std::memory_order_relaxed);
+        init_mask();
+    }
+    bool operator[](size_t pos) const
+    {
+        assert(pos < N);
+        return get_bit(load(pos >> int_bits_log2<T>), pos & int_bits_wrap<T>);
+    }
+
+    /**
+     * @brief Set bit at position.
+     *
+     * @param pos Bit position
+     * @return Previous value of the bit
+     */
+    bool set(size_t pos)
+    {
+        assert(pos < N);
+        auto i = pos >> int_bits_log2<T>;
+        auto mask = bit<T>(pos & int_bits_wrap<T>);
+        auto prev = buf[i].fetch_or(mask, std::memory_order_acq_rel);
+        if (T(prev | mask) == int_bits_full<T> && prev != int_bits_full<T>)
+            mark_full(0, i);
+        return prev & mask;
+    }
+
+    /**
+     * @brief Clear bit at position.
+     *
+     * @param pos Bit position
+     * @return Previous value of the bit
+     */
+    bool clr(size_t pos)
+    {
+        assert(pos < N);
+        auto i = pos >> int_bits_log2<T>;
+        auto mask = bit<T>(pos & int_bits_wrap<T>);
+        auto prev = buf[i].fetch_and(T(~mask), std::memory_order_acq_rel);
+        if (prev == int_bits_full<T>)
+            mark_not_full(0, i);
+        return prev & mask;
+    }
+    void set(size_t first, size_t last)
+    {
+        assert(first <= last && last <= N);
+        imp::bit_range_words<T>(first, last, [this] (size_t i, T mask) {
+            auto prev = buf[i].fetch_or(mask, std::memory_order_acq_rel);
+            if (T(prev | mask) == int_bits_full<T> && prev != int_bits_full<T>)
+                mark_full(0, i);
+        });
+    }
+    void clr(size_t first, size_t last)
+    {
+        assert(first <= last && last <= N);
+        imp::bit_range_words<T>(first, last, [this] (size_t i, T mask) {
+            if (buf[i].fetch_and(T(~mask), std::memory_order_acq_rel) == int_bits_full<T>)
+                mark_not_full(0, i);
+        });
+    }
+    size_t count() const
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < levels[0].size; ++i)
+            n += std::popcount(to_unsigned(load(i)));
+        return n - (levels[0].size * bit_size<T> - N);
+    }
+    size_t find_next_set(size_t pos) const
+    {
+        assert(pos <= N);
+        if (pos == N)
+            return N;
+        size_t i = pos >> int_bits_log2<T>;
+        T word = load(i) & T(int_bits_full<T> << (pos & int_bits_wrap<T>));
+        while (!word) {
+            if (++i == levels[0].size)
+                return N;
+            word = load(i);
+        }
+        return std::min<size_t>((i << int_bits_log2<T>) + cnttz(word), N);
+    }
+
+    /**
+     * @brief Find and set any clear bit.
+     *
+     * @return Position of acquired bit or N if bitset is full
+     */
+    size_t acquire_any()
+    {
+        const auto& end = levels.back();
+    retry:
+        for (size_t i = 0; i < end.size; ++i) {
+            if (load(end.head + i) == int_bits_full<T>)
+                continue;
+            size_t pos = i;
+            for (size_t lvl = depth() - 1; lvl > 0; --lvl) {
+                auto word = load(levels[lvl].head + pos);
+                if (word == int_bits_full<T>)
+                    goto retry;
+                auto idx = (pos << int_bits_log2<T>) + cnttz(T(~word));
+                if (load(levels[lvl - 1].head + idx) == int_bits_full<T>) {
+                    mark_full(lvl - 1, idx);
+                    goto retry;
+                }
+                pos = idx;
+            }
+            auto& word = buf[pos];
+            auto prev = word.load(std::memory_order_relaxed);
+            while (prev != int_bits_full<T>) {
+                auto mask = bit<T>(cnttz(T(~prev)));
+                if (word.compare_exchange_weak(prev, prev | mask, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    if (T(prev | mask) == int_bits_full<T>)
+                        mark_full(0, pos);
+                    return (pos << int_bits_log2<T>) + cnttz(mask);
+                }
+            }
+            if constexpr (depth() > 1)
+                goto retry;
+        }
+        return N;
+    }
+private:
+    T load(size_t i) const
+    {
+        return buf[i].load(std::memory_order_acquire);
+    }
+    void mark_full(size_t lvl, size_t pos)
+    {
+        for (; lvl + 1 < depth(); ++lvl) {
+            auto& child = buf[levels[lvl].head + pos];
+            auto mask = bit<T>(pos & int_bits_wrap<T>);
+            pos = pos >> int_bits_log2<T>;
+            auto& parent = buf[levels[lvl + 1].head + pos];
+            auto prev = parent.fetch_or(mask, std::memory_order_acq_rel);
+            if (child.load(std::memory_order_acquire) != int_bits_full<T>) {
+                if (parent.fetch_and(T(~mask), std::memory_order_acq_rel) == int_bits_full<T>)
+                    mark_not_full(lvl + 1, pos);
+                break;
+            }
+            if (T(prev | mask) != int_bits_full<T> || prev == int_bits_full<T>)
+                break;
+        }
+    }
+    void mark_not_full(size_t lvl, size_t pos)
+    {
+        for (; lvl + 1 < depth(); ++lvl) {
+            auto mask = bit<T>(pos & int_bits_wrap<T>);
+            pos = pos >> int_bits_log2<T>;
+            if (buf[levels[lvl + 1].head + pos].fetch_and(T(~mask), std::memory_order_acq_rel) != int_bits_full<T>)
+                break;
+        }
+    }
+    void init_mask()
+    {
+        size_t bits = N;
+        for (const auto& it : levels) {
+            auto remainder = bits & int_bits_wrap<T>;
+            if (remainder)
+                buf[it.head + it.size - 1].store(T(~bit_mask<T>(remainder)), std::memory_order_relaxed);
+            bits = int_bits_ceil_div<T>(bits);
+        }
+    }
+    static constexpr auto levels = imp::bit_tree_struct<T, N, G>();
+private:
+    std::atomic<T> buf[words()] = {};
+};
+
+}
+
+#endif
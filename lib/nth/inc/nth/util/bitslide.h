@@ -2,9 +2,9 @@
 #define NTH_UTIL_BITSLIDE_H
 
 #include "nth/util/bit.h"
+#include <algorithm>
 
 #define NTH_UTIL_BITSLIDE_EXT   false
-#define NTH_UTIL_BITSLIDE_ARR   false
 
 namespace nth {
 
@@ -100,28 +100,35 @@ private:
 #endif
 };
 
-#if (NTH_UTIL_BITSLIDE_ARR)
 /**
- * @brief Same as regular bitslide, but with an array of 
- * words as underlying bitmask storage another update logic.
- * Implementation of RFC-6479 anti-replay window without bit shifting: https://datatracker.ietf.org/doc/html/rfc6479
- * 
+ * @brief Same as regular bitslide, but with an array of words as
+ * underlying bitmask storage, so window can be much wider than one
+ * machine word. Bitmask is circular, as in RFC 6479 anti-replay window
+ * without bit shifting: https://datatracker.ietf.org/doc/html/rfc6479
+ * Bit of sequence number is at position 'seqn % Bits', so sliding the
+ * window never moves stored bits, it only clears bits of numbers which
+ * the window skipped over: whole words in the middle and masked edge
+ * words, at most 'Bits / bit_size<Word> + 1' words per update, or the
+ * whole array with plain fill if the jump exceeds the window. Unlike
+ * RFC 6479 clearing is bit exact, so all 'Bits' values are usable and
+ * behavior is the same as bitslide with 'Bits' wide Word: the latest
+ * value takes a bit and the initial value and everything smaller is
+ * considered as already passed.
+ *
  * @tparam Seqn Sequence number type
  * @tparam Word Storage word type
- * @tparam Bits Window size, power of 2
+ * @tparam Bits Window size, power of 2 and multiple of Word size
  */
 template<std::unsigned_integral Seqn, std::unsigned_integral Word, size_t Bits>
-struct bitslide {
-    static_assert(is_pow2(bit_size<Word>));
-    static_assert(is_pow2(Bits));
-    static constexpr auto slide = Bits - bit_size<Word>;
+struct bitslide_arr {
+    static_assert(is_pow2(Bits) && Bits >= bit_size<Word>);
+    static constexpr Seqn bits = Bits;
     static constexpr auto words = Bits / bit_size<Word>;
-    static constexpr auto imask = words - 1;
     static constexpr auto shift = int_bits_log2<Word>;
-    static constexpr auto bmask = bit_mask(shift);
+    static constexpr auto bmask = int_bits_wrap<Word>;
 public:
-    constexpr bitslide() = default;
-    constexpr bitslide(Seqn seqn) : high{seqn} {}
+    constexpr bitslide_arr()                { std::ranges::fill(buff, int_bits_full<Word>); }
+    constexpr bitslide_arr(Seqn seqn) : bitslide_arr{} { high = seqn; }
 public:
     constexpr Seqn latest() const
     {
@@ -131,31 +138,57 @@ public:
     {
         if (seqn > high)
             return true;
-        if (seqn == high)
-            return false;
-        if (high - seqn > slide) // NOTE: 32 bits window BEFORE latest (not including)
+        if (high - seqn >= bits)
             return false;
-        auto idx = (seqn >> shift) & imask;
-        auto bit =  seqn           & bmask;
-        return !get_bit(buff[idx], bit);
+        return !get_arr_bit(buff, seqn & (Bits - 1));
     }
     constexpr void update(Seqn seqn)
     {
-        // TODO
+        if (seqn > high)
+            update_latest(seqn);
+        else if (high - seqn < bits)
+            set_arr_bit(buff, seqn & (Bits - 1));
     }
     constexpr bool check_and_update(Seqn seqn)
     {
-        // TODO
+        if (seqn > high) {
+            update_latest(seqn);
+            return true;
+        }
+        auto idx = unsigned(seqn & (Bits - 1));
+        if (high - seqn >= bits || get_arr_bit(buff, idx))
+            return false;
+        set_arr_bit(buff, idx);
+        return true;
+    }
+private:
+    constexpr void update_latest(Seqn seqn)
+    {
+        auto diff = seqn - high;
+        if (diff >= bits) {
+            std::ranges::fill(buff, Word(0));
+        } else {
+            // NOTE: Clear bits of (high, seqn], possibly wrapping around the end
+            auto pos = size_t((high + 1) & (Bits - 1));
+            auto cnt = size_t(diff);
+            while (cnt) {
+                auto off = pos & bmask;
+                auto n = std::min(cnt, bit_size<Word> - off);
+                buff[pos >> shift] &= ~(int_bits_full<Word> >> (bit_size<Word> - n) << off);
+                pos = (pos + n) & (Bits - 1);
+                cnt -= n;
+            }
+        }
+        set_arr_bit(buff, seqn & (Bits - 1));
+        high = seqn;
     }
 private:
     Seqn high = 0;
-    Word buff[words] = {};
+    Word buff[words];
 };
-#endif
 
 }
 
 #undef NTH_UTIL_BITSLIDE_EXT
-#undef NTH_UTIL_BITSLIDE_ARR
 
 #endif
@@ -28,6 +28,17 @@ namespace nth {
 #define NTH_NOINLINE    __declspec(noinline)
 #endif
 
+/**
+ * @brief Assumed cache line size in bytes. Used to place data written
+ * by different threads on separate lines and avoid false sharing.
+ * Can be overridden, e.g. with 32 for small cores.
+ * 
+ */
+#ifndef NTH_CACHE_LINE_SIZE
+#define NTH_CACHE_LINE_SIZE 64
+#endif
+inline constexpr size_t cache_line_size = NTH_CACHE_LINE_SIZE;
+
 /**
  * @brief Typedef representing 8-bit object in some library parts.  
  * 
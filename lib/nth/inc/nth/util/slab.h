@@ -0,0 +1,123 @@
+#ifndef NTH_UTIL_SLAB_H
+#define NTH_UTIL_SLAB_H
+
+#include "nth/util/arena.h"
+#include <bit>
+
+namespace nth {
+
+/**
+ * @brief Size-class slab allocator over caller-supplied buffer. Request
+ * is rounded up to power of 2 class between Min and Min << (Classes - 1)
+ * bytes, blocks of a class are carved from the buffer on demand and 
+ * returned to intrusive free list of that class on deallocation, so they
+ * are reused without fragmentation. Blocks are aligned to their class
+ * size, so any alignment up to the block size is honored, even above
+ * max_align_t. Exposes std::pmr::memory_resource interface, 
+ * when used as memory_resource and request can't be satisfied, behaves 
+ * like std::pmr::null_memory_resource, otherwise use 'try_allocate'.
+ * 
+ * @tparam Min Smallest class size, power of 2 and at least pointer size
+ * @tparam Classes Number of size classes
+ */
+template<size_t Min = 16, size_t Classes = 8>
+struct slab : std::pmr::memory_resource {
+
+    static_assert(std::has_single_bit(Min) && Min >= sizeof(void*), "Min must be power of 2 and fit a pointer");
+    static_assert(Classes > 0);
+
+    slab(std::span<byte> buf) noexcept : mem{buf} {}
+    slab(const slab&) = delete;
+    slab& operator=(const slab&) = delete;
+
+    static constexpr size_t max_block() { return Min << (Classes - 1); }
+
+    /**
+     * @brief Size class index of a request.
+     * 
+     * @param size Number of bytes
+     * @param align Alignment
+     * @return Class index or Classes if request is too big
+     */
+    static constexpr size_t size_class(size_t size, size_t align = 1)
+    {
+        auto block = std::bit_ceil(std::max({size, align, Min}));
+        if (block > max_block())
+            return Classes;
+        return std::countr_zero(block) - std::countr_zero(Min);
+    }
+
+    /**
+     * @brief Allocate memory block from the free list of its class, or
+     * carve new one from the buffer.
+     * 
+     * @param size Number of bytes
+     * @param align Alignment, must be power of 2
+     * @return Pointer to memory or nullptr if request is too big or there's not enough space
+     */
+    void* try_allocate(size_t size, size_t align = alignof(std::max_align_t)) noexcept
+    {
+        auto c = size_class(size, align);
+        if (c == Classes)
+            return nullptr;
+        if (auto p = free[c]) {
+            free[c] = p->next;
+            return p;
+        }
+        auto block = Min << c;
+        return mem.try_allocate(block, block);
+    }
+
+    /**
+     * @brief Return memory block to the free list of its class.
+     * 
+     * @param p Pointer from 'try_allocate'
+     * @param size Same size as passed to 'try_allocate'
+     * @param align Same alignment as passed to 'try_allocate'
+     */
+    void release(void* p, size_t size, size_t align = alignof(std::max_align_t)) noexcept
+    {
+        if (!p)
+            return;
+        auto c = size_class(size, align);
+        assert(c < Classes);
+        free[c] = ::new (p) node{free[c]};
+    }
+
+    /**
+     * @brief Release everything and forget all free lists.
+     * 
+     */
+    void reset() noexcept
+    {
+        mem.reset();
+        std::fill(std::begin(free), std::end(free), nullptr);
+    }
+
+    size_t capacity() const noexcept    { return mem.capacity(); }
+    size_t used() const noexcept        { return mem.used(); }
+private:
+    void* do_allocate(size_t size, size_t align) override
+    {
+        auto p = try_allocate(size, align);
+        return p ? p : std::pmr::null_memory_resource()->allocate(size, align);
+    }
+    void do_deallocate(void* p, size_t size, size_t align) override
+    {
+        release(p, size, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+    struct node {
+        node* next;
+    };
+private:
+    arena mem;
+    node* free[Classes] = {};
+};
+
+}
+
+#endif
@@ -251,6 +251,77 @@ constexpr OutIt copy_assign_forward(InIt first, InIt last, OutIt d_first)
     return d_first;
 }
 
+// ANCHOR Relocation helpers
+
+/**
+ * @brief Whether moving object to a new address and destroying the old
+ * one is equivalent to copying its bytes. True for trivially copyable
+ * types, can be specialized for others (e.g. types with owning pointer).
+ * 
+ * @tparam T Object type
+ */
+template<class T>
+inline constexpr bool is_trivially_relocatable_v = std::is_trivially_copyable_v<T>;
+
+/**
+ * @brief Move objects from the range [first, last) to uninitialized memory
+ * starting at d_first and destroy originals, in forward order. Ranges
+ * may overlap if d_first is before first. Trivially relocatable types
+ * are moved with a single memmove.
+ * 
+ * @tparam T Object type
+ * @param first The beginning of the source range.
+ * @param last The end of the source range.
+ * @param d_first The beginning of the destination range.
+ * @return Pointer past the end of the relocated range.
+ */
+template<class T>
+constexpr T* relocate_forward(T* first, T* last, T* d_first)
+{
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if !consteval {
+            if (first != last)
+                std::memmove(static_cast<void*>(d_first), static_cast<const void*>(first), (last - first) * sizeof(T));
+            return d_first + (last - first);
+        }
+    }
+    for (; first != last; ++first, ++d_first) {
+        ctor(d_first, std::move(*first));
+        dtor(first);
+    }
+    return d_first;
+}
+
+/**
+ * @brief Move objects from the range [first, last) to uninitialized memory
+ * ending before d_last and destroy originals, in reverse order. Ranges
+ * may overlap if d_last is after last. Trivially relocatable types are
+ * moved with a single memmove.
+ * 
+ * @tparam T Object type
+ * @param first The beginning of the source range.
+ * @param last The end of the source range.
+ * @param d_last The end of the destination range.
+ * @return Pointer to the beginning of the relocated range.
+ */
+template<class T>
+constexpr T* relocate_backward(T* first, T* last, T* d_last)
+{
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if !consteval {
+            auto d_first = d_last - (last - first);
+            if (first != last)
+                std::memmove(static_cast<void*>(d_first), static_cast<const void*>(first), (last - first) * sizeof(T));
+            return d_first;
+        }
+    }
+    while (first != last) {
+        ctor(--d_last, std::move(*--last));
+        dtor(last);
+    }
+    return d_last;
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "test_coap.h"
+#include "nth/coap/engine.h"
+#include <vector>
+
+namespace nth::coap {
+namespace {
+
+std::vector<byte> make_request(msg_code code, word id, option_num num, const block_opt* blk, ispan payload = {})
+{
+    packet<128> pkt;
+    byte tok[] = {byte(id), 0xaa};
+    pkt.setup(msg_type::con, code, id, tok);
+    if (blk)
+        opt_insert_uint(pkt, num, blk->value());
+    pkt.set_payload(payload);
+    return {pkt.begin(), pkt.end()};
+}
+
+struct counting_source {
+    size_t read(size_t offset, ospan out)
+    {
+        ++calls;
+        for (size_t i = 0; i < out.size(); ++i)
+            out[i] = byte((offset + i) * 7);
+        return out.size();
+    }
+    operator payload_source()
+    {
+        return {
+            .read = [] (void* ctx, size_t offset, ospan out) {
+                return static_cast<counting_source*>(ctx)->read(offset, out);
+            },
+            .size = size,
+            .ctx = this,
+        };
+    }
+    size_t size;
+    size_t calls = 0;
+};
+
+struct vector_sink {
+    operator payload_sink()
+    {
+        return {
+            .write = [] (void* ctx, size_t offset, ispan data, bool last) {
+                auto self = static_cast<vector_sink*>(ctx);
+                if (offset != self->body.size())
+                    return false;
+                self->body.insert(self->body.end(), data.begin(), data.end());
+                self->done = last;
+                return true;
+            },
+            .ctx = this,
+        };
+    }
+    std::vector<byte> body;
+    bool done = false;
+};
+
+using engine_t = server_engine<fake_transport, 4, 128>;
+
+TEST(CoapBlock, Option)
+{
+    byte buf[4];
+    ASSERT_EQ(opt_uint_encode(0, buf), 0);
+    ASSERT_EQ(opt_uint_encode(0x12, buf), 1);
+    ASSERT_EQ(opt_uint_encode(0x123456, buf), 3);
+    ASSERT_EQ(buf[0], 0x12);
+    ASSERT_EQ(buf[2], 0x56);
+    ASSERT_EQ(opt_uint_decode({buf, 3, 0}), 0x123456);
+
+    block_opt blk = {.num = 5, .more = true, .szx = 2};
+    ASSERT_EQ(blk.size(), 64);
+    ASSERT_EQ(blk.offset(), 320);
+    ASSERT_EQ(blk.value(), 0x5a);
+    ASSERT_EQ(block_opt::from_value(0x5a), blk);
+    ASSERT_EQ(block_opt{.szx = 7}.valid(), false);
+
+    packet pkt;
+    pkt.setup(msg_type::con, msg_code::get, 1, {});
+    block_opt out;
+    ASSERT_EQ(block_get(pkt, option_num::block2, out), false);
+    ASSERT_EQ(opt_insert_uint(pkt, option_num::block2, blk.value()), true);
+    ASSERT_EQ(block_get(pkt, option_num::block2, out), true);
+    ASSERT_EQ(out, blk);
+}
+
+TEST(CoapBlock, AllocPayload)
+{
+    packet<16> pkt;
+    pkt.setup(msg_type::con, msg_code::get, 1, {});
+    auto out = pkt.alloc_payload(5);
+    ASSERT_EQ(out.size(), 5);
+    std::ranges::fill(out, 0x11);
+    ASSERT_EQ(pkt.size(), 10);
+    ASSERT_EQ(pkt.get_payload().size(), 5);
+    pkt.alloc_payload(2);
+    ASSERT_EQ(pkt.size(), 7);
+    ASSERT_EQ(pkt.get_payload()[1], 0x11);
+    ASSERT_EQ(pkt.alloc_payload(20).data(), nullptr);
+    ASSERT_EQ(pkt.size(), 7);
+    pkt.alloc_payload(0);
+    ASSERT_EQ(pkt.size(), 4);
+}
+
+TEST(CoapBlock, Download)
+{
+    fake_transport tr;
+    engine_t e{tr};
+    counting_source src{.size = 1000};
+    std::vector<byte> body;
+    auto fn = [&] (server& s) { s.respond_block(src); };
+
+    ASSERT_EQ(e.feed({make_addr(1), make_request(msg_code::get, 0, option_num::block2, nullptr)}, fn), true);
+    for (word id = 1; ; ++id) {
+        e.flush();
+        packet rsp{tr.sent.back().data};
+        block_opt blk;
+        ASSERT_EQ(rsp.get_code(), +msg_code::content);
+        ASSERT_EQ(block_get(rsp, option_num::block2, blk), true);
+        ASSERT_EQ(blk.szx, 2);
+        ASSERT_EQ(blk.num, id - 1);
+        ASSERT_EQ(rsp.opt_is_set(option_num::size2), !blk.num);
+        body.insert(body.end(), rsp.get_payload().begin(), rsp.get_payload().end());
+        if (!blk.more)
+            break;
+        blk = {.num = blk.num + 1, .szx = blk.szx};
+        ASSERT_EQ(e.feed({make_addr(1), make_request(msg_code::get, id, option_num::block2, &blk)}, fn), true);
+    }
+    ASSERT_EQ(body.size(), src.size);
+    ASSERT_EQ(src.calls, 16);
+    for (size_t i = 0; i < body.size(); ++i)
+        ASSERT_EQ(body[i], byte(i * 7));
+}
+
+TEST(CoapBlock, Small)
+{
+    fake_transport tr;
+    engine_t e{tr};
+    counting_source src{.size = 10};
+    block_opt late = {.num = 1, .szx = 0};
+    block_opt big = {.num = 0, .szx = 6};
+    block_opt bad = {.szx = 7};
+    auto fn = [&] (server& s) { s.respond_block(src); };
+
+    e.feed({make_addr(1), make_request(msg_code::get, 1, option_num::block2, nullptr)}, fn);
+    e.feed({make_addr(1), make_request(msg_code::get, 2, option_num::block2, &big)}, fn);
+    e.feed({make_addr(1), make_request(msg_code::get, 3, option_num::block2, &late)}, fn);
+    e.feed({make_addr(1), make_request(msg_code::get, 4, option_num::block2, &bad)}, fn);
+    e.flush();
+    ASSERT_EQ(tr.sent.size(), 4);
+
+    packet rsp{tr.sent[0].data};
+    block_opt blk;
+    ASSERT_EQ(block_get(rsp, option_num::block2, blk), false);
+    ASSERT_EQ(rsp.get_payload().size(), 10);
+
+    rsp.parse(tr.sent[1].data);
+    ASSERT_EQ(block_get(rsp, option_num::block2, blk), true);
+    ASSERT_EQ(blk, (block_opt{.num = 0, .more = false, .szx = 2}));
+    ASSERT_EQ(rsp.get_payload().size(), 10);
+
+    ASSERT_EQ(packet{tr.sent[2].data}.get_code(), +msg_code::bad_option);
+    ASSERT_EQ(packet{tr.sent[3].data}.get_code(), +msg_code::bad_option);
+}
+
+TEST(CoapBlock, Separate)
+{
+    fake_transport tr;
+    engine_t e{tr};
+    counting_source src{.size = 100};
+    server* pending = nullptr;
+    block_opt blk = {.num = 1, .szx = 1};
+
+    e.feed({make_addr(1), make_request(msg_code::get, 1, option_num::block2, &blk)}, [&] (server& s) { pending = &s; });
+    e.separate_block(*pending, src);
+    e.flush();
+    ASSERT_EQ(tr.sent.size(), 2);
+    packet rsp{tr.sent[1].data};
+    ASSERT_EQ(rsp.get_type(), +msg_type::con);
+    ASSERT_EQ(block_get(rsp, option_num::block2, blk), true);
+    ASSERT_EQ(blk, (block_opt{.num = 1, .more = true, .szx = 1}));
+    ASSERT_EQ(rsp.get_payload()[0], byte(32 * 7));
+}
+
+TEST(CoapBlock, Cache)
+{
+    fake_transport tr;
+    engine_t e{tr};
+    counting_source src{.size = 300};
+    block_cache<8, 64> cache;
+    block_cache<8, 64>::source cached{cache, src};
+    auto fn = [&] (server& s) { s.respond_block(cached, msg_code::content, 2); };
+
+    word id = 0;
+    for (uint32_t num = 0; num < 5; ++num) {
+        block_opt blk = {.num = num, .szx = 2};
+        for (addr_port p = 0; p < 3; ++p)
+            e.feed({make_addr(p), make_request(msg_code::get, id++, option_num::block2, &blk)}, fn);
+    }
+    ASSERT_EQ(src.calls, 5);
+    ASSERT_EQ(cache.misses(), 5);
+    ASSERT_EQ(cache.hits(), 10);
+
+    e.flush();
+    packet a{tr.sent[12].data};
+    packet b{tr.sent[14].data};
+    ASSERT_EQ(a.get_payload().size(), 300 - 256);
+    ASSERT_EQ(std::ranges::equal(a.get_payload(), b.get_payload()), true);
+
+    cache.invalidate(&src);
+    ASSERT_EQ(cache.size(), 0);
+    block_opt blk = {.num = 0, .szx = 2};
+    e.feed({make_addr(1), make_request(msg_code::get, id++, option_num::block2, &blk)}, fn);
+    ASSERT_EQ(src.calls, 6);
+}
+
+TEST(CoapBlock, Upload)
+{
+    fake_transport tr;
+    engine_t e{tr};
+    vector_sink sink;
+    byte chunk[32];
+    auto fn = [&] (server& s) {
+        if (s.receive_block(sink) == block_status::complete)
+            s.respond({}, msg_code::changed);
+    };
+
+    for (uint32_t num = 0; num < 3; ++num) {
+        std::ranges::fill(chunk, byte(num));
+        block_opt blk = {.num = num, .more = num < 2, .szx = 1};
+        e.feed({make_addr(1), make_request(msg_code::put, word(num), option_num::block1, &blk, {chunk, num < 2 ? 32u : 5u})}, fn);
+    }
+    e.flush();
+    ASSERT_EQ(tr.sent.size(), 3);
+    ASSERT_EQ(sink.done, true);
+    ASSERT_EQ(sink.body.size(), 69);
+    ASSERT_EQ(sink.body[68], 2);
+
+    block_opt blk;
+    packet rsp{tr.sent[1].data};
+    ASSERT_EQ(rsp.get_code(), +msg_code::continue_);
+    ASSERT_EQ(block_get(rsp, option_num::block1, blk), true);
+    ASSERT_EQ(blk, (block_opt{.num = 1, .more = true, .szx = 1}));
+    rsp.parse(tr.sent[2].data);
+    ASSERT_EQ(rsp.get_code(), +msg_code::changed);
+    ASSERT_EQ(block_get(rsp, option_num::block1, blk), true);
+    ASSERT_EQ(blk, (block_opt{.num = 2, .more = false, .szx = 1}));
+
+    block_opt gap = {.num = 5, .more = true, .szx = 1};
+    block_opt shorter = {.num = 3, .more = true, .szx = 1};
+    e.feed({make_addr(1), make_request(msg_code::put, 10, option_num::block1, &gap, chunk)}, fn);
+    e.feed({make_addr(1), make_request(msg_code::put, 11, option_num::block1, &shorter, {chunk, 5})}, fn);
+    e.feed({make_addr(1), make_request(msg_code::put, 12, option_num::block1, nullptr, chunk)}, fn);
+    e.flush();
+    ASSERT_EQ(packet{tr.sent[3].data}.get_code(), +msg_code::request_entity_incomplete);
+    ASSERT_EQ(packet{tr.sent[4].data}.get_code(), +msg_code::bad_request);
+    ASSERT_EQ(packet{tr.sent[5].data}.get_code(), +msg_code::request_entity_incomplete);
+}
+
+}
+}
@@ -0,0 +1,121 @@
+#include "test.h"
+#include "nth/coap/builder.h"
+#include <string>
+
+namespace nth::coap {
+namespace {
+
+ispan text(std::string_view str)
+{
+    return {reinterpret_cast<const byte*>(str.data()), str.size()};
+}
+
+option make_opt(option_num num, std::string_view val)
+{
+    return {reinterpret_cast<const byte*>(val.data()), word(val.size()), +num};
+}
+
+TEST(CoapBuilder, SameAsInsert)
+{
+    byte tok[] = {0xde, 0xad, 0xbe, 0xef};
+    std::string long_val(200, 'q');
+    byte no_response[] = {0x1a};
+
+    packet ref;
+    ref.setup(msg_type::con, msg_code::post, 0x4321, tok);
+    ref.set_payload(text("payload"));
+    ref.opt_insert(make_opt(option_num::proxy_uri, long_val));
+    ref.opt_insert(make_opt(option_num::uri_path, "a"));
+    ref.opt_insert(make_opt(option_num::uri_host, "host"));
+    ref.opt_insert(make_opt(option_num::uri_path, "bc"));
+    ref.opt_insert({no_response, 1, +option_num::no_response});
+    ref.opt_insert({nullptr, 0, 2000});
+    opt_insert_uint(ref, option_num::content_format, 50);
+    opt_insert_uint(ref, option_num::observe, 0);
+
+    packet pkt;
+    pkt.parse(text("garbage which must be overwritten"));
+    packet_builder b{pkt, msg_type::con, msg_code::post, 0x4321, tok};
+    ASSERT_EQ(b.add(option_num::uri_host, "host"), true);
+    ASSERT_EQ(b.add_uint(option_num::observe, 0), true);
+    ASSERT_EQ(b.add(option_num::uri_path, "a"), true);
+    ASSERT_EQ(b.add(option_num::uri_path, "bc"), true);
+    ASSERT_EQ(b.add_uint(option_num::content_format, 50), true);
+    ASSERT_EQ(b.add(option_num::proxy_uri, long_val), true);
+    ASSERT_EQ(b.add(option_num::no_response, no_response), true);
+    ASSERT_EQ(b.add(option_num(2000), ispan{}), true);
+    ASSERT_EQ(b.payload(text("payload")), true);
+    ASSERT_EQ(b.ok(), true);
+    ASSERT_EQ(&b.get(), &pkt);
+
+    ASSERT_EQ(std::ranges::equal(pkt, ref), true);
+    ASSERT_EQ(pkt.get_payload().size(), 7);
+
+    packet parsed{ispan{ref}};
+    for (word num : {1, 3, 4, 6, 11, 12, 35, 60, 258, 2000, 65535}) {
+        auto a = pkt.opt_get(option_num(num));
+        auto b = parsed.opt_get(option_num(num));
+        ASSERT_EQ(a.num, b.num);
+        ASSERT_EQ(a.len, b.len);
+        ASSERT_EQ(opt_valid(a), opt_valid(b));
+        if (opt_valid(a)) {
+            ASSERT_EQ(a.dat - pkt.begin(), b.dat - parsed.begin());
+        }
+    }
+    size_t n = 0;
+    for (auto it : pkt.get_options(option_num::uri_path))
+        n += it.len;
+    ASSERT_EQ(n, 3);
+}
+
+TEST(CoapBuilder, InPlace)
+{
+    packet<32> pkt;
+    packet_builder b{pkt, msg_type::non, msg_code::content, 1, {}};
+    auto out = b.payload(10);
+    ASSERT_EQ(out.size(), 10);
+    std::ranges::fill(out, 'z');
+    ASSERT_EQ(pkt.size(), 15);
+    ASSERT_EQ(pkt.get_payload()[9], 'z');
+    ASSERT_EQ(b.add(option_num::uri_path, "late"), false);
+    ASSERT_EQ(b.ok(), false);
+}
+
+TEST(CoapBuilder, Failure)
+{
+    packet<16> pkt;
+    {
+        packet_builder b{pkt, msg_type::con, msg_code::get, 1, {}};
+        ASSERT_EQ(b.add(option_num::uri_path, "x"), true);
+        ASSERT_EQ(b.add(option_num::uri_host, "y"), false);
+        ASSERT_EQ(b.add(option_num::uri_path, "z"), false);
+        ASSERT_EQ(b.ok(), false);
+    }
+    {
+        packet_builder b{pkt, msg_type::con, msg_code::get, 1, {}};
+        ASSERT_EQ(b.add(option_num::uri_path, "0123456789"), true);
+        ASSERT_EQ(b.add(option_num::uri_path, "0123456789"), false);
+        ASSERT_EQ(b.payload(text("x")), false);
+        ASSERT_EQ(b.ok(), false);
+    }
+    {
+        byte tok[9] = {};
+        packet_builder b{pkt, msg_type::con, msg_code::get, 1, tok};
+        ASSERT_EQ(b.ok(), false);
+    }
+}
+
+constexpr bool build_constexpr()
+{
+    byte buf[16] = {};
+    packet_view pkt{buf};
+    packet_builder b{pkt, msg_type::con, msg_code::get, 7, {}};
+    b.add_uint(option_num::uri_port, 5683);
+    b.add_uint(option_num::max_age, 60);
+    return b.ok() && pkt.size() == 9 && opt_uint_decode(pkt.opt_get(option_num::max_age)) == 60;
+}
+
+static_assert(build_constexpr());
+
+}
+}
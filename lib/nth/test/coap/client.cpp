@@ -0,0 +1,521 @@
+#include "test_coap.h"
+#include "nth/coap/client.h"
+#include "nth/coap/engine.h"
+#include <random>
+#include <vector>
+
+namespace nth::coap {
+namespace {
+
+struct completion {
+    size_t handle;
+    client_result res;
+    std::vector<byte> payload;
+};
+
+struct recorder {
+    void operator()(size_t handle, client_result res, const packet_view& rsp)
+    {
+        std::vector<byte> pld;
+        if (res == client_result::response)
+            pld.assign(rsp.get_payload().begin(), rsp.get_payload().end());
+        done.push_back({handle, res, pld});
+    }
+    std::vector<completion> done;
+};
+
+std::vector<byte> make_response(msg_type t, word id, ispan tok, std::string_view text = {})
+{
+    packet pkt;
+    pkt.setup(t, msg_code::content, id, tok);
+    pkt.set_payload({reinterpret_cast<const byte*>(text.data()), text.size()});
+    return {pkt.begin(), pkt.end()};
+}
+
+using client_t = client_engine<fake_transport, 8, 64>;
+
+TEST(CoapClient, Piggybacked)
+{
+    fake_transport tr;
+    client_t c{tr, 100};
+    recorder rec;
+    option path = {reinterpret_cast<const byte*>("scan"), 4, +option_num::uri_path};
+
+    auto h = c.request(make_addr(5683), msg_code::get, {}, {&path, 1});
+    ASSERT_LT(h, c.capacity());
+    ASSERT_EQ(c.outstanding(make_addr(5683)), 1);
+    ASSERT_EQ(c.flush(), 1);
+
+    packet req{tr.sent[0].data};
+    ASSERT_EQ(tr.sent[0].addr, make_addr(5683));
+    ASSERT_EQ(req.get_type(), +msg_type::con);
+    ASSERT_EQ(req.get_code(), +msg_code::get);
+    ASSERT_EQ(req.get_id(), 100);
+    ASSERT_EQ(req.get_tkl(), 4);
+    ASSERT_EQ(req.opt_get(option_num::uri_path).len, 4);
+
+    auto rsp = make_response(msg_type::ack, 100, req.get_token(), "ok");
+    auto other = make_response(msg_type::ack, 100, std::vector<byte>{1, 2, 3, 4}, "no");
+    ASSERT_EQ(c.feed({make_addr(5683), other}, rec), false);
+    ASSERT_EQ(c.feed({make_addr(5684), rsp}, rec), false);
+    ASSERT_EQ(c.feed({make_addr(5683), rsp}, rec), true);
+    ASSERT_EQ(rec.done.size(), 1);
+    ASSERT_EQ(rec.done[0].handle, h);
+    ASSERT_EQ(rec.done[0].res, client_result::response);
+    ASSERT_EQ(rec.done[0].payload, (std::vector<byte>{'o', 'k'}));
+    ASSERT_EQ(c.empty(), true);
+    ASSERT_EQ(c.outstanding(make_addr(5683)), 0);
+
+    ASSERT_EQ(c.feed({make_addr(5683), rsp}, rec), false);
+    ASSERT_EQ(rec.done.size(), 1);
+}
+
+TEST(CoapClient, NStartPipelining)
+{
+    fake_transport tr;
+    client_t c{tr, 1};
+    recorder rec;
+
+    auto h1 = c.request(make_addr(1), msg_code::post);
+    auto h2 = c.request(make_addr(1), msg_code::post);
+    auto h3 = c.request(make_addr(1), msg_code::post);
+    auto h4 = c.request(make_addr(2), msg_code::post);
+    ASSERT_EQ(c.size(), 4);
+    ASSERT_EQ(c.flush(), 2);
+    ASSERT_EQ(tr.sent[0].addr, make_addr(1));
+    ASSERT_EQ(tr.sent[1].addr, make_addr(2));
+    ASSERT_EQ(c.outstanding(make_addr(1)), 1);
+
+    packet r1{tr.sent[0].data};
+    ASSERT_EQ(c.feed({make_addr(1), make_response(msg_type::ack, r1.get_id(), r1.get_token())}, rec), true);
+    ASSERT_EQ(c.flush(), 1);
+    ASSERT_EQ(tr.sent[2].addr, make_addr(1));
+
+    packet r2{tr.sent[2].data};
+    ASSERT_EQ(c.feed({make_addr(1), make_empty(msg_type::ack, r2.get_id())}, rec), true);
+    ASSERT_EQ(c.flush(), 1);
+    ASSERT_EQ(c.outstanding(make_addr(1)), 1);
+
+    packet r3{tr.sent[3].data};
+    ASSERT_EQ(c.feed({make_addr(1), make_response(msg_type::ack, r3.get_id(), r3.get_token())}, rec), true);
+    ASSERT_EQ(c.feed({make_addr(1), make_response(msg_type::non, 555, r2.get_token())}, rec), true);
+
+    ASSERT_EQ(rec.done.size(), 3);
+    ASSERT_EQ(rec.done[0].handle, h1);
+    ASSERT_EQ(rec.done[1].handle, h3);
+    ASSERT_EQ(rec.done[2].handle, h2);
+    ASSERT_EQ(c.size(), 1);
+    ASSERT_EQ(c.cancel(h4), true);
+    ASSERT_EQ(c.cancel(h4), false);
+    ASSERT_EQ(c.empty(), true);
+}
+
+TEST(CoapClient, RetransmissionAndTimeout)
+{
+    fake_transport tr;
+    client_t c{tr};
+    recorder rec;
+
+    auto h = c.request(make_addr(1), msg_code::get);
+    c.poll(0, rec);
+    ASSERT_EQ(tr.sent.size(), 1);
+
+    timestamp t = 0;
+    while (tr.sent.size() == 1 && t <= imp::ack_timeout * imp::ack_random_factor)
+        c.poll(++t, rec);
+    ASSERT_GE(t, imp::ack_timeout);
+    ASSERT_LE(t, imp::ack_timeout * imp::ack_random_factor);
+    ASSERT_EQ(tr.sent.size(), 2);
+    ASSERT_EQ(tr.sent[1].data, tr.sent[0].data);
+
+    auto timeout = t;
+    for (int i = 1; i < imp::max_retransmit_cnt; ++i) {
+        timeout *= 2;
+        t += timeout;
+        c.poll(t - 1, rec);
+        ASSERT_EQ(tr.sent.size(), size_t(i + 1));
+        c.poll(t, rec);
+        ASSERT_EQ(tr.sent.size(), size_t(i + 2));
+    }
+    ASSERT_EQ(rec.done.size(), 0);
+    c.poll(t + 2 * timeout, rec);
+    ASSERT_EQ(rec.done.size(), 1);
+    ASSERT_EQ(rec.done[0].handle, h);
+    ASSERT_EQ(rec.done[0].res, client_result::timeout);
+    ASSERT_EQ(c.empty(), true);
+}
+
+TEST(CoapClient, SeparateResponse)
+{
+    fake_transport tr;
+    client_t c{tr, 7};
+    recorder rec;
+
+    c.request(make_addr(1), msg_code::get);
+    c.flush();
+    packet req{tr.sent[0].data};
+
+    ASSERT_EQ(c.feed({make_addr(1), make_empty(msg_type::ack, 7)}, rec), true);
+    ASSERT_EQ(c.outstanding(make_addr(1)), 0);
+    c.poll(imp::ack_timeout * 10, rec);
+    ASSERT_EQ(tr.sent.size(), 1);
+
+    auto rsp = make_response(msg_type::con, 0x4242, req.get_token(), "late");
+    ASSERT_EQ(c.feed({make_addr(1), rsp}, rec), true);
+    ASSERT_EQ(c.feed({make_addr(1), rsp}, rec), true);
+    ASSERT_EQ(c.flush(), 2);
+    ASSERT_EQ(rec.done.size(), 1);
+    ASSERT_EQ(rec.done[0].payload.size(), 4);
+    for (size_t i = 1; i < 3; ++i) {
+        packet ack{tr.sent[i].data};
+        ASSERT_EQ(ack.get_type(), +msg_type::ack);
+        ASSERT_EQ(ack.get_code(), +msg_code::empty);
+        ASSERT_EQ(ack.get_id(), 0x4242);
+    }
+
+    auto stray = make_response(msg_type::con, 0x4343, std::vector<byte>{9}, "?");
+    ASSERT_EQ(c.feed({make_addr(1), stray}, rec), false);
+    ASSERT_EQ(c.flush(), 1);
+    ASSERT_EQ(packet{tr.sent[3].data}.get_type(), +msg_type::rst);
+}
+
+TEST(CoapClient, SeparateResponseTimeout)
+{
+    fake_transport tr;
+    client_t c{tr, 7};
+    recorder rec;
+
+    c.request(make_addr(1), msg_code::get);
+    ASSERT_EQ(c.feed({make_addr(1), make_empty(msg_type::ack, 7)}, rec), true);
+    c.poll(imp::exchange_lifetime - 1, rec);
+    ASSERT_EQ(rec.done.size(), 0);
+    c.poll(imp::exchange_lifetime, rec);
+    ASSERT_EQ(rec.done.size(), 1);
+    ASSERT_EQ(rec.done[0].res, client_result::timeout);
+}
+
+TEST(CoapClient, Reset)
+{
+    fake_transport tr;
+    client_t c{tr, 3};
+    recorder rec;
+
+    auto h = c.request(make_addr(1), msg_code::delete_);
+    ASSERT_EQ(c.feed({make_addr(1), make_empty(msg_type::rst, 4)}, rec), false);
+    ASSERT_EQ(c.feed({make_addr(1), make_empty(msg_type::rst, 3)}, rec), true);
+    ASSERT_EQ(rec.done.size(), 1);
+    ASSERT_EQ(rec.done[0].handle, h);
+    ASSERT_EQ(rec.done[0].res, client_result::reset);
+    ASSERT_EQ(c.empty(), true);
+
+    rec.done.clear();
+    auto n1 = c.request(make_addr(1), msg_code::post, {}, {}, false);
+    c.poll(imp::ack_timeout * 1000, rec);
+    auto n2 = c.request(make_addr(1), msg_code::post, {}, {}, false);
+    c.flush();
+    ASSERT_EQ(c.feed({make_addr(1), make_empty(msg_type::ack, 5)}, rec), false);
+    ASSERT_EQ(c.feed({make_addr(1), make_empty(msg_type::rst, 5)}, rec), true);
+    ASSERT_EQ(c.feed({make_addr(1), make_empty(msg_type::rst, 4)}, rec), true);
+    ASSERT_EQ(rec.done.size(), 2);
+    ASSERT_EQ(rec.done[0].handle, n2);
+    ASSERT_EQ(rec.done[1].handle, n1);
+    ASSERT_EQ(rec.done[0].res, client_result::reset);
+    ASSERT_EQ(rec.done[1].res, client_result::reset);
+    ASSERT_EQ(c.empty(), true);
+}
+
+TEST(CoapClient, NonConfirmablePacing)
+{
+    fake_transport tr;
+    client_t c{tr};
+    recorder rec;
+
+    c.request(make_addr(1), msg_code::post, {}, {}, false);
+    auto h2 = c.request(make_addr(1), msg_code::post, {}, {}, false);
+    c.flush();
+    ASSERT_EQ(tr.sent.size(), 1);
+    packet r1{tr.sent[0].data};
+    ASSERT_EQ(r1.get_type(), +msg_type::non);
+
+    // NOTE: Outstanding only until RTO, then probing rate holds the next one back
+    auto probe = timestamp(r1.size()) * 1000 / NTH_COAP_PROBING_RATE;
+    c.poll(imp::ack_timeout, rec);
+    ASSERT_EQ(c.outstanding(make_addr(1)), 0);
+    ASSERT_EQ(tr.sent.size(), 1);
+    c.poll(probe, rec);
+    ASSERT_EQ(tr.sent.size(), 2);
+
+    packet r2{tr.sent[1].data};
+    ASSERT_EQ(c.feed({make_addr(1), make_response(msg_type::non, 1, r2.get_token())}, rec), true);
+    ASSERT_EQ(rec.done.size(), 1);
+    ASSERT_EQ(rec.done[0].handle, h2);
+
+    c.request(make_addr(1), msg_code::post, {}, {}, false);
+    ASSERT_EQ(c.flush(), 1);
+}
+
+TEST(CoapClient, CongestionEstimate)
+{
+    cocoa_rto r;
+    ASSERT_EQ(r.rto(), imp::ack_timeout);
+
+    for (int i = 0; i < 20; ++i)
+        r.update(100, 0, 1000);
+    ASSERT_GT(r.rto(), 100);
+    ASSERT_LT(r.rto(), 250);
+
+    auto fast = r.rto();
+    r.age(1000 + 16 * fast);
+    ASSERT_EQ(r.rto(), fast);
+    r.age(1001 + 16 * fast);
+    ASSERT_EQ(r.rto(), (1000 + fast) / 2);
+
+    fast = r.rto();
+    r.update(3000, 1, 1000);
+    ASSERT_GT(r.rto(), fast);
+    auto weak = r.rto();
+    r.update(100000, 3, 1000);
+    ASSERT_EQ(r.rto(), weak);
+
+    ASSERT_EQ(cocoa_rto::backoff(500, 500), 1500);
+    ASSERT_EQ(cocoa_rto::backoff(2000, 2000), 4000);
+    ASSERT_EQ(cocoa_rto::backoff(4000, 4000), 6000);
+
+    fake_transport tr;
+    client_t c{tr};
+    recorder rec;
+    c.request(make_addr(1), msg_code::get);
+    c.poll(40, rec);
+    packet req{tr.sent[0].data};
+    ASSERT_EQ(c.feed({make_addr(1), make_response(msg_type::ack, req.get_id(), req.get_token())}, rec), true);
+    ASSERT_LT(c.rto(make_addr(1)), imp::ack_timeout);
+    ASSERT_EQ(c.rto(make_addr(2)), imp::ack_timeout);
+}
+
+struct body_sink {
+    operator payload_sink()
+    {
+        return {
+            .write = [] (void* ctx, size_t offset, ispan data, bool last) {
+                auto self = static_cast<body_sink*>(ctx);
+                if (offset != self->data.size() || self->last)
+                    return false;
+                self->data.insert(self->data.end(), data.begin(), data.end());
+                self->last = last;
+                return true;
+            },
+            .ctx = this,
+        };
+    }
+    std::vector<byte> data;
+    bool last = false;
+};
+
+TEST(CoapClient, BlockWise)
+{
+    std::vector<byte> up(100), down(200);
+    for (size_t i = 0; i < up.size(); ++i)
+        up[i] = byte(i);
+    for (size_t i = 0; i < down.size(); ++i)
+        down[i] = byte(i * 7);
+
+    fake_transport ctr, str;
+    client_t c{ctr};
+    server_engine<fake_transport, 4, 64> e{str};
+    recorder rec;
+    body_sink received, fetched;
+    auto serve = [&] (server& s) {
+        block_opt blk;
+        if (block_get(s.get_packet(), option_num::block2, blk) || s.receive_block(received) == block_status::complete)
+            s.respond_block(payload_source::from(down));
+    };
+    option path = {reinterpret_cast<const byte*>("up"), 2, +option_num::uri_path};
+
+    auto h = c.request_block(make_addr(1), msg_code::post, payload_source::from(up), fetched, {&path, 1});
+    ASSERT_LT(h, c.capacity());
+    size_t exchanges = 0;
+    for (timestamp t = 0; rec.done.empty() && t < 100; ++t) {
+        c.poll(t, rec);
+        for (auto& it : std::exchange(ctr.sent, {})) {
+            ASSERT_LE(it.data.size(), 64);
+            ASSERT_EQ(packet{it.data}.opt_get(option_num::uri_path).len, 2);
+            e.feed({make_addr(2), it.data}, serve);
+            ++exchanges;
+        }
+        e.flush();
+        for (auto& it : std::exchange(str.sent, {}))
+            c.feed({make_addr(1), it.data}, rec);
+    }
+    ASSERT_EQ(rec.done.size(), 1);
+    ASSERT_EQ(rec.done[0].handle, h);
+    ASSERT_EQ(rec.done[0].res, client_result::response);
+    ASSERT_EQ(received.data, up);
+    ASSERT_EQ(received.last, true);
+    ASSERT_EQ(fetched.data, down);
+    ASSERT_EQ(fetched.last, true);
+    ASSERT_EQ(exchanges, 4 + 6);
+    ASSERT_EQ(c.empty(), true);
+
+    rec.done.clear();
+    const byte small[] = {1, 2, 3};
+    c.request_block(make_addr(1), msg_code::put, payload_source::from(small));
+    c.flush();
+    packet req{ctr.sent[0].data};
+    ASSERT_EQ(req.opt_is_set(option_num::block1), false);
+    ASSERT_EQ(req.get_payload().size(), 3);
+    ASSERT_EQ(c.feed({make_addr(1), make_response(msg_type::ack, req.get_id(), req.get_token(), "ok")}, rec), true);
+    ASSERT_EQ(rec.done.size(), 1);
+    ASSERT_EQ(rec.done[0].payload, (std::vector<byte>{'o', 'k'}));
+}
+
+TEST(CoapClient, BlockAheadOfQueue)
+{
+    std::vector<byte> up(100);
+    fake_transport tr;
+    client_t c{tr};
+    recorder rec;
+
+    auto h = c.request_block(make_addr(1), msg_code::post, payload_source::from(up), {}, {}, true, 1);
+    auto g = c.request(make_addr(1), msg_code::get);
+    c.flush();
+    ASSERT_EQ(tr.sent.size(), 1);
+
+    for (uint32_t num = 0; num < 3; ++num) {
+        packet req{tr.sent.back().data};
+        block_opt blk;
+        ASSERT_EQ(req.get_code(), +msg_code::post);
+        ASSERT_EQ(block_get(req, option_num::block1, blk), true);
+        ASSERT_EQ(blk.num, num);
+
+        packet rsp;
+        rsp.setup(msg_type::ack, msg_code::continue_, req.get_id(), req.get_token());
+        opt_insert_uint(rsp, option_num::block1, block_opt{.num = num, .more = true, .szx = 1}.value());
+        ASSERT_EQ(c.feed({make_addr(1), {rsp.begin(), rsp.end()}}, rec), true);
+        c.flush();
+        ASSERT_EQ(tr.sent.size(), num + 2);
+    }
+    packet last{tr.sent.back().data};
+    ASSERT_EQ(last.get_code(), +msg_code::post);
+    ASSERT_EQ(c.feed({make_addr(1), make_response(msg_type::ack, last.get_id(), last.get_token())}, rec), true);
+    c.flush();
+    ASSERT_EQ(rec.done.size(), 1);
+    ASSERT_EQ(rec.done[0].handle, h);
+    ASSERT_EQ(packet{tr.sent.back().data}.get_code(), +msg_code::get);
+    ASSERT_EQ(c.outstanding(make_addr(1)), 1);
+    ASSERT_NE(g, c.capacity());
+}
+
+TEST(CoapClient, BlockNegotiation)
+{
+    std::vector<byte> up(100);
+    fake_transport tr;
+    client_t c{tr};
+    recorder rec;
+    body_sink fetched;
+    auto rsp_block = [] (const packet_view& req, msg_code code, option_num num, block_opt blk) {
+        packet rsp;
+        rsp.setup(msg_type::ack, code, req.get_id(), req.get_token());
+        opt_insert_uint(rsp, num, blk.value());
+        return std::vector<byte>{rsp.begin(), rsp.end()};
+    };
+
+    c.request_block(make_addr(1), msg_code::put, payload_source::from(up), fetched);
+    c.flush();
+    packet r1{tr.sent[0].data};
+    block_opt blk;
+    ASSERT_EQ(block_get(r1, option_num::block1, blk), true);
+    ASSERT_EQ(blk, (block_opt{.num = 0, .more = true, .szx = 1}));
+    ASSERT_EQ(r1.get_payload().size(), 32);
+
+    ASSERT_EQ(c.feed({make_addr(1), rsp_block(r1, msg_code::continue_, option_num::block1, {0, true, 0})}, rec), true);
+    c.flush();
+    packet r2{tr.sent[1].data};
+    ASSERT_EQ(r2.get_token()[0], r1.get_token()[0]);
+    ASSERT_NE(r2.get_id(), r1.get_id());
+    ASSERT_EQ(block_get(r2, option_num::block1, blk), true);
+    ASSERT_EQ(blk, (block_opt{.num = 2, .more = true, .szx = 0}));
+    ASSERT_EQ(r2.get_payload().size(), 16);
+
+    ASSERT_EQ(c.feed({make_addr(1), rsp_block(r2, msg_code::continue_, option_num::block1, {2, true, 0})}, rec), true);
+    c.flush();
+    packet r3{tr.sent[2].data};
+    ASSERT_EQ(c.feed({make_addr(1), rsp_block(r3, msg_code::changed, option_num::block2, {1, true, 0})}, rec), true);
+    ASSERT_EQ(rec.done.size(), 1);
+    ASSERT_EQ(rec.done[0].res, client_result::incomplete);
+    ASSERT_EQ(c.empty(), true);
+
+    c.request_block(make_addr(1), msg_code::put, payload_source::from(up));
+    c.flush();
+    packet r4{tr.sent[3].data};
+    ASSERT_EQ(c.feed({make_addr(1), rsp_block(r4, msg_code::request_entity_too_large, option_num::block1, {0, false, 0})}, rec), true);
+    ASSERT_EQ(rec.done.size(), 2);
+    ASSERT_EQ(rec.done[1].res, client_result::response);
+}
+
+/**
+ * @brief Client and server engines connected through lossy in-memory
+ * link. Every datagram in either direction is dropped with given
+ * probability, time advances in fixed steps.
+ */
+struct lossy_link {
+    struct pipe {
+        size_t send(std::span<const datagram> batch)
+        {
+            for (auto& it : batch)
+                if (std::bernoulli_distribution{loss}(*gen) == false)
+                    queue.push_back({it.addr, {it.data.begin(), it.data.end()}});
+            return batch.size();
+        }
+        double loss;
+        std::mt19937* gen;
+        std::vector<fake_transport::entry> queue = {};
+    };
+
+    size_t run(double loss, size_t total)
+    {
+        std::mt19937 gen{42};
+        pipe up{loss, &gen}, down{loss, &gen};
+        client_engine<pipe, 16, 64, 4> cli{up, 0, 7};
+        server_engine<pipe, 16, 64> srv{down, 1000};
+
+        auto cli_addr = make_addr(40000);
+        auto srv_addr = make_addr(5683);
+        size_t sent = 0, ok = 0, failed = 0;
+        auto on_done = [&] (size_t, client_result res, const packet_view& rsp) {
+            if (res == client_result::response && rsp.get_payload().size() == 2)
+                ++ok;
+            else
+                ++failed;
+        };
+        auto serve = [] (server& s) {
+            const byte pld[] = {'o', 'k'};
+            s.respond(pld);
+        };
+        const byte data[32] = {};
+
+        for (timestamp t = 0; ok + failed < total; t += 10) {
+            while (sent < total && !cli.full()) {
+                cli.request(srv_addr, msg_code::post, data);
+                ++sent;
+            }
+            cli.poll(t, on_done);
+            for (auto& it : std::exchange(up.queue, {}))
+                srv.feed({cli_addr, it.data}, serve);
+            srv.poll(t);
+            for (auto& it : std::exchange(down.queue, {}))
+                cli.feed({srv_addr, it.data}, on_done);
+        }
+        return ok;
+    }
+};
+
+TEST(CoapClient, LoopbackUnderLoss)
+{
+    for (auto loss : {0.0, 0.1, 0.2}) {
+        auto ok = lossy_link{}.run(loss, 200);
+        ASSERT_GE(ok, loss ? 196 : 200) << loss;
+    }
+}
+
+}
+}
@@ -0,0 +1,64 @@
+#include "test_coap.h"
+#include "nth/coap/dedup.h"
+
+namespace nth::coap {
+namespace {
+
+TEST(CoapDedup, FindInsert)
+{
+    dedup_cache<4, 16> c{100};
+
+    ASSERT_EQ(c.find(make_addr(1), 1, 0), nullptr);
+    auto& e = c.insert(make_addr(1), 1, 0);
+    ASSERT_EQ(e.replayable(), false);
+    ASSERT_EQ(c.find(make_addr(1), 1, 0), &e);
+    ASSERT_EQ(c.find(make_addr(2), 1, 0), nullptr);
+    ASSERT_EQ(c.find(make_addr(1), 2, 0), nullptr);
+
+    const byte rsp[] = {0x60, 0x45, 0x00, 0x01};
+    ASSERT_EQ(e.store(rsp), true);
+    ASSERT_EQ(e.replayable(), true);
+    ASSERT_EQ(e.response().size(), 4);
+    ASSERT_EQ(e.response()[1], 0x45);
+
+    const byte big[17] = {};
+    ASSERT_EQ(e.store(big), false);
+    ASSERT_EQ(e.response().size(), 4);
+}
+
+TEST(CoapDedup, Expire)
+{
+    dedup_cache<4, 16> c{100};
+
+    c.insert(make_addr(1), 1, 0);
+    c.insert(make_addr(1), 2, 50);
+    ASSERT_EQ(c.size(), 2);
+    ASSERT_NE(c.find(make_addr(1), 1, 99), nullptr);
+    ASSERT_EQ(c.find(make_addr(1), 1, 100), nullptr);
+    ASSERT_EQ(c.size(), 1);
+    ASSERT_NE(c.find(make_addr(1), 2, 149), nullptr);
+    c.evict(150);
+    ASSERT_EQ(c.empty(), true);
+    ASSERT_EQ(c.overflows(), 0);
+}
+
+TEST(CoapDedup, EvictOldest)
+{
+    dedup_cache<4, 16> c{100};
+
+    for (word id = 0; id < 10; ++id) {
+        c.insert(make_addr(1), id, 0);
+        ASSERT_EQ(c.size(), std::min<size_t>(id + 1, 4));
+    }
+    ASSERT_EQ(c.full(), true);
+    ASSERT_EQ(c.overflows(), 6);
+    for (word id = 0; id < 6; ++id)
+        ASSERT_EQ(c.find(make_addr(1), id, 0), nullptr);
+    for (word id = 6; id < 10; ++id)
+        ASSERT_NE(c.find(make_addr(1), id, 0), nullptr);
+    c.clear();
+    ASSERT_EQ(c.find(make_addr(1), 9, 0), nullptr);
+}
+
+}
+}
@@ -0,0 +1,350 @@
+#include "test_coap.h"
+#include "nth/coap/engine.h"
+#include "nth/coap/udp.h"
+#include <vector>
+
+namespace nth::coap {
+namespace {
+
+std::vector<byte> make_request(msg_type t, word id, std::initializer_list<byte> tok)
+{
+    packet pkt;
+    pkt.setup(t, msg_code::get, id, std::vector<byte>(tok));
+    return {pkt.begin(), pkt.end()};
+}
+
+auto reply(std::string_view text)
+{
+    return [text] (server& s) {
+        s.respond({reinterpret_cast<const byte*>(text.data()), text.size()});
+    };
+}
+
+using engine_t = server_engine<fake_transport, 8, 64, 4>;
+
+TEST(CoapEngine, Piggybacked)
+{
+    fake_transport tr;
+    engine_t e{tr, 100};
+    auto req = make_request(msg_type::con, 0x1234, {1, 2, 3});
+
+    ASSERT_EQ(e.feed({make_addr(5683), req}, reply("hi")), true);
+    ASSERT_EQ(e.empty(), true);
+    ASSERT_EQ(e.flush(), 1);
+    ASSERT_EQ(tr.sent.size(), 1);
+    ASSERT_EQ(tr.sent[0].addr, make_addr(5683));
+
+    packet rsp{tr.sent[0].data};
+    ASSERT_EQ(rsp.get_type(), +msg_type::ack);
+    ASSERT_EQ(rsp.get_code(), +msg_code::content);
+    ASSERT_EQ(rsp.get_id(), 0x1234);
+    ASSERT_EQ(rsp.get_tkl(), 3);
+    ASSERT_EQ(rsp.get_token()[2], 3);
+    ASSERT_EQ(rsp.get_payload().size(), 2);
+    ASSERT_EQ(rsp.get_payload()[0], 'h');
+}
+
+TEST(CoapEngine, NonConfirmable)
+{
+    fake_transport tr;
+    engine_t e{tr, 100};
+    auto req = make_request(msg_type::non, 7, {9});
+
+    ASSERT_EQ(e.feed({make_addr(1), req}, reply("x")), true);
+    ASSERT_EQ(e.empty(), true);
+    e.flush();
+    ASSERT_EQ(tr.sent.size(), 1);
+
+    packet rsp{tr.sent[0].data};
+    ASSERT_EQ(rsp.get_type(), +msg_type::non);
+    ASSERT_EQ(rsp.get_id(), 100);
+    ASSERT_EQ(rsp.get_token()[0], 9);
+}
+
+TEST(CoapEngine, SeparateWithRetransmission)
+{
+    fake_transport tr;
+    engine_t e{tr, 100};
+    server* pending = nullptr;
+    auto req = make_request(msg_type::con, 1, {5, 5});
+
+    ASSERT_EQ(e.feed({make_addr(1), req}, [&] (server& s) { pending = &s; }), true);
+    ASSERT_NE(pending, nullptr);
+    ASSERT_EQ(e.size(), 1);
+    e.flush();
+    ASSERT_EQ(tr.sent.size(), 1);
+    ASSERT_EQ(packet{tr.sent[0].data}.get_code(), +msg_code::empty);
+
+    e.separate(*pending, {}, msg_code::changed);
+    e.poll(0);
+    ASSERT_EQ(tr.sent.size(), 2);
+    packet rsp{tr.sent[1].data};
+    ASSERT_EQ(rsp.get_type(), +msg_type::con);
+    ASSERT_EQ(rsp.get_code(), +msg_code::changed);
+    ASSERT_EQ(rsp.get_id(), 100);
+
+    e.poll(imp::ack_timeout - 1);
+    ASSERT_EQ(tr.sent.size(), 2);
+    e.poll(imp::ack_timeout);
+    ASSERT_EQ(tr.sent.size(), 3);
+    ASSERT_EQ(tr.sent[2].data, tr.sent[1].data);
+
+    ASSERT_EQ(e.feed({make_addr(2), make_empty(msg_type::ack, 100)}, reply("")), false);
+    ASSERT_EQ(e.feed({make_addr(1), make_empty(msg_type::ack, 101)}, reply("")), false);
+    ASSERT_EQ(e.feed({make_addr(1), make_empty(msg_type::ack, 100)}, reply("")), true);
+    ASSERT_EQ(e.empty(), true);
+}
+
+TEST(CoapEngine, Duplicate)
+{
+    fake_transport tr;
+    engine_t e{tr, 100};
+    size_t calls = 0;
+    auto fn = [&] (server& s) {
+        ++calls;
+        s.respond({});
+    };
+    auto con = make_request(msg_type::con, 1, {1});
+    auto non = make_request(msg_type::non, 2, {2});
+    auto con_other = make_request(msg_type::con, 3, {1});
+
+    ASSERT_EQ(e.feed({make_addr(1), con}, fn), true);
+    ASSERT_EQ(e.feed({make_addr(1), con}, fn), true);
+    ASSERT_EQ(e.feed({make_addr(1), non}, fn), true);
+    ASSERT_EQ(e.feed({make_addr(1), non}, fn), true);
+    ASSERT_EQ(e.feed({make_addr(2), con}, fn), true);
+    ASSERT_EQ(e.feed({make_addr(1), con_other}, fn), true);
+    ASSERT_EQ(calls, 4);
+    e.flush();
+    ASSERT_EQ(tr.sent.size(), 5);
+    ASSERT_EQ(tr.sent[0].data, tr.sent[1].data);
+    ASSERT_EQ(packet{tr.sent[2].data}.get_type(), +msg_type::non);
+
+    e.poll(imp::exchange_lifetime);
+    ASSERT_EQ(e.feed({make_addr(1), con}, fn), true);
+    ASSERT_EQ(calls, 5);
+}
+
+TEST(CoapEngine, DuplicateAfterManyRequests)
+{
+    fake_transport tr;
+    engine_t e{tr, 100};
+    size_t calls = 0;
+    auto fn = [&] (server& s) {
+        ++calls;
+        s.respond({});
+    };
+    for (word id = 0; id < 4 * engine_t::capacity(); ++id)
+        ASSERT_EQ(e.feed({make_addr(1), make_request(msg_type::con, id, {byte(id)})}, fn), true);
+    ASSERT_EQ(e.feed({make_addr(1), make_request(msg_type::con, 0, {0})}, fn), true);
+    ASSERT_EQ(calls, 4 * engine_t::capacity());
+    ASSERT_EQ(e.dedup_overflows(), 0);
+
+    server_engine<fake_transport, 8, 64, 4, 4> small{tr};
+    for (word id = 0; id < 5; ++id)
+        small.feed({make_addr(1), make_request(msg_type::con, id, {byte(id)})}, fn);
+    ASSERT_EQ(small.dedup_overflows(), 1);
+}
+
+TEST(CoapEngine, DuplicateSeparate)
+{
+    fake_transport tr;
+    engine_t e{tr, 100};
+    size_t calls = 0;
+    auto req = make_request(msg_type::con, 1, {5, 5});
+
+    ASSERT_EQ(e.feed({make_addr(1), req}, [&] (server&) { ++calls; }), true);
+    ASSERT_EQ(e.feed({make_addr(1), req}, [&] (server&) { ++calls; }), true);
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(e.size(), 1);
+    e.flush();
+    ASSERT_EQ(tr.sent.size(), 2);
+    ASSERT_EQ(packet{tr.sent[1].data}.get_code(), +msg_code::empty);
+    ASSERT_EQ(packet{tr.sent[1].data}.get_id(), 1);
+}
+
+TEST(CoapEngine, GiveUp)
+{
+    fake_transport tr;
+    engine_t e{tr};
+    auto req = make_request(msg_type::con, 1, {});
+
+    e.feed({make_addr(1), req}, [] (server&) {});
+    server* s = nullptr;
+    e.feed({make_addr(2), req}, [&] (server& x) { s = &x; });
+    e.separate(*s, {});
+    for (timestamp t = 0; t < 1000000 && e.size() > 1; t += 1000)
+        e.poll(t);
+    ASSERT_EQ(e.size(), 1);
+    e.flush();
+    ASSERT_EQ(tr.sent.size(), 2 + 1 + imp::max_retransmit_cnt);
+
+    e.poll(imp::exchange_lifetime - 1);
+    ASSERT_EQ(e.size(), 1);
+    e.poll(imp::exchange_lifetime);
+    ASSERT_EQ(e.empty(), true);
+}
+
+TEST(CoapEngine, ManyClients)
+{
+    fake_transport tr;
+    engine_t e{tr};
+    std::vector<std::vector<byte>> reqs;
+    std::vector<datagram> batch;
+
+    for (addr_port p = 0; p < 100; ++p)
+        reqs.push_back(make_request(p & 1 ? msg_type::con : msg_type::non, p, {byte(p), 1}));
+    for (addr_port p = 0; p < 100; ++p)
+        batch.push_back({make_addr(p), reqs[p]});
+
+    ASSERT_EQ(e.feed(batch, reply("ok")), 100);
+    ASSERT_EQ(e.empty(), true);
+    e.flush();
+    ASSERT_EQ(tr.sent.size(), 100);
+    for (addr_port p = 0; p < 100; ++p) {
+        packet rsp{tr.sent[p].data};
+        ASSERT_EQ(tr.sent[p].addr.port, p);
+        ASSERT_EQ(rsp.get_token()[0], p & 0xff);
+    }
+}
+
+TEST(CoapEngine, Full)
+{
+    fake_transport tr;
+    engine_t e{tr};
+    std::vector<std::vector<byte>> reqs;
+
+    for (addr_port p = 0; p <= e.capacity(); ++p)
+        reqs.push_back(make_request(msg_type::non, p, {}));
+    for (addr_port p = 0; p < e.capacity(); ++p)
+        ASSERT_EQ(e.feed({make_addr(p), reqs[p]}, [] (server&) {}), true);
+    ASSERT_EQ(e.full(), true);
+    ASSERT_EQ(e.feed({make_addr(100), reqs.back()}, [] (server&) {}), false);
+}
+
+TEST(CoapEngine, Ignored)
+{
+    fake_transport tr;
+    engine_t e{tr};
+    std::vector<server*> ignored;
+    auto ignore = [&] (server& s) { ignored.push_back(&s); };
+
+    for (addr_port p = 0; p < e.capacity(); ++p)
+        ASSERT_EQ(e.feed({make_addr(p), make_request(p & 1 ? msg_type::con : msg_type::non, p, {7})}, ignore), true);
+    ASSERT_EQ(e.full(), true);
+    ASSERT_EQ(e.feed({make_addr(0), make_request(msg_type::non, 100, {7})}, reply("")), false);
+
+    e.drop(*ignored[0]);
+    ASSERT_EQ(e.size(), e.capacity() - 1);
+    ASSERT_EQ(e.feed({make_addr(0), make_request(msg_type::non, 101, {7})}, reply("ok")), true);
+    ASSERT_EQ(e.size(), e.capacity() - 1);
+
+    e.poll(imp::exchange_lifetime);
+    ASSERT_EQ(e.empty(), true);
+    ASSERT_EQ(e.feed({make_addr(1), make_request(msg_type::con, 102, {7})}, reply("ok")), true);
+    ASSERT_EQ(e.empty(), true);
+    e.flush();
+    packet rsp{tr.sent.back().data};
+    ASSERT_EQ(rsp.get_type(), +msg_type::ack);
+    ASSERT_EQ(rsp.get_code(), +msg_code::content);
+    ASSERT_EQ(rsp.get_id(), 102);
+}
+
+TEST(CoapEngine, Malformed)
+{
+    fake_transport tr;
+    engine_t e{tr};
+    byte too_short[] = {0x40, 0x01, 0x00};
+    byte bad_tkl[] = {0x49, 0x01, 0x00, 0x00};
+    byte bad_version[] = {0x80, 0x01, 0x00, 0x00};
+    byte response[] = {0x40, 0x45, 0x00, 0x00};
+    byte bad_option[] = {0x40, 0x01, 0x00, 0x00, 0xf1, 0x00};
+    byte no_payload[] = {0x40, 0x01, 0x00, 0x00, 0xff};
+    bool called = false;
+    auto fn = [&] (server&) { called = true; };
+
+    ASSERT_EQ(e.feed({make_addr(1), too_short}, fn), false);
+    ASSERT_EQ(e.feed({make_addr(1), bad_tkl}, fn), false);
+    ASSERT_EQ(e.feed({make_addr(1), response}, fn), false);
+    ASSERT_EQ(e.feed({make_addr(1), bad_version}, fn), false);
+    ASSERT_EQ(e.feed({make_addr(1), bad_option}, fn), false);
+    ASSERT_EQ(e.feed({make_addr(1), no_payload}, fn), false);
+    ASSERT_EQ(called, false);
+    ASSERT_EQ(e.empty(), true);
+}
+
+TEST(CoapUdp, Loopback)
+{
+    udp_socket srv{make_addr(0)};
+    udp_socket cli{make_addr(0)};
+    ASSERT_EQ(srv.valid(), true);
+    ASSERT_EQ(cli.valid(), true);
+
+    server_engine<udp_socket, 64> e{srv};
+    auto srv_addr = srv.local();
+    auto cli_addr = cli.local();
+    ASSERT_NE(srv_addr.port, 0);
+
+    std::vector<std::vector<byte>> reqs;
+    std::vector<datagram> out;
+    for (word i = 0; i < 20; ++i)
+        reqs.push_back(make_request(msg_type::con, i, {byte(i)}));
+    for (auto& it : reqs)
+        out.push_back({srv_addr, it});
+    ASSERT_EQ(cli.send(out), 20);
+
+    datagram in[32];
+    byte storage[32 * 64];
+    size_t received = 0;
+    while (received < 20 && srv.wait(1000)) {
+        auto n = srv.recv(in, storage);
+        for (size_t i = 0; i < n; ++i)
+            ASSERT_EQ(in[i].addr, cli_addr);
+        received += e.feed({in, n}, reply("pong"));
+        e.flush();
+    }
+    ASSERT_EQ(received, 20);
+
+    size_t answered = 0;
+    while (answered < 20 && cli.wait(1000)) {
+        auto n = cli.recv(in, storage);
+        for (size_t i = 0; i < n; ++i) {
+            packet rsp{in[i].data};
+            ASSERT_EQ(rsp.get_type(), +msg_type::ack);
+            ASSERT_EQ(rsp.get_token()[0], rsp.get_id());
+            ASSERT_EQ(rsp.get_payload().size(), 4);
+        }
+        answered += n;
+    }
+    ASSERT_EQ(answered, 20);
+}
+
+TEST(CoapUdp, Truncated)
+{
+    udp_socket srv{make_addr(0)};
+    udp_socket cli{make_addr(0)};
+    ASSERT_EQ(srv.valid(), true);
+    ASSERT_EQ(cli.valid(), true);
+
+    auto first = make_empty(msg_type::con, 1);
+    auto big = make_request(msg_type::con, 2, {1, 2, 3, 4, 5, 6, 7, 8});
+    auto last = make_empty(msg_type::con, 3);
+    datagram out[] = {{srv.local(), first}, {srv.local(), big}, {srv.local(), last}};
+    ASSERT_EQ(cli.send(out), 3);
+
+    datagram in[3];
+    byte storage[3 * 8];
+    std::vector<std::vector<byte>> received;
+    while (received.size() < 2 && srv.wait(1000)) {
+        auto n = srv.recv(in, storage);
+        for (size_t i = 0; i < n; ++i)
+            received.emplace_back(in[i].data.begin(), in[i].data.end());
+    }
+    ASSERT_EQ(received.size(), 2);
+    ASSERT_EQ(received[0], first);
+    ASSERT_EQ(received[1], last);
+    ASSERT_EQ(srv.recv(in, storage), 0);
+}
+
+}
+}
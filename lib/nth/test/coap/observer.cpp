@@ -0,0 +1,228 @@
+#include "test_coap.h"
+#include "nth/coap/engine.h"
+#include <vector>
+
+namespace nth::coap {
+namespace {
+
+struct counting_transport : fake_transport {
+    size_t send(std::span<const datagram> batch)
+    {
+        ++calls;
+        return fake_transport::send(batch);
+    }
+    size_t calls = 0;
+};
+
+std::vector<byte> make_request(word id, std::initializer_list<byte> tok, int observe)
+{
+    packet pkt;
+    pkt.setup(msg_type::con, msg_code::get, id, std::vector<byte>(tok));
+    if (observe >= 0)
+        opt_insert_uint(pkt, option_num::observe, observe);
+    return {pkt.begin(), pkt.end()};
+}
+
+ispan text(std::string_view str)
+{
+    return {reinterpret_cast<const byte*>(str.data()), str.size()};
+}
+
+using engine_t = server_engine<counting_transport, 8, 64, 4>;
+using registry_t = observer_registry<128, 64, 16>;
+
+TEST(CoapObserver, Registry)
+{
+    registry_t obs;
+    byte tok_a[] = {1, 2};
+    byte tok_b[] = {3};
+
+    ASSERT_EQ(obs.subscribe(make_addr(1), tok_a), true);
+    ASSERT_EQ(obs.subscribe(make_addr(1), tok_a), true);
+    ASSERT_EQ(obs.subscribe(make_addr(1), tok_b), true);
+    ASSERT_EQ(obs.subscribe(make_addr(2), tok_a), true);
+    ASSERT_EQ(obs.size(), 3);
+
+    ASSERT_EQ(obs.unsubscribe(make_addr(1), tok_a), true);
+    ASSERT_EQ(obs.unsubscribe(make_addr(1), tok_a), false);
+    ASSERT_EQ(obs.size(), 2);
+    ASSERT_EQ(obs.unsubscribe(make_addr(2), tok_a), true);
+    ASSERT_EQ(obs.unsubscribe(make_addr(1), tok_b), true);
+    ASSERT_EQ(obs.empty(), true);
+
+    for (addr_port p = 0; p < obs.capacity(); ++p)
+        ASSERT_EQ(obs.subscribe(make_addr(p), tok_b), true);
+    ASSERT_EQ(obs.full(), true);
+    ASSERT_EQ(obs.subscribe(make_addr(1000), tok_b), false);
+    for (addr_port p = 0; p < obs.capacity(); p += 2)
+        ASSERT_EQ(obs.unsubscribe(make_addr(p), tok_b), true);
+    for (addr_port p = 1; p < obs.capacity(); p += 2)
+        ASSERT_EQ(obs.unsubscribe(make_addr(p), tok_b), true);
+    ASSERT_EQ(obs.empty(), true);
+}
+
+TEST(CoapObserver, Register)
+{
+    counting_transport tr;
+    engine_t e{tr};
+    registry_t obs;
+    auto fn = [&] (server& s) {
+        if (obs.observe(e.remote(s), s.get_packet())) {
+            auto opt = obs.seq_option();
+            s.respond(text("22C"), msg_code::content, {&opt, 1});
+        } else {
+            s.respond(text("22C"));
+        }
+    };
+
+    e.feed({make_addr(1), make_request(1, {7}, 0)}, fn);
+    e.feed({make_addr(2), make_request(2, {8}, -1)}, fn);
+    e.flush();
+    ASSERT_EQ(obs.size(), 1);
+    ASSERT_EQ(tr.sent.size(), 2);
+    packet rsp{tr.sent[0].data};
+    ASSERT_EQ(rsp.opt_is_set(option_num::observe), true);
+    ASSERT_EQ(rsp.get_payload().size(), 3);
+    ASSERT_EQ(packet{tr.sent[1].data}.opt_is_set(option_num::observe), false);
+
+    e.feed({make_addr(1), make_request(3, {7}, 1)}, fn);
+    ASSERT_EQ(obs.empty(), true);
+}
+
+TEST(CoapObserver, Notify)
+{
+    counting_transport tr;
+    engine_t e{tr, 1000};
+    registry_t obs;
+
+    for (addr_port p = 0; p < 100; ++p) {
+        byte tok[] = {byte(p), byte(p >> 8), 0x55};
+        obs.subscribe(make_addr(p), {tok, size_t(1 + p % 3)});
+    }
+    ASSERT_EQ(e.notify(obs, text("hello")), 100);
+    ASSERT_EQ(tr.calls, 7);
+    ASSERT_EQ(e.notify(obs, text("world")), 100);
+    ASSERT_EQ(tr.sent.size(), 200);
+
+    for (size_t i = 0; i < 200; ++i) {
+        packet pkt{tr.sent[i].data};
+        auto p = tr.sent[i].addr.port;
+        ASSERT_EQ(pkt.get_type(), +msg_type::non);
+        ASSERT_EQ(pkt.get_code(), +msg_code::content);
+        ASSERT_EQ(pkt.get_id(), 1000 + i);
+        ASSERT_EQ(pkt.get_tkl(), 1 + p % 3);
+        ASSERT_EQ(pkt.get_token()[0], byte(p));
+        ASSERT_EQ(opt_uint_decode(pkt.opt_get(option_num::observe)), 1 + i / 100);
+        ASSERT_EQ(pkt.get_payload().size(), 5);
+        ASSERT_EQ(pkt.get_payload()[0], i < 100 ? 'h' : 'w');
+    }
+    ASSERT_EQ(obs.sequence(), 2);
+
+    byte fmt_buf[4];
+    option fmt = {fmt_buf, opt_uint_encode(50, fmt_buf), +option_num::content_format};
+    tr.sent.clear();
+    ASSERT_EQ(e.notify(obs, text("{}"), msg_code::content, false, {&fmt, 1}), 100);
+    packet pkt{tr.sent[0].data};
+    ASSERT_EQ(opt_uint_decode(pkt.opt_get(option_num::content_format)), 50);
+    ASSERT_EQ(opt_uint_decode(pkt.opt_get(option_num::observe)), 3);
+}
+
+TEST(CoapObserver, Cancel)
+{
+    counting_transport tr;
+    engine_t e{tr};
+    registry_t obs;
+    byte tok[] = {1};
+
+    for (addr_port p = 0; p < 4; ++p)
+        obs.subscribe(make_addr(p), tok);
+    e.notify(obs, text("x"), msg_code::content, true);
+    ASSERT_EQ(tr.sent.size(), 4);
+
+    auto rst = make_empty(msg_type::rst, packet{tr.sent[1].data}.get_id());
+    ASSERT_EQ(e.feed({make_addr(1), rst}, [] (server&) {}), false);
+    ASSERT_EQ(obs.feed({make_addr(2), rst}), false);
+    ASSERT_EQ(obs.feed({make_addr(1), rst}), true);
+    ASSERT_EQ(obs.feed({make_addr(1), rst}), false);
+    ASSERT_EQ(obs.size(), 3);
+
+    tr.sent.clear();
+    e.notify(obs, text("y"), msg_code::content, true);
+    ASSERT_EQ(tr.sent.size(), 3);
+    auto prev = make_empty(msg_type::rst, packet{tr.sent[0].data}.get_id());
+    e.notify(obs, text("z"));
+    ASSERT_EQ(obs.feed({make_addr(0), prev}), true);
+    ASSERT_EQ(obs.size(), 2);
+}
+
+TEST(CoapObserver, Retransmit)
+{
+    counting_transport tr;
+    engine_t e{tr};
+    registry_t obs;
+    byte tok[] = {1};
+    auto max_timeout = timestamp(imp::ack_timeout * imp::ack_random_factor);
+
+    obs.subscribe(make_addr(1), tok);
+    obs.subscribe(make_addr(2), tok);
+    e.notify(obs, text("x"), msg_code::content, true);
+    ASSERT_EQ(tr.sent.size(), 2);
+    auto id_1 = packet{tr.sent[0].data}.get_id();
+    auto id_2 = packet{tr.sent[1].data}.get_id();
+
+    ASSERT_EQ(e.poll(imp::ack_timeout - 1, obs), 0);
+    ASSERT_EQ(obs.feed({make_addr(1), make_empty(msg_type::ack, id_1)}), true);
+
+    timestamp now = max_timeout;
+    ASSERT_EQ(e.poll(now, obs), 1);
+    packet retx{tr.sent.back().data};
+    ASSERT_EQ(tr.sent.back().addr.port, 2);
+    ASSERT_EQ(retx.get_type(), +msg_type::con);
+    ASSERT_EQ(retx.get_id(), id_2);
+    ASSERT_EQ(retx.get_payload()[0], 'x');
+
+    for (int i = 1; i < imp::max_retransmit_cnt; ++i) {
+        now += max_timeout << i;
+        ASSERT_EQ(e.poll(now, obs), 1);
+        ASSERT_EQ(tr.sent.back().addr.port, 2);
+    }
+    ASSERT_EQ(obs.size(), 2);
+    now += max_timeout << imp::max_retransmit_cnt;
+    ASSERT_EQ(e.poll(now, obs), 0);
+    ASSERT_EQ(obs.size(), 1);
+    ASSERT_EQ(obs.observers()[0].key.addr.port, 1);
+    ASSERT_EQ(e.poll(now + imp::exchange_lifetime, obs), 0);
+}
+
+TEST(CoapObserver, LateAck)
+{
+    counting_transport tr;
+    engine_t e{tr};
+    registry_t obs;
+    byte tok[] = {1};
+    auto max_timeout = timestamp(imp::ack_timeout * imp::ack_random_factor);
+
+    obs.subscribe(make_addr(1), tok);
+    timestamp now = 0;
+    word prev = 0;
+    for (int i = 0; i < 4 * imp::max_retransmit_cnt; ++i) {
+        e.notify(obs, text("x"), msg_code::content, true);
+        auto id = packet{tr.sent.back().data}.get_id();
+        ASSERT_EQ(packet{tr.sent.back().data}.get_type(), +msg_type::con);
+        if (i) {
+            ASSERT_EQ(obs.feed({make_addr(1), make_empty(msg_type::ack, prev)}), true);
+        }
+        prev = id;
+        now += max_timeout << imp::max_retransmit_cnt;
+        e.poll(now, obs);
+        ASSERT_EQ(obs.size(), 1);
+    }
+    ASSERT_EQ(obs.feed({make_addr(1), make_empty(msg_type::ack, prev)}), true);
+    ASSERT_EQ(obs.observers()[0].pending, false);
+    tr.sent.clear();
+    ASSERT_EQ(e.poll(now + imp::exchange_lifetime, obs), 0);
+    ASSERT_EQ(obs.size(), 1);
+}
+
+}
+}
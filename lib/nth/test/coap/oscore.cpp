@@ -0,0 +1,282 @@
+#include "test.h"
+#include "nth/coap/oscore.h"
+#include <vector>
+
+namespace nth::coap {
+namespace {
+
+// Test vectors from RFC 8613, Appendix C
+
+const byte master_secret[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10};
+const byte master_salt[] = {0x9e, 0x7c, 0xa9, 0x22, 0x23, 0x78, 0x63, 0x40};
+const byte id_context[] = {0x37, 0xcb, 0xf3, 0x21, 0x00, 0x17, 0xa2, 0xd3};
+const byte id_0[] = {0x00};
+const byte id_1[] = {0x01};
+
+void check(ispan res, std::vector<byte> exp)
+{
+    ASSERT_EQ(std::vector<byte>(res.begin(), res.end()), exp);
+}
+
+oscore_context client()
+{
+    oscore_context ctx;
+    EXPECT_TRUE(ctx.init(master_secret, master_salt, {}, id_1));
+    return ctx;
+}
+
+oscore_context server()
+{
+    oscore_context ctx;
+    EXPECT_TRUE(ctx.init(master_secret, master_salt, id_1, {}));
+    return ctx;
+}
+
+const std::vector<byte> tv4_plain = {
+    0x44, 0x01, 0x5d, 0x1f, 0x00, 0x00, 0x39, 0x74, 0x39, 0x6c, 0x6f, 0x63, 0x61, 0x6c, 0x68, 0x6f,
+    0x73, 0x74, 0x83, 0x74, 0x76, 0x31,
+};
+const std::vector<byte> tv4_protected = {
+    0x44, 0x02, 0x5d, 0x1f, 0x00, 0x00, 0x39, 0x74, 0x39, 0x6c, 0x6f, 0x63, 0x61, 0x6c, 0x68, 0x6f,
+    0x73, 0x74, 0x62, 0x09, 0x14, 0xff, 0x61, 0x2f, 0x10, 0x92, 0xf1, 0x77, 0x6f, 0x1c, 0x16, 0x68,
+    0xb3, 0x82, 0x5e,
+};
+const std::vector<byte> tv7_plain = {
+    0x64, 0x45, 0x5d, 0x1f, 0x00, 0x00, 0x39, 0x74, 0xff, 0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x20, 0x57,
+    0x6f, 0x72, 0x6c, 0x64, 0x21,
+};
+const std::vector<byte> tv7_protected = {
+    0x64, 0x44, 0x5d, 0x1f, 0x00, 0x00, 0x39, 0x74, 0x90, 0xff, 0xdb, 0xaa, 0xd1, 0xe9, 0xa7, 0xe7,
+    0xb2, 0xa8, 0x13, 0xd3, 0xc3, 0x15, 0x24, 0x37, 0x83, 0x03, 0xcd, 0xaf, 0xae, 0x11, 0x91, 0x06,
+};
+const std::vector<byte> tv8_protected = {
+    0x64, 0x44, 0x5d, 0x1f, 0x00, 0x00, 0x39, 0x74, 0x92, 0x01, 0x00, 0xff, 0x4d, 0x4c, 0x13, 0x66,
+    0x93, 0x84, 0xb6, 0x73, 0x54, 0xb2, 0xb6, 0x17, 0x5f, 0xf4, 0xb8, 0x65, 0x8c, 0x66, 0x6a, 0x6c,
+    0xf8, 0x8e,
+};
+
+}
+
+TEST(CoapOscore, OptionClasses)
+{
+    ASSERT_FALSE(opt_class_e(+option_num::uri_host));
+    ASSERT_FALSE(opt_class_e(+option_num::oscore));
+    ASSERT_TRUE(opt_class_e(+option_num::uri_path));
+    ASSERT_TRUE(opt_class_e(+option_num::observe));
+    ASSERT_TRUE(opt_class_u(+option_num::observe));
+    ASSERT_TRUE(opt_class_u(+option_num::proxy_uri));
+    ASSERT_FALSE(opt_class_u(+option_num::content_format));
+}
+
+TEST(CoapOscore, OptionDecode)
+{
+    oscore_option val;
+    const byte v1[] = {0x19, 0x14, 0x08, 0x37, 0xcb, 0xf3, 0x21, 0x00, 0x17, 0xa2, 0xd3, 0x00};
+    ASSERT_EQ(oscore_option_decode({v1, sizeof(v1), 9}, val), oscore_error::ok);
+    ASSERT_TRUE(val.kid_flag);
+    ASSERT_TRUE(val.ctx_flag);
+    check(val.piv, {0x14});
+    check(val.ctx, {id_context, id_context + 8});
+    check(val.kid, {0x00});
+
+    ASSERT_EQ(oscore_option_decode({v1, 0, 9}, val), oscore_error::ok);
+    ASSERT_TRUE(val.piv.empty());
+    ASSERT_FALSE(val.kid_flag);
+
+    const byte v2[] = {0x21};
+    ASSERT_EQ(oscore_option_decode({v2, sizeof(v2), 9}, val), oscore_error::reserved_bits);
+    const byte v3[] = {0x06, 1, 2, 3, 4, 5, 6};
+    ASSERT_EQ(oscore_option_decode({v3, sizeof(v3), 9}, val), oscore_error::illegal_piv_length);
+    const byte v4[] = {0x03, 1, 2};
+    ASSERT_EQ(oscore_option_decode({v4, sizeof(v4), 9}, val), oscore_error::illegal_piv_length);
+    const byte v5[] = {0x11, 1, 5, 0};
+    ASSERT_EQ(oscore_option_decode({v5, sizeof(v5), 9}, val), oscore_error::illegal_kid_length);
+    const byte v6[] = {0x01, 1, 2};
+    ASSERT_EQ(oscore_option_decode({v6, sizeof(v6), 9}, val), oscore_error::illegal_kid_length);
+}
+
+TEST(CoapOscore, ReplayWindow)
+{
+    replay_window<64> w;
+    ASSERT_TRUE(w.check_and_update(0));
+    ASSERT_FALSE(w.check_and_update(0));
+    ASSERT_TRUE(w.check_and_update(5));
+    ASSERT_TRUE(w.check_and_update(3));
+    ASSERT_FALSE(w.check_and_update(3));
+    ASSERT_TRUE(w.check_and_update(100));
+    ASSERT_FALSE(w.check(36));
+    ASSERT_TRUE(w.check(37));
+    ASSERT_TRUE(w.check(99));
+    ASSERT_FALSE(w.check(100));
+}
+
+TEST(CoapOscore, ReplayWindowWide)
+{
+    replay_window<1024> w;
+    ASSERT_TRUE(w.check_and_update(2000));
+    for (uint64_t i = 1999; i > 2000 - 1024; --i)
+        ASSERT_TRUE(w.check_and_update(i));
+    ASSERT_FALSE(w.check(2000 - 1024));
+    ASSERT_FALSE(w.check_and_update(1500));
+    ASSERT_TRUE(w.check_and_update(2500));
+    ASSERT_FALSE(w.check(1476));
+    ASSERT_FALSE(w.check(1477));
+    ASSERT_TRUE(w.check(2499));
+    ASSERT_EQ(w.latest(), 2500);
+}
+
+TEST(CoapOscore, KeyDerivation)
+{
+    auto c = client();
+    check(c.sender_key(), {0xf0, 0x91, 0x0e, 0xd7, 0x29, 0x5e, 0x6a, 0xd4, 0xb5, 0x4f, 0xc7, 0x93, 0x15, 0x43, 0x02, 0xff});
+    check(c.recipient_key(), {0xff, 0xb1, 0x4e, 0x09, 0x3c, 0x94, 0xc9, 0xca, 0xc9, 0x47, 0x16, 0x48, 0xb4, 0xf9, 0x87, 0x10});
+    check(c.common_iv(), {0x46, 0x22, 0xd4, 0xdd, 0x6d, 0x94, 0x41, 0x68, 0xee, 0xfb, 0x54, 0x98, 0x7c});
+
+    auto s = server();
+    check(s.sender_key(), {0xff, 0xb1, 0x4e, 0x09, 0x3c, 0x94, 0xc9, 0xca, 0xc9, 0x47, 0x16, 0x48, 0xb4, 0xf9, 0x87, 0x10});
+    check(s.recipient_key(), {0xf0, 0x91, 0x0e, 0xd7, 0x29, 0x5e, 0x6a, 0xd4, 0xb5, 0x4f, 0xc7, 0x93, 0x15, 0x43, 0x02, 0xff});
+}
+
+TEST(CoapOscore, KeyDerivationIdContext)
+{
+    oscore_context c;
+    ASSERT_TRUE(c.init(master_secret, master_salt, {}, id_1, id_context));
+    check(c.sender_key(), {0xaf, 0x2a, 0x13, 0x00, 0xa5, 0xe9, 0x57, 0x88, 0xb3, 0x56, 0x33, 0x6e, 0xee, 0xcd, 0x2b, 0x92});
+    check(c.recipient_key(), {0xe3, 0x9a, 0x0c, 0x7c, 0x77, 0xb4, 0x3f, 0x03, 0xb4, 0xb3, 0x9a, 0xb9, 0xa2, 0x68, 0x69, 0x9f});
+    check(c.common_iv(), {0x2c, 0xa5, 0x8f, 0xb8, 0x5f, 0xf1, 0xb8, 0x1c, 0x0b, 0x71, 0x81, 0xb8, 0x5e});
+}
+
+TEST(CoapOscore, ProtectRequest)
+{
+    auto c = client();
+    c.set_sequence(20);
+    packet<256> plain{tv4_plain};
+    packet<256> prot;
+    oscore_request bind;
+    ASSERT_EQ(c.protect_req(plain, prot, bind), oscore_error::ok);
+    check(prot, tv4_protected);
+    ASSERT_EQ(c.sequence(), 21);
+    check(bind.get_piv(), {0x14});
+    check(bind.get_kid(), {});
+}
+
+TEST(CoapOscore, VerifyRequest)
+{
+    auto s = server();
+    packet<256> prot{tv4_protected};
+    packet<256> plain;
+    oscore_request bind;
+    ASSERT_EQ(s.verify_req(prot, plain, bind), oscore_error::ok);
+    check(plain, tv4_plain);
+    check(bind.get_piv(), {0x14});
+
+    ASSERT_EQ(s.verify_req(prot, plain, bind), oscore_error::replay);
+}
+
+TEST(CoapOscore, ProtectResponse)
+{
+    auto s = server();
+    oscore_request bind = {.kid = {}, .piv = {0x14}, .kid_len = 0, .piv_len = 1};
+    packet<256> plain{tv7_plain};
+    packet<256> prot;
+    ASSERT_EQ(s.protect_rsp(plain, prot, bind), oscore_error::ok);
+    check(prot, tv7_protected);
+    ASSERT_EQ(s.sequence(), 0);
+
+    ASSERT_EQ(s.protect_rsp(plain, prot, bind, true), oscore_error::ok);
+    check(prot, tv8_protected);
+    ASSERT_EQ(s.sequence(), 1);
+}
+
+TEST(CoapOscore, VerifyResponse)
+{
+    auto c = client();
+    oscore_request bind = {.kid = {}, .piv = {0x14}, .kid_len = 0, .piv_len = 1};
+    packet<256> plain;
+
+    packet<256> prot7{tv7_protected};
+    ASSERT_EQ(c.verify_rsp(prot7, plain, bind), oscore_error::ok);
+    check(plain, tv7_plain);
+
+    packet<256> prot8{tv8_protected};
+    ASSERT_EQ(c.verify_rsp(prot8, plain, bind), oscore_error::ok);
+    check(plain, tv7_plain);
+}
+
+TEST(CoapOscore, Tampered)
+{
+    auto s = server();
+    oscore_request bind;
+    packet<256> plain;
+    for (size_t i = 22; i < tv4_protected.size(); ++i) {
+        auto raw = tv4_protected;
+        raw[i] ^= 0x01;
+        packet<256> prot{raw};
+        ASSERT_EQ(s.verify_req(prot, plain, bind), oscore_error::crypto_fail);
+    }
+    auto raw = tv4_protected;
+    raw.back() = 0;
+    raw.resize(raw.size() - 7);
+    packet<256> prot{raw};
+    ASSERT_EQ(s.verify_req(prot, plain, bind), oscore_error::illegal_tag_length);
+
+    packet<256> noopt{tv4_plain};
+    ASSERT_EQ(s.verify_req(noopt, plain, bind), oscore_error::no_option);
+}
+
+TEST(CoapOscore, UnknownKid)
+{
+    oscore_context c, s;
+    ASSERT_TRUE(c.init(master_secret, master_salt, id_0, id_1));
+    ASSERT_TRUE(s.init(master_secret, master_salt, id_1, id_1));
+    packet<256> plain{tv4_plain};
+    packet<256> prot, out;
+    oscore_request bind;
+    ASSERT_EQ(c.protect_req(plain, prot, bind), oscore_error::ok);
+    ASSERT_EQ(s.verify_req(prot, out, bind), oscore_error::unknown_kid);
+}
+
+TEST(CoapOscore, RoundTrip)
+{
+    oscore_context c, s;
+    ASSERT_TRUE(c.init(master_secret, master_salt, id_0, id_1, id_context));
+    ASSERT_TRUE(s.init(master_secret, master_salt, id_1, id_0, id_context));
+
+    const byte tok[] = {1, 2, 3, 4};
+    const byte pld[] = {'h', 'e', 'l', 'l', 'o'};
+    packet<256> req;
+    packet_builder b{req, msg_type::con, msg_code::put, 0x1234, tok};
+    b.add(option_num::uri_host, "example.org");
+    b.add_uint(option_num::observe, 0);
+    b.add(option_num::uri_path, "sensors");
+    b.add(option_num::uri_path, "temp");
+    b.add_uint(option_num::content_format, 0);
+    b.add(option_num::proxy_scheme, "coap");
+    b.payload(pld);
+    ASSERT_TRUE(b.ok());
+    packet<256> ref{ispan{req}};
+
+    for (int i = 0; i < 3; ++i) {
+        packet<256> prot, out;
+        oscore_request cbind, sbind;
+        ASSERT_EQ(c.protect_req(ref, prot, cbind), oscore_error::ok);
+        packet<256> wire{ispan{prot}};
+        ASSERT_EQ(wire.get_code(), +msg_code::fetch);
+        ASSERT_TRUE(opt_valid(wire.opt_get(option_num::uri_host)));
+        ASSERT_TRUE(opt_valid(wire.opt_get(option_num::observe)));
+        ASSERT_FALSE(opt_valid(wire.opt_get(option_num::uri_path)));
+        ASSERT_EQ(s.verify_req(wire, out, sbind), oscore_error::ok);
+        check(out, {ref.begin(), ref.end()});
+
+        packet<256> rsp, rprot, rout;
+        packet_builder r{rsp, msg_type::ack, msg_code::content, 0x1234, tok};
+        r.add_uint(option_num::observe, i);
+        r.payload(pld);
+        ASSERT_EQ(s.protect_rsp(rsp, rprot, sbind, i > 0), oscore_error::ok);
+        packet<256> rwire{ispan{rprot}};
+        ASSERT_EQ(c.verify_rsp(rwire, rout, cbind), oscore_error::ok);
+        check(rout, {rsp.begin(), rsp.end()});
+    }
+}
+
+}
@@ -0,0 +1,189 @@
+#include "test.h"
+#include "nth/coap/builder.h"
+#include <random>
+#include <vector>
+
+namespace nth::coap {
+namespace {
+
+/**
+ * @brief Straightforward reference parser, field by field, as RFC 7252
+ * section 3.1 describes it.
+ *
+ */
+error ref_parse(ispan raw, std::vector<option>& opts, size_t& pld)
+{
+    opts.clear();
+    pld = 0;
+    if (raw.size() < 4)
+        return error::too_short_header;
+    if ((raw[0] >> 6) != 1)
+        return error::invalid_version;
+    size_t tkl = raw[0] & 0xf;
+    if (tkl > 8)
+        return error::invalid_token_length;
+    if (tkl > raw.size() - 4)
+        return error::too_short_token;
+
+    size_t p = 4 + tkl;
+    size_t n = raw.size();
+    uint32_t num = 0;
+
+    while (p < n) {
+        if (raw[p] == 0xff) {
+            if (p + 1 == n)
+                return error::too_short_payload;
+            pld = n - p - 1;
+            return error::ok;
+        }
+        uint32_t field[2] = {uint32_t(raw[p] >> 4), uint32_t(raw[p] & 0xf)};
+        ++p;
+        for (auto& f : field) {
+            if (f == 15)
+                return error::invalid_option;
+            if (f == 13) {
+                if (p + 1 > n)
+                    return error::invalid_option;
+                f = 13 + raw[p++];
+            } else if (f == 14) {
+                if (p + 2 > n)
+                    return error::invalid_option;
+                f = 269 + (raw[p] << 8 | raw[p + 1]);
+                p += 2;
+            }
+        }
+        if (num + field[0] > 0xffff)
+            return error::invalid_option;
+        if (p + field[1] > n)
+            return error::too_short_option;
+        num += field[0];
+        opts.push_back({raw.data() + p, word(field[1]), word(num)});
+        p += field[1];
+    }
+    return error::ok;
+}
+
+std::vector<std::vector<byte>> seeds()
+{
+    std::vector<std::vector<byte>> out;
+    byte tok[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<byte> big(400, 0x5a);
+
+    for (size_t tkl : {0, 1, 8}) {
+        packet<1024> pkt;
+        packet_builder b{pkt, msg_type::con, msg_code::get, 0x1234, {tok, tkl}};
+        b.add(option_num::uri_host, "example.org");
+        b.add_uint(option_num::observe, 0);
+        b.add(option_num::uri_path, "sensors");
+        b.add(option_num::uri_path, "temperature");
+        b.add_uint(option_num::content_format, 50);
+        b.add_uint(option_num::block2, 0x2a);
+        b.add(option_num::proxy_uri, {big.data(), 20});
+        b.add(option_num::no_response, {big.data(), 300});
+        b.add(option_num(3000), ispan{});
+        b.payload({big.data(), 17});
+        out.emplace_back(pkt.begin(), pkt.end());
+    }
+    out.push_back({0x40, 0x01, 0x00, 0x01});
+    out.push_back({0x40, 0x01, 0x00, 0x01, 0xff});
+    out.push_back({0x40, 0x01, 0x00, 0x01, 0xff, 0x00});
+    out.push_back({0x40, 0x01, 0x00, 0x01, 0xd0});
+    out.push_back({0x40, 0x01, 0x00, 0x01, 0xd0, 0x01});
+    out.push_back({0x40, 0x01, 0x00, 0x01, 0xe0, 0x01});
+    out.push_back({0x40, 0x01, 0x00, 0x01, 0xe0, 0xff, 0xff});
+    out.push_back({0x40, 0x01, 0x00, 0x01, 0xe0, 0xfe, 0xf2, 0x10});
+    out.push_back({0x40, 0x01, 0x00, 0x01, 0x0f});
+    out.push_back({0x40, 0x01, 0x00, 0x01, 0x0d, 0x00});
+    out.push_back({0x40, 0x01, 0x00, 0x01, 0x02, 0x00});
+    out.push_back({0x40, 0x01, 0x00, 0x01, 0x00, 0x00, 0xb1});
+    return out;
+}
+
+void check(ispan raw)
+{
+    std::vector<option> ref_opts;
+    size_t ref_pld;
+    auto ref = ref_parse(raw, ref_opts, ref_pld);
+
+    packet<2048> pkt;
+    ASSERT_EQ(pkt.parse(raw), ref);
+    ASSERT_EQ(packet_view::validate(raw), ref);
+    if (ref != error::ok)
+        return;
+
+    ASSERT_EQ(pkt.get_payload().size(), ref_pld);
+
+    // Reserved option 0 can only lead and iteration stops at it
+    size_t n = ref_opts.empty() || ref_opts.front().num ? ref_opts.size() : 0;
+    size_t i = 0;
+    for (auto opt : pkt.get_options()) {
+        ASSERT_LT(i, n);
+        ASSERT_EQ(opt.num, ref_opts[i].num);
+        ASSERT_EQ(opt.len, ref_opts[i].len);
+        ASSERT_EQ(opt.dat - pkt.begin(), ref_opts[i].dat - raw.data());
+        ++i;
+    }
+    ASSERT_EQ(i, n);
+
+    for (word num : {1, 3, 4, 5, 6, 7, 8, 9, 11, 12, 14, 15, 17, 20, 23, 27, 28, 35, 39, 60, 258}) {
+        auto it = std::ranges::find(ref_opts, num, &option::num);
+        auto opt = pkt.opt_get(option_num(num));
+        ASSERT_EQ(opt_valid(opt), it != ref_opts.end());
+        if (opt_valid(opt)) {
+            ASSERT_EQ(opt.dat - pkt.begin(), it->dat - raw.data());
+        }
+    }
+}
+
+TEST(CoapPacketParse, Seeds)
+{
+    for (auto& it : seeds())
+        check(it);
+}
+
+TEST(CoapPacketParse, Truncated)
+{
+    for (auto& it : seeds())
+        for (size_t n = 0; n <= it.size(); ++n)
+            check({it.data(), n});
+}
+
+TEST(CoapPacketParse, Mutated)
+{
+    std::mt19937 rng{12345};
+    auto corpus = seeds();
+
+    for (int round = 0; round < 20000; ++round) {
+        auto pkt = corpus[rng() % corpus.size()];
+        auto flips = 1 + rng() % 4;
+        for (size_t i = 0; i < flips && !pkt.empty(); ++i) {
+            auto pos = rng() % pkt.size();
+            switch (rng() % 4) {
+                case 0: pkt[pos] ^= byte(1 << (rng() % 8)); break;
+                case 1: pkt[pos] = byte(rng()); break;
+                case 2: pkt.erase(pkt.begin() + pos); break;
+                case 3: pkt.insert(pkt.begin() + pos, byte(rng())); break;
+            }
+        }
+        if (pkt.size() >= 1 && rng() % 2)
+            pkt[0] = (pkt[0] & 0x3f) | 0x40;
+        check(pkt);
+    }
+}
+
+TEST(CoapPacketParse, Random)
+{
+    std::mt19937 rng{777};
+
+    for (int round = 0; round < 20000; ++round) {
+        std::vector<byte> pkt(rng() % 64);
+        for (auto& it : pkt)
+            it = byte(rng() % 4 ? rng() % 32 : rng());
+        if (pkt.size() >= 1)
+            pkt[0] = 0x40 | (pkt[0] & 0x3f & ~0x08);
+        check(pkt);
+    }
+}
+
+}
+}
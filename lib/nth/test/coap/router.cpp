@@ -0,0 +1,139 @@
+#include "test_coap.h"
+#include "nth/coap/router.h"
+#include "nth/coap/engine.h"
+#include <string>
+#include <vector>
+
+namespace nth::coap {
+namespace {
+
+std::string last;
+
+void get_root(server&)      { last = "get /"; }
+void get_temp(server& s)    { last = "get temp"; s.respond({}); }
+void put_temp(server& s)    { last = "put temp"; s.respond({}, msg_code::changed); }
+void get_hum(server&)       { last = "get hum"; }
+void del_led(server&)       { last = "del led"; }
+
+constexpr route routes[] = {
+    {.path = "/", .get = get_root},
+    {.path = "sensors/temp", .get = get_temp, .put = put_temp},
+    {.path = "/sensors/hum", .get = get_hum},
+    {.path = "actuators//led/", .del = del_led},
+};
+
+constexpr auto r = make_router<routes>();
+
+static_assert(r.capacity() == 7);
+static_assert(r.size() == 6);
+static_assert(r.locate("") == 0);
+static_assert(r.locate("sensors/temp") != r.npos);
+static_assert(r.locate("sensors/temp") == r.locate("/sensors//temp/"));
+static_assert(r.locate("sensors/light") == r.npos);
+static_assert(r.locate("temp") == r.npos);
+static_assert(r.locate("sensors/temp/x") == r.npos);
+static_assert(r.handler(r.locate("sensors/temp"), +msg_code::put) == put_temp);
+static_assert(r.handler(r.locate("sensors/temp"), +msg_code::post) == nullptr);
+static_assert(r.locate("sensors") == r.npos);
+static_assert(r.locate("actuators") == r.npos);
+static_assert(r.handler(r.locate("actuators/led"), +msg_code::delete_) == del_led);
+static_assert(r.handler(0, +msg_code::content) == nullptr);
+
+constexpr route leaf_routes[] = {
+    {.path = "sensors/temp", .get = get_temp},
+};
+
+constexpr auto leaf = make_router<leaf_routes>();
+
+static_assert(leaf.locate("") == leaf.npos);
+static_assert(leaf.locate("sensors") == leaf.npos);
+
+std::vector<byte> make_request(msg_code code, word id, std::initializer_list<std::string_view> path)
+{
+    packet pkt;
+    pkt.setup(msg_type::con, code, id, {});
+    for (auto seg : path)
+        pkt.opt_insert({reinterpret_cast<const byte*>(seg.data()), word(seg.size()), +option_num::uri_path});
+    return {pkt.begin(), pkt.end()};
+}
+
+TEST(CoapRouter, Locate)
+{
+    packet pkt{make_request(msg_code::get, 1, {"sensors", "hum"})};
+    ASSERT_EQ(r.locate(pkt), r.locate("sensors/hum"));
+    ASSERT_EQ(r.handler(r.locate(pkt), pkt.get_code()), get_hum);
+
+    pkt.parse(make_request(msg_code::get, 1, {}));
+    ASSERT_EQ(r.locate(pkt), 0);
+
+    pkt.parse(make_request(msg_code::get, 1, {"sensors", "hum", "x"}));
+    ASSERT_EQ(r.locate(pkt), r.npos);
+
+    pkt.parse(make_request(msg_code::get, 1, {"hum"}));
+    ASSERT_EQ(r.locate(pkt), r.npos);
+}
+
+TEST(CoapRouter, Dispatch)
+{
+    fake_transport tr;
+    server_engine<fake_transport, 4, 64> e{tr};
+    auto addr = make_addr(1);
+    auto fn = [] (server& s) { r.dispatch(s); };
+
+    ASSERT_EQ(e.feed({addr, make_request(msg_code::put, 1, {"sensors", "temp"})}, fn), true);
+    ASSERT_EQ(last, "put temp");
+    ASSERT_EQ(e.feed({addr, make_request(msg_code::get, 2, {"sensors", "temp"})}, fn), true);
+    ASSERT_EQ(last, "get temp");
+    ASSERT_EQ(e.feed({addr, make_request(msg_code::post, 3, {"sensors", "temp"})}, fn), true);
+    ASSERT_EQ(e.feed({addr, make_request(msg_code::get, 4, {"nothing"})}, fn), true);
+    ASSERT_EQ(e.feed({addr, make_request(msg_code::get, 5, {"sensors"})}, fn), true);
+    ASSERT_EQ(last, "get temp");
+    e.flush();
+    ASSERT_EQ(tr.sent.size(), 5);
+    ASSERT_EQ(packet{tr.sent[0].data}.get_code(), +msg_code::changed);
+    ASSERT_EQ(packet{tr.sent[1].data}.get_code(), +msg_code::content);
+    ASSERT_EQ(packet{tr.sent[2].data}.get_code(), +msg_code::method_not_allowed);
+    ASSERT_EQ(packet{tr.sent[3].data}.get_code(), +msg_code::not_found);
+    ASSERT_EQ(packet{tr.sent[4].data}.get_code(), +msg_code::not_found);
+
+    auto leaf_fn = [] (server& s) { leaf.dispatch(s); };
+    ASSERT_EQ(e.feed({addr, make_request(msg_code::get, 6, {})}, leaf_fn), true);
+    e.flush();
+    ASSERT_EQ(tr.sent.size(), 6);
+    ASSERT_EQ(packet{tr.sent[5].data}.get_code(), +msg_code::not_found);
+}
+
+constexpr auto hex_names = [] {
+    std::array<char, 512> out;
+    constexpr std::string_view digits = "0123456789abcdef";
+    for (size_t i = 0; i < 256; ++i) {
+        out[i * 2 + 0] = digits[i >> 4];
+        out[i * 2 + 1] = digits[i & 0xf];
+    }
+    return out;
+}();
+
+constexpr auto hex_routes = [] {
+    std::array<route, 256> out;
+    for (size_t i = 0; i < out.size(); ++i)
+        out[i] = {{hex_names.data() + i * 2, 2}, i & 1 ? get_hum : get_temp};
+    return out;
+}();
+
+constexpr auto hex_router = make_router<hex_routes>();
+
+TEST(CoapRouter, Many)
+{
+    ASSERT_EQ(hex_router.size(), 257);
+    for (size_t i = 0; i < 256; ++i) {
+        auto node = hex_router.locate({hex_names.data() + i * 2, 2});
+        ASSERT_NE(node, hex_router.npos);
+        ASSERT_EQ(hex_router.handler(node, +msg_code::get), i & 1 ? get_hum : get_temp);
+    }
+    ASSERT_EQ(hex_router.locate("0"), hex_router.npos);
+    ASSERT_EQ(hex_router.locate("00/00"), hex_router.npos);
+    ASSERT_EQ(hex_router.locate("100"), hex_router.npos);
+}
+
+}
+}
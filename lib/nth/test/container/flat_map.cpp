@@ -0,0 +1,159 @@
+#include "test.h"
+#include "nth/container/flat_map.h"
+#include "nth/container/flat_set.h"
+#include <array>
+#include <map>
+
+namespace nth {
+namespace {
+
+constexpr size_t test_size = 8;
+
+using map_t = flat_map<int, objcounter, test_size>;
+
+struct collide {
+    constexpr size_t operator()(int x) const { return x & 1; }
+};
+
+TEST_F(ContainerTester, FlatMapBasic)
+{
+    map_t m;
+
+    ASSERT_EQ(m.empty(), true);
+    ASSERT_EQ(m.capacity(), test_size);
+    ASSERT_EQ(m.find(1), m.end());
+    ASSERT_EQ(m.begin(), m.end());
+
+    ASSERT_EQ(m.try_emplace(1, 10).second, true);
+    ASSERT_EQ(m.try_emplace(1, 11).second, false);
+    ASSERT_EQ(m.insert({2, 20}).second, true);
+    ASSERT_EQ(m.insert_or_assign(2, 21).second, false);
+    m[3] = 30;
+
+    ASSERT_EQ(m.size(), 3);
+    ASSERT_EQ(m.find(1)->second(), 10);
+    ASSERT_EQ(m.find(2)->second(), 21);
+    ASSERT_EQ(m[3](), 30);
+    ASSERT_EQ(m.contains(4), false);
+    ASSERT_EQ(m.count(3), 1);
+
+    int sum = 0;
+    for (auto& [k, v] : m)
+        sum += k * 100 + v();
+    ASSERT_EQ(sum, 600 + 61);
+
+    ASSERT_EQ(m.erase(2), 1);
+    ASSERT_EQ(m.erase(2), 0);
+    ASSERT_EQ(m.size(), 2);
+    m.erase(m.find(1));
+    ASSERT_EQ(m.size(), 1);
+    ASSERT_EQ(m.contains(1), false);
+    ASSERT_EQ(m.contains(3), true);
+
+    map_t c = m;
+    ASSERT_EQ(c.find(3)->second(), 30);
+    m.clear();
+    ASSERT_EQ(m.empty(), true);
+}
+
+TEST_F(ContainerTester, FlatMapFull)
+{
+    flat_map<int, objcounter, test_size, collide> m;
+
+    for (int i = 0; i < int(test_size); ++i)
+        ASSERT_EQ(m.try_emplace(i, i).second, true);
+    ASSERT_EQ(m.full(), true);
+    auto res = m.try_emplace(100, 0);
+    ASSERT_EQ(res.second, false);
+    ASSERT_EQ(res.first, m.end());
+    ASSERT_EQ(m.try_emplace(5, 0).first->second(), 5);
+
+    for (int i = 0; i < int(test_size); i += 2)
+        ASSERT_EQ(m.erase(i), 1);
+    for (int i = 0; i < int(test_size); ++i)
+        ASSERT_EQ(m.contains(i), i & 1);
+}
+
+TEST(ContainerFlatMap, Random)
+{
+    flat_map<uint32_t, uint32_t, 256> m;
+    std::map<uint32_t, uint32_t> ref;
+    uint32_t x = 1;
+    auto rand = [&] () {
+        x = x * 1664525 + 1013904223;
+        return x >> 16;
+    };
+    for (int i = 0; i < 100000; ++i) {
+        uint32_t key = rand() % 400;
+        switch (rand() % 3) {
+        case 0: {
+            bool room = ref.size() < m.capacity();
+            auto res = m.try_emplace(key, i);
+            auto exp = room || ref.count(key) ? ref.try_emplace(key, i).second : false;
+            ASSERT_EQ(res.second, exp);
+        } break;
+        case 1:
+            ASSERT_EQ(m.erase(key), ref.erase(key));
+            break;
+        case 2: {
+            auto it = m.find(key);
+            auto jt = ref.find(key);
+            ASSERT_EQ(it == m.end(), jt == ref.end());
+            if (jt != ref.end()) {
+                ASSERT_EQ(it->second, jt->second);
+            }
+        } break;
+        }
+        ASSERT_EQ(m.size(), ref.size());
+    }
+    size_t n = 0;
+    for (auto& [k, v] : m) {
+        ASSERT_EQ(ref.at(k), v);
+        ++n;
+    }
+    ASSERT_EQ(n, ref.size());
+}
+
+static_assert(std::is_same_v<flat_map<int, int, 0x80>::control_type, uint8_t>);
+static_assert(std::is_same_v<flat_map<int, int, 0x100>::control_type, uint16_t>);
+static_assert(std::is_same_v<flat_map<int, int, 0x8000>::control_type, uint16_t>);
+static_assert(std::is_same_v<flat_map<int, int, 0x10000>::control_type, uint32_t>);
+
+TEST(ContainerFlatMap, Constexpr)
+{
+    constexpr auto sum = [] {
+        flat_map<int, int, 16> m = {{1, 10}, {2, 20}, {3, 30}};
+        m.erase(2);
+        m[4] = 40;
+        int s = 0;
+        for (auto& [k, v] : m)
+            s += v;
+        return s;
+    }();
+    static_assert(sum == 80);
+
+    constexpr auto found = [] {
+        flat_set<std::array<uint8_t, 4>, 4> s;
+        s.insert({1, 2, 3, 4});
+        s.insert({4, 3, 2, 1});
+        return s.contains({4, 3, 2, 1}) && !s.contains({1, 1, 1, 1});
+    }();
+    static_assert(found);
+}
+
+TEST(ContainerFlatSet, Basic)
+{
+    flat_set<std::string_view, 4> s = {"a", "b", "c"};
+
+    ASSERT_EQ(s.size(), 3);
+    ASSERT_EQ(s.insert("a").second, false);
+    ASSERT_EQ(s.insert("d").second, true);
+    ASSERT_EQ(s.insert("e").first, s.end());
+    ASSERT_EQ(s.contains("c"), true);
+    ASSERT_EQ(s.erase("c"), 1);
+    ASSERT_EQ(s.contains("c"), false);
+    ASSERT_EQ(*s.find("d"), "d");
+}
+
+}
+}
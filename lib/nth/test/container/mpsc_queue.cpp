@@ -0,0 +1,82 @@
+#include "test.h"
+#include "nth/container/mpsc_queue.h"
+#include <thread>
+#include <vector>
+
+namespace nth {
+namespace {
+
+struct item : mpsc_node {
+    uint32_t producer;
+    uint32_t seq;
+};
+
+TEST(ContainerMpscQueue, Fifo)
+{
+    mpsc_queue<item> q;
+    item items[5];
+
+    ASSERT_EQ(q.empty(), true);
+    ASSERT_EQ(q.pop(), nullptr);
+
+    for (uint32_t i = 0; i < 5; ++i) {
+        items[i].seq = i;
+        q.push(&items[i]);
+    }
+    ASSERT_EQ(q.empty(), false);
+
+    for (uint32_t i = 0; i < 3; ++i)
+        ASSERT_EQ(q.pop(), &items[i]);
+
+    q.push(&items[0]);
+
+    ASSERT_EQ(q.pop(), &items[3]);
+    ASSERT_EQ(q.pop(), &items[4]);
+    ASSERT_EQ(q.pop(), &items[0]);
+    ASSERT_EQ(q.pop(), nullptr);
+    ASSERT_EQ(q.empty(), true);
+
+    q.push(&items[1]);
+    ASSERT_EQ(q.pop(), &items[1]);
+    ASSERT_EQ(q.pop(), nullptr);
+}
+
+TEST(ContainerMpscQueue, Threads)
+{
+    constexpr uint32_t producers = 4;
+    constexpr uint32_t count = 20000;
+
+    mpsc_queue<item> q;
+    std::vector<item> items(producers * count);
+    std::vector<std::thread> pool;
+
+    for (uint32_t p = 0; p < producers; ++p) {
+        pool.emplace_back([&, p] {
+            for (uint32_t i = 0; i < count; ++i) {
+                auto& it = items[p * count + i];
+                it.producer = p;
+                it.seq = i;
+                q.push(&it);
+            }
+        });
+    }
+    uint32_t next[producers] = {};
+    uint32_t total = 0;
+    while (total < producers * count) {
+        auto it = q.pop();
+        if (!it) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_LT(it->producer, producers);
+        ASSERT_EQ(it->seq, next[it->producer]++);
+        ++total;
+    }
+    for (auto& t : pool)
+        t.join();
+    ASSERT_EQ(q.pop(), nullptr);
+    ASSERT_EQ(q.empty(), true);
+}
+
+}
+}
@@ -0,0 +1,120 @@
+#include "test.h"
+#include "nth/container/pool_lockfree.h"
+#include <thread>
+#include <vector>
+
+namespace nth {
+namespace {
+
+constexpr size_t test_size = 5;
+
+using pool_t = pool_lockfree<objcounter, test_size>;
+
+void verify_pool(const pool_t& obj, size_t copy, size_t move, size_t taken)
+{
+    ASSERT_EQ(obj.capacity(), test_size);
+    ASSERT_EQ(obj.left(), test_size - taken);
+    ASSERT_EQ(obj.full(), taken == 0);
+    ASSERT_EQ(obj.empty(), taken == test_size);
+
+    objcounter::verify_count(copy, move);
+}
+
+struct ContainerPoolLockfree : ContainerTester {
+    void verify(size_t copy, size_t move, size_t taken)
+    {
+        verify_pool(p, copy, move, taken);
+    }
+    pool_t p;
+};
+
+TEST_F(ContainerPoolLockfree, Get)
+{
+    {
+    pool_t::return_type arr[test_size];
+    for (size_t i = 0; i < p.capacity(); ++i) {
+        arr[i] = p.get(i);
+        ASSERT_EQ(bool(arr[i]), true);
+        ASSERT_EQ((*arr[i])(), i);
+        verify(0, 0, i + 1);
+    }
+    ASSERT_EQ(bool(p.get()), false);
+    verify(0, 0, test_size);
+    }
+    {
+    auto val = p.get(42);
+    ASSERT_EQ(bool(val), true);
+    ASSERT_EQ((*val)(), 42);
+    verify(0, 0, 1);
+    }
+    verify(0, 0, 0);
+}
+
+TEST_F(ContainerPoolLockfree, GetReleaseN)
+{
+    pool_t::return_type arr[test_size];
+
+    ASSERT_EQ(p.get_n(std::span{arr, 3}, 7), 3);
+    verify(0, 0, 3);
+    for (size_t i = 0; i < 3; ++i)
+        ASSERT_EQ((*arr[i])(), 7);
+    ASSERT_NE(arr[0].get(), arr[1].get());
+    ASSERT_NE(arr[1].get(), arr[2].get());
+
+    ASSERT_EQ(p.get_n(std::span{arr + 3, 2}), 2);
+    verify(0, 0, 5);
+    ASSERT_EQ(p.get_n(std::span{arr, 1}), 0);
+
+    arr[1].reset();
+    verify(0, 0, 4);
+    p.release_n(arr);
+    verify(0, 0, 0);
+    for (auto& it : arr)
+        ASSERT_EQ(bool(it), false);
+
+    ASSERT_EQ(p.get_n(arr, 1), test_size);
+    verify(0, 0, test_size);
+}
+
+TEST(ContainerPoolLockfreeStress, Threads)
+{
+    constexpr size_t threads = 4;
+    constexpr size_t rounds = 20000;
+
+    pool_lockfree<std::pair<size_t, size_t>, 16> p;
+    std::vector<std::thread> pool;
+    std::atomic<bool> fail = false;
+
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            decltype(p)::return_type batch[3];
+            for (size_t i = 0; i < rounds; ++i) {
+                if (i & 1) {
+                    auto x = p.get(t, i);
+                    if (x && (x->first != t || x->second != i))
+                        fail = true;
+                } else {
+                    auto n = p.get_n(batch, t, i);
+                    for (size_t j = 0; j < n; ++j)
+                        if (batch[j]->first != t || batch[j]->second != i)
+                            fail = true;
+                    p.release_n(batch);
+                }
+                if (i % 64 == 0)
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& t : pool)
+        t.join();
+    ASSERT_EQ(fail, false);
+    ASSERT_EQ(p.full(), true);
+
+    decltype(p)::return_type all[16];
+    ASSERT_EQ(p.get_n(all), 16);
+    std::sort(std::begin(all), std::end(all));
+    ASSERT_EQ(std::adjacent_find(std::begin(all), std::end(all)), std::end(all));
+}
+
+}
+}
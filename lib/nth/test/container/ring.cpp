@@ -502,6 +502,113 @@ TEST_F(ContainerRing, GetFront)
     EXPECT_FALSE(r.get_front(item));
 }
 
+TEST_F(ContainerRing, PushBackSpan)
+{
+    std::array<objcounter, 3> arr = {7, 8, 9};
+
+    setup({1});
+    ASSERT_EQ(r.push_back(std::span{arr}.first(2)), 2);
+    verify(2, 0, {1, 7, 8});
+
+    setup({1, 2, 3});
+    r.pop_front();
+    ASSERT_EQ(r.push_back(arr), 2);
+    verify(2, 0, {2, 3, 7, 8}, {2, 3, 7}, {8});
+
+    ASSERT_EQ(r.push_back(arr), 0);
+    verify(2, 0, {2, 3, 7, 8}, {2, 3, 7}, {8});
+}
+
+TEST_F(ContainerRing, PopFrontSpan)
+{
+    std::array<objcounter, 3> arr;
+
+    setup({1, 2, 3, 4});
+    r.pop_front();
+    r.pop_front();
+    r.push_back(5);
+    r.push_back(6);
+    objcounter::clear_movecopy();
+
+    ASSERT_EQ(r.pop_front(std::span{arr}), 3);
+    verify_part(arr, {3, 4, 5});
+    verify(0, 3, {6});
+
+    ASSERT_EQ(r.pop_front(std::span{arr}), 1);
+    verify_part(std::span{arr}.first(1), {6});
+    verify(0, 4, {});
+
+    ASSERT_EQ(r.pop_front(std::span{arr}), 0);
+}
+
+TEST(ContainerRingBulk, ReserveCommit)
+{
+    ring<uint8_t, 16> r;
+
+    ASSERT_EQ(r.reserve_back().size(), 16);
+    ASSERT_EQ(r.reserve_back(5).size(), 5);
+    ASSERT_EQ(r.reserve_back(5).data(), r.pbegin());
+    r.commit_back(12);
+    r.consume_front(10);
+    ASSERT_EQ(r.peek_front().size(), 2);
+    ASSERT_EQ(r.reserve_back().size(), 4);
+    r.commit_back(4);
+    ASSERT_EQ(r.reserve_back().size(), 10);
+    ASSERT_EQ(r.reserve_back().data(), r.pbegin());
+    r.commit_back(10);
+    ASSERT_EQ(r.reserve_back().size(), 0);
+    ASSERT_TRUE(r.full());
+    ASSERT_EQ(r.peek_front().size(), 6);
+    r.consume_front(6);
+    ASSERT_EQ(r.peek_front().size(), 10);
+    r.consume_front(10);
+    ASSERT_TRUE(r.empty());
+    ASSERT_EQ(r.peek_front().size(), 0);
+}
+
+TEST(ContainerRingBulk, Stream)
+{
+    ring<uint8_t, 64> r;
+    uint8_t buf[100];
+    uint8_t wr = 0;
+    uint8_t rd = 0;
+    uint32_t x = 1;
+    auto rand = [&] () {
+        x = x * 1664525 + 1013904223;
+        return x >> 16;
+    };
+    for (int i = 0; i < 10000; ++i) {
+        size_t n = rand() % sizeof(buf);
+        switch (rand() % 4) {
+            case 0: {
+                for (size_t j = 0; j < n; ++j)
+                    buf[j] = wr + j;
+                auto pushed = r.push_back(std::span{buf, n});
+                ASSERT_LE(pushed, n);
+                wr += pushed;
+            } break;
+            case 1: {
+                auto space = r.reserve_back(n);
+                for (auto& b : space)
+                    b = wr++;
+                r.commit_back(space.size());
+            } break;
+            case 2: {
+                auto popped = r.pop_front({buf, n});
+                for (size_t j = 0; j < popped; ++j)
+                    ASSERT_EQ(buf[j], rd++);
+            } break;
+            case 3: {
+                auto data = r.peek_front().first(std::min(n, r.peek_front().size()));
+                for (auto b : data)
+                    ASSERT_EQ(b, rd++);
+                r.consume_front(data.size());
+            } break;
+        }
+        ASSERT_EQ(r.size(), uint8_t(wr - rd));
+    }
+}
+
 TEST_F(ContainerRing, Rotate)
 {
     r.push_back(1);
@@ -688,6 +795,7 @@ TEST_F(ContainerRing, Death)
     ASSERT_DEATH(r.emplace_back(), "");
     ASSERT_DEATH(r.erase_begin(test_size + 1), "");
     ASSERT_DEATH(r.erase_end(test_size + 1), "");
+    ASSERT_DEATH(r.consume_front(test_size + 1), "");
     ASSERT_DEATH(r.rotate(r.end()), "");
     ASSERT_DEATH(r.rotate(x.begin()), "");
 }
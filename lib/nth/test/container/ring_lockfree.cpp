@@ -0,0 +1,169 @@
+#include "test.h"
+#include "nth/container/ring_lockfree.h"
+#include <thread>
+#include <vector>
+
+namespace nth {
+namespace {
+
+constexpr size_t test_size = 4;
+
+TEST(ContainerRingLockfree, Spsc)
+{
+    spsc_ring<objcounter, test_size> r;
+    objcounter x;
+
+    ASSERT_EQ(r.empty(), true);
+    ASSERT_EQ(r.get_front(x), false);
+
+    for (int i = 0; i < int(test_size); ++i)
+        ASSERT_EQ(r.push_back(i), true);
+    ASSERT_EQ(r.push_back(42), false);
+    ASSERT_EQ(r.full(), true);
+
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ(r.get_front(x), true);
+        ASSERT_EQ(x(), i);
+    }
+    ASSERT_EQ(r.size(), 2);
+
+    std::array<objcounter, 3> arr = {4, 5, 6};
+    ASSERT_EQ(r.push_back(arr), 2);
+    ASSERT_EQ(r.full(), true);
+
+    std::array<objcounter, 8> out;
+    ASSERT_EQ(r.pop_front(out), 4);
+    for (int i = 0; i < 4; ++i)
+        ASSERT_EQ(out[i](), i + 2);
+    ASSERT_EQ(r.empty(), true);
+
+    ASSERT_EQ(r.push_back(7), true);
+}
+
+TEST(ContainerRingLockfree, SpscReserveCommit)
+{
+    spsc_ring<uint8_t, 16> r;
+
+    ASSERT_EQ(r.reserve_back().size(), 16);
+    r.commit_back(12);
+    ASSERT_EQ(r.peek_front().size(), 12);
+    r.consume_front(10);
+    ASSERT_EQ(r.reserve_back().size(), 4);
+    r.commit_back(4);
+    ASSERT_EQ(r.reserve_back().size(), 10);
+    r.commit_back(10);
+    ASSERT_EQ(r.reserve_back().size(), 0);
+    ASSERT_EQ(r.peek_front().size(), 6);
+    r.consume_front(6);
+    ASSERT_EQ(r.peek_front().size(), 10);
+    r.consume_front(10);
+    ASSERT_EQ(r.empty(), true);
+}
+
+TEST(ContainerRingLockfree, Mpsc)
+{
+    mpsc_ring<objcounter, test_size> r;
+    objcounter x;
+
+    ASSERT_EQ(r.get_front(x), false);
+
+    for (int i = 0; i < int(test_size); ++i)
+        ASSERT_EQ(r.push_back(i), true);
+    ASSERT_EQ(r.push_back(42), false);
+    ASSERT_EQ(r.full(), true);
+
+    ASSERT_EQ(r.get_front(x), true);
+    ASSERT_EQ(x(), 0);
+    ASSERT_EQ(r.push_back(4), true);
+
+    std::array<objcounter, 8> out;
+    ASSERT_EQ(r.pop_front(out), 4);
+    for (int i = 0; i < 4; ++i)
+        ASSERT_EQ(out[i](), i + 1);
+    ASSERT_EQ(r.empty(), true);
+
+    ASSERT_EQ(r.push_back(5), true);
+}
+
+TEST(ContainerRingLockfree, SpscStress)
+{
+    constexpr uint32_t count = 100000;
+
+    spsc_ring<uint32_t, 64> r;
+
+    std::thread producer([&] {
+        uint32_t buf[7];
+        uint32_t i = 0;
+        while (i < count) {
+            size_t n = 0;
+            if (i & 1) {
+                n = r.push_back(i);
+            } else {
+                n = std::min<uint32_t>(i % 7 + 1, count - i);
+                for (uint32_t j = 0; j < n; ++j)
+                    buf[j] = i + j;
+                n = r.push_back(std::span{buf, n});
+            }
+            if (!n)
+                std::this_thread::yield();
+            i += n;
+        }
+    });
+    uint32_t buf[5];
+    uint32_t i = 0;
+    size_t errors = 0;
+    while (i < count) {
+        size_t n = 0;
+        if (i & 1)
+            n = r.get_front(buf[0]);
+        else
+            n = r.pop_front(buf);
+        if (!n)
+            std::this_thread::yield();
+        for (size_t j = 0; j < n; ++j)
+            errors += buf[j] != i++;
+    }
+    producer.join();
+    ASSERT_EQ(errors, 0);
+    ASSERT_EQ(r.empty(), true);
+}
+
+TEST(ContainerRingLockfree, MpscStress)
+{
+    constexpr uint32_t producers = 4;
+    constexpr uint32_t count = 25000;
+
+    mpsc_ring<uint32_t, 64> r;
+    std::vector<std::thread> pool;
+
+    for (uint32_t p = 0; p < producers; ++p) {
+        pool.emplace_back([&, p] {
+            for (uint32_t i = 0; i < count;) {
+                if (r.push_back(p << 24 | i))
+                    ++i;
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+    uint32_t next[producers] = {};
+    uint32_t total = 0;
+    size_t errors = 0;
+    while (total < producers * count) {
+        uint32_t x;
+        if (r.get_front(x)) {
+            auto p = x >> 24;
+            errors += p >= producers || (x & 0xffffff) != next[p]++;
+            ++total;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : pool)
+        t.join();
+    ASSERT_EQ(errors, 0);
+    ASSERT_EQ(r.empty(), true);
+}
+
+}
+}
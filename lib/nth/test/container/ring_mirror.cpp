@@ -0,0 +1,99 @@
+#include "test.h"
+#include "nth/container/ring_mirror.h"
+#include <vector>
+
+namespace nth {
+namespace {
+
+TEST(ContainerRingMirror, Basic)
+{
+    ring_mirror r(1);
+
+    ASSERT_EQ(r.valid(), true);
+    ASSERT_GE(r.capacity(), 4096);
+    ASSERT_EQ(std::has_single_bit(r.capacity()), true);
+    ASSERT_EQ(r.empty(), true);
+    ASSERT_EQ(r.linearize(), nullptr);
+
+    ring_mirror x;
+    ASSERT_EQ(x.valid(), false);
+    x = std::move(r);
+    ASSERT_EQ(x.valid(), true);
+    ASSERT_EQ(r.valid(), false);
+}
+
+TEST(ContainerRingMirror, Wrap)
+{
+    ring_mirror r(1);
+    auto cap = r.capacity();
+    std::vector<byte> in(cap);
+    std::vector<byte> out(cap);
+
+    for (size_t i = 0; i < cap; ++i)
+        in[i] = i * 7;
+
+    ASSERT_EQ(r.push_back(std::span{in}.first(cap - 10)), cap - 10);
+    r.consume_front(cap - 20);
+    ASSERT_EQ(r.push_back(in), cap - 10);
+    ASSERT_EQ(r.full(), true);
+    ASSERT_EQ(r.reserve_back().size(), 0);
+
+    auto data = r.peek_front();
+    ASSERT_EQ(data.size(), cap);
+    for (size_t i = 0; i < 10; ++i)
+        ASSERT_EQ(data[i], in[cap - 20 + i]);
+    for (size_t i = 10; i < cap; ++i)
+        ASSERT_EQ(data[i], in[i - 10]);
+    ASSERT_EQ(r.array_two().size(), 0);
+    ASSERT_EQ(r.back(), in[cap - 11]);
+
+    ASSERT_EQ(r.pop_front(std::span{out}.first(20)), 20);
+    ASSERT_EQ(std::memcmp(out.data(), in.data() + cap - 20, 10), 0);
+    ASSERT_EQ(std::memcmp(out.data() + 10, in.data(), 10), 0);
+
+    auto space = r.reserve_back();
+    ASSERT_EQ(space.size(), 20);
+    std::fill(space.begin(), space.end(), 0xaa);
+    r.commit_back(space.size());
+    ASSERT_EQ(r.size(), cap);
+    ASSERT_EQ(r[cap - 1], 0xaa);
+    ASSERT_EQ(r[cap - 21], in[cap - 11]);
+}
+
+TEST(ContainerRingMirror, Read)
+{
+    ring_mirror r(1);
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::vector<byte> in(r.capacity() / 3);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = i;
+
+    size_t total = 0;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(write(fds[1], in.data(), in.size()), ssize_t(in.size()));
+        auto space = r.reserve_back(in.size());
+        ASSERT_EQ(read(fds[0], space.data(), space.size()), ssize_t(in.size()));
+        r.commit_back(in.size());
+
+        auto data = r.peek_front();
+        ASSERT_EQ(std::memcmp(data.data(), in.data(), in.size()), 0);
+        r.consume_front(in.size());
+        total += in.size();
+    }
+    ASSERT_GT(total, r.capacity());
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(ContainerRingMirror, Death)
+{
+    ring_mirror r(1);
+
+    ASSERT_DEATH(r.consume_front(1), "");
+    ASSERT_DEATH(r.commit_back(r.capacity() + 1), "");
+}
+
+}
+}
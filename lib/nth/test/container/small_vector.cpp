@@ -0,0 +1,201 @@
+#include "test.h"
+#include "nth/container/small_vector.h"
+#include <vector>
+
+namespace nth {
+namespace {
+
+constexpr size_t test_size = 4;
+
+using vector_t = small_vector<objcounter, test_size>;
+
+void verify_vec(const vector_t& obj, std::initializer_list<int> arr)
+{
+    size_t size = arr.size();
+
+    ASSERT_EQ(obj.inline_capacity(), test_size);
+    ASSERT_GE(obj.capacity(), size);
+    ASSERT_EQ(obj.size(), size);
+    ASSERT_EQ(obj.empty(), size == 0);
+    ASSERT_EQ(obj.is_inline(), obj.capacity() == test_size);
+    ASSERT_EQ(obj.begin() + size, obj.end());
+    ASSERT_EQ(obj.begin(), obj.data());
+    ASSERT_EQ(obj.rbegin() + size, obj.rend());
+
+    for (size_t i = 0; auto it : arr)
+        ASSERT_EQ(obj[i++](), it) << "at index " << i;
+}
+
+struct ContainerSmallVector : ContainerTester {
+    void TearDown() override
+    {
+        v.clear();
+        v.shrink_to_fit();
+        ContainerTester::TearDown();
+    }
+    void setup(std::initializer_list<int> arr)
+    {
+        v.clear();
+        for (auto it : arr)
+            v.emplace_back(it);
+    }
+    void verify(std::initializer_list<int> arr)
+    {
+        verify_vec(v, arr);
+    }
+    vector_t v;
+};
+
+TEST_F(ContainerSmallVector, Constructor)
+{
+    {
+    vector_t x;
+    verify_vec(x, {});
+    }
+    {
+    vector_t x(3, 7);
+    verify_vec(x, {7, 7, 7});
+    }
+    {
+    vector_t x(6);
+    verify_vec(x, {0, 0, 0, 0, 0, 0});
+    ASSERT_EQ(x.is_inline(), false);
+    }
+    {
+    vector_t x = {1, 2, 3, 4, 5};
+    vector_t y = x;
+    verify_vec(y, {1, 2, 3, 4, 5});
+    vector_t z = std::move(x);
+    verify_vec(z, {1, 2, 3, 4, 5});
+    verify_vec(x, {});
+    }
+    {
+    vector_t x = {1, 2};
+    vector_t y = std::move(x);
+    verify_vec(y, {1, 2});
+    verify_vec(x, {});
+    }
+}
+
+TEST_F(ContainerSmallVector, Assignment)
+{
+    vector_t x = {1, 2, 3, 4, 5, 6};
+    setup({9});
+    v = x;
+    verify({1, 2, 3, 4, 5, 6});
+    x = {7};
+    verify_vec(x, {7});
+    v = std::move(x);
+    verify({7});
+    ASSERT_EQ(v.is_inline(), true);
+    verify_vec(x, {});
+    x = {1, 2, 3, 4, 5};
+    v.swap(x);
+    verify({1, 2, 3, 4, 5});
+    verify_vec(x, {7});
+}
+
+TEST_F(ContainerSmallVector, PushBackSpill)
+{
+    for (int i = 0; i < 4; ++i)
+        v.push_back(i);
+    verify({0, 1, 2, 3});
+    ASSERT_EQ(v.is_inline(), true);
+
+    v.emplace_back(4);
+    verify({0, 1, 2, 3, 4});
+    ASSERT_EQ(v.capacity(), 8);
+
+    v.push_back(v[0]);
+    verify({0, 1, 2, 3, 4, 0});
+
+    v.pop_back();
+    v.pop_back();
+    v.pop_back();
+    v.shrink_to_fit();
+    verify({0, 1, 2});
+    ASSERT_EQ(v.is_inline(), true);
+
+    v.reserve(100);
+    ASSERT_EQ(v.capacity(), 100);
+    verify({0, 1, 2});
+}
+
+TEST_F(ContainerSmallVector, Insert)
+{
+    setup({1, 2, 3});
+    v.insert(v.begin() + 1, 9);
+    verify({1, 9, 2, 3});
+    v.insert(v.begin(), v.back());
+    verify({3, 1, 9, 2, 3});
+    v.insert(v.begin() + 2, 2, 5);
+    verify({3, 1, 5, 5, 9, 2, 3});
+    v.insert(v.end(), {7, 8});
+    verify({3, 1, 5, 5, 9, 2, 3, 7, 8});
+    v.insert(v.begin() + 1, 12, 0);
+    ASSERT_EQ(v.size(), 21);
+    ASSERT_EQ(v[13](), 1);
+}
+
+TEST_F(ContainerSmallVector, Erase)
+{
+    setup({1, 2, 3, 4, 5, 6});
+    ASSERT_EQ(v.erase(v.begin() + 1), v.begin() + 1);
+    verify({1, 3, 4, 5, 6});
+    v.erase(v.begin() + 1, v.begin() + 3);
+    verify({1, 5, 6});
+    v.erase(v.begin(), v.begin());
+    verify({1, 5, 6});
+    v.erase(v.begin(), v.end());
+    verify({});
+}
+
+TEST_F(ContainerSmallVector, Resize)
+{
+    v.resize(2, 5);
+    verify({5, 5});
+    v.resize(5);
+    verify({5, 5, 0, 0, 0});
+    v.resize(1);
+    verify({5});
+}
+
+TEST(ContainerSmallVectorTrivial, Relocation)
+{
+    small_vector<int, 8> x;
+    std::vector<int> ref;
+
+    for (int i = 0; i < 100; ++i) {
+        auto pos = (i * 7) % (ref.size() + 1);
+        x.insert(x.begin() + pos, i);
+        ref.insert(ref.begin() + pos, i);
+        if (i % 5 == 4) {
+            x.erase(x.begin() + pos / 2);
+            ref.erase(ref.begin() + pos / 2);
+        }
+    }
+    ASSERT_EQ(std::vector<int>(x.begin(), x.end()), ref);
+
+    x.erase(x.begin() + 4, x.end());
+    x.shrink_to_fit();
+    ASSERT_EQ(x.is_inline(), true);
+    ASSERT_EQ(std::vector<int>(x.begin(), x.end()), std::vector<int>(ref.begin(), ref.begin() + 4));
+}
+
+TEST(ContainerSmallVectorTrivial, Constexpr)
+{
+    constexpr auto sum = [] {
+        small_vector<int, 2> x = {1, 2};
+        x.push_back(3);
+        x.insert(x.begin(), 4);
+        x.erase(x.begin() + 1);
+        int s = 0;
+        for (auto it : x)
+            s = s * 10 + it;
+        return s;
+    }();
+    static_assert(sum == 423);
+}
+
+}
+}
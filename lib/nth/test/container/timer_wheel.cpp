@@ -0,0 +1,121 @@
+#include "test.h"
+#include "nth/container/timer_wheel.h"
+#include <random>
+#include <vector>
+
+namespace nth {
+namespace {
+
+struct timer : timer_node<uint16_t> {
+    size_t id;
+    uint16_t due;
+};
+
+TEST(ContainerTimerWheel, Basic)
+{
+    timer_wheel<uint32_t, 4, 2> w;
+    timer_node<uint32_t> a, b, c;
+    std::vector<timer_node<uint32_t>*> fired;
+    auto collect = [&] (auto& node) { fired.push_back(&node); };
+
+    ASSERT_EQ(w.empty(), true);
+    w.schedule(a, 5);
+    w.schedule(b, 5);
+    w.schedule_in(c, 40);
+    ASSERT_EQ(w.size(), 3);
+    ASSERT_EQ(a.active(), true);
+    ASSERT_EQ(c.deadline(), 40);
+
+    ASSERT_EQ(w.advance(4, collect), 0);
+    ASSERT_EQ(w.advance(5, collect), 2);
+    ASSERT_EQ(fired, (std::vector<timer_node<uint32_t>*>{&a, &b}));
+    ASSERT_EQ(a.active(), false);
+    ASSERT_EQ(w.size(), 1);
+
+    ASSERT_EQ(w.cancel(c), true);
+    ASSERT_EQ(w.cancel(c), false);
+    ASSERT_EQ(w.empty(), true);
+    ASSERT_EQ(w.advance(100, collect), 0);
+    ASSERT_EQ(w.time(), 100);
+
+    w.schedule(a, 50);
+    ASSERT_EQ(w.advance(101, collect), 1);
+    ASSERT_EQ(fired.back(), &a);
+
+    w.schedule(a, 200);
+    w.schedule(a, 150);
+    ASSERT_EQ(w.size(), 1);
+    ASSERT_EQ(w.advance(149, collect), 0);
+    ASSERT_EQ(w.advance(150, collect), 1);
+
+    w.schedule(a, 1000);
+    w.clear();
+    ASSERT_EQ(a.active(), false);
+    ASSERT_EQ(w.empty(), true);
+}
+
+TEST(ContainerTimerWheel, Reschedule)
+{
+    timer_wheel<uint32_t, 3, 3> w;
+    timer_node<uint32_t> node;
+    size_t count = 0;
+
+    w.schedule(node, 10);
+    w.advance(1000, [&] (auto& n) {
+        ++count;
+        if (count < 20)
+            w.schedule_in(n, 10);
+    });
+    ASSERT_EQ(count, 20);
+    ASSERT_EQ(w.empty(), true);
+}
+
+TEST(ContainerTimerWheel, Random)
+{
+    constexpr size_t count = 200;
+
+    timer_wheel<uint16_t, 2, 3> w {65000};
+    timer timers[count];
+    std::mt19937 rng{42};
+
+    for (size_t i = 0; i < count; ++i)
+        timers[i].id = i;
+
+    for (size_t round = 0; round < 5000; ++round) {
+        auto& t = timers[rng() % count];
+        switch (rng() % 4) {
+        case 0:
+        case 1:
+            t.due = uint16_t(w.time() + 1 + rng() % 200);
+            w.schedule(t, t.due);
+            break;
+        case 2:
+            ASSERT_EQ(w.cancel(t), t.active());
+            break;
+        case 3: {
+            auto from = w.time();
+            auto to = uint16_t(from + rng() % 50);
+            std::vector<size_t> expected, actual;
+            for (auto& it : timers)
+                if (it.active() && int16_t(it.due - to) <= 0)
+                    expected.push_back(it.id);
+            auto n = w.advance(to, [&] (auto& node) {
+                auto& it = static_cast<timer&>(node);
+                ASSERT_EQ(it.due, w.time());
+                actual.push_back(it.id);
+            });
+            std::sort(expected.begin(), expected.end());
+            std::sort(actual.begin(), actual.end());
+            ASSERT_EQ(n, actual.size());
+            ASSERT_EQ(actual, expected);
+        }
+        }
+        size_t active = 0;
+        for (auto& it : timers)
+            active += it.active();
+        ASSERT_EQ(w.size(), active);
+    }
+}
+
+}
+}
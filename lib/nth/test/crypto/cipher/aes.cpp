@@ -1,11 +1,11 @@
-#include "test.h"
-#include "shoc/cipher/aes.h"
+#include "crypto/test.h"
+#include "nth/crypto/cipher/aes.h"
 
-namespace shoc {
+namespace nth {
 namespace {
 
 template<class E>
-void check(span_i<E::key_size> key, span_i<E::block_size> msg, span_i<E::block_size> exp)
+void check(ispan<E::key_size> key, ispan<E::block_size> msg, ispan<E::block_size> exp)
 {
     byte out[E::block_size] = {};
 
@@ -1,16 +1,16 @@
-#include "test.h"
-#include "shoc/kdf/hkdf.h"
-#include "shoc/hash/sha2.h"
+#include "crypto/test.h"
+#include "nth/crypto/kdf/hkdf.h"
+#include "nth/crypto/hash/sha2.h"
 
-namespace shoc {
+namespace nth {
 namespace {
 
 struct data {
-    span_i<> ikm;
-    span_i<> salt;
-    span_i<> info;
-    span_i<> exp;
-    span_o<> out;
+    ispan<> ikm;
+    ispan<> salt;
+    ispan<> info;
+    ispan<> exp;
+    ospan<> out;
 };
 
 template<class H, size_t N>
@@ -1,12 +1,12 @@
-#ifndef SHOC_TEST_H
-#define SHOC_TEST_H
+#ifndef NTH_TEST_CRYPTO_H
+#define NTH_TEST_CRYPTO_H
 
 #include <gtest/gtest.h>
-#include "shoc/util.h"
+#include "nth/crypto/util.h"
 
-namespace shoc {
+namespace nth {
 
-inline void compare(span_i<> out, span_i<> exp)
+inline void compare(ispan<> out, ispan<> exp)
 {
     ASSERT_TRUE(out.data());
     ASSERT_TRUE(exp.data());
@@ -17,4 +17,4 @@ inline void compare(span_i<> out, span_i<> exp)
 
 }
 
-#endif
\ No newline at end of file
+#endif
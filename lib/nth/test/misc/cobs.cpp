@@ -26,10 +26,10 @@ constexpr byte encoded_buf_5[]  = { 0x02, 0x11, 0x01, 0x01, 0x01, 0x00, };
 constexpr byte encoded_buf_6[]  = { 0xff, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf, 0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf, 0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf, 0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef, 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0x00, };
 constexpr byte encoded_buf_7[]  = { 0x01, 0xff, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf, 0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf, 0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf, 0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef, 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0x00, };
 constexpr byte encoded_buf_8[]  = { 0xff, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf, 0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf, 0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf, 0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef, 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0x02, 0xff, 0x00, };
-constexpr byte encoded_buf_9[]  = { 0xff, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf, 0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf, 0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf, 0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef, 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff, 0x01, 0x00, };
+constexpr byte encoded_buf_9[]  = { 0xff, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf, 0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf, 0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf, 0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef, 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff, 0x01, 0x01, 0x00, };
 constexpr byte encoded_buf_10[] = { 0xfe, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f, 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf, 0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf, 0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf, 0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef, 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff, 0x02, 0x01, 0x00, };
 
-byte output_data[258];
+byte output_data[1024];
 size_t output_size;
 size_t output_left;
 
@@ -69,6 +69,273 @@ TEST(UtilCobs, CobsPipeEncoder)
     test(input_buf_10, encoded_buf_10);
 }
 
+TEST(UtilCobs, CobsEncoderWithCrc)
+{
+    constexpr byte input[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    constexpr byte expected[] = { 0x0e, '1', '2', '3', '4', '5', '6', '7', '8', '9', 0x26, 0x39, 0xf4, 0xcb, 0x00 };
+
+    auto encoder_callback = [] (const uint8_t* buf, size_t len) 
+    {
+        if (output_size + len <= sizeof(output_data)) {
+            std::copy_n(buf, len, output_data + output_size);
+            output_size += len;
+        }
+        return len;
+    };
+
+    auto test_pipe = [&] <class Crc> (basic_cobs_pipe_encoder_with_crc<Crc> encoder) 
+    {
+        output_size = 0;
+        encoder.sink({input, 4}, encoder_callback);
+        encoder.sink({input + 4, sizeof(input) - 4}, encoder_callback);
+        encoder.stop(encoder_callback);
+        assert_arreq({output_data, output_size}, expected);
+    };
+
+    auto test_span = [&] <class Crc> (Crc) 
+    {
+        byte out[sizeof(expected)] = {};
+        ASSERT_EQ(cobs_encode_with_crc<Crc>(input, out), sizeof(expected) - 1);
+        assert_arreq({out, sizeof(expected) - 1}, {expected, sizeof(expected) - 1});
+        ASSERT_EQ(cobs_encode_with_crc<Crc>(input, {out, sizeof(expected) - 2}), 0);
+
+        output_size = 0;
+        ASSERT_EQ(cobs_encode_with_crc<Crc>(input, encoder_callback), sizeof(expected) - 1);
+        assert_arreq({output_data, output_size}, {expected, sizeof(expected) - 1});
+    };
+
+    using slow_crc      = crc_slow_policy   <uint32_t, 0x04c11db7, 0xffffffff, 0xffffffff, true, true>;
+    using nibble_crc    = crc_nibble_policy <uint32_t, 0x04c11db7, 0xffffffff, 0xffffffff, true, true>;
+    using hybrid_crc    = crc_hybrid_policy <uint32_t, 0x04c11db7, 0xffffffff, 0xffffffff, true, true>;
+
+    test_pipe(cobs_pipe_encoder_with_crc{});
+    test_pipe(basic_cobs_pipe_encoder_with_crc<slow_crc>{});
+    test_pipe(basic_cobs_pipe_encoder_with_crc<nibble_crc>{});
+    test_pipe(basic_cobs_pipe_encoder_with_crc<hybrid_crc>{});
+
+    test_span(cobs_crc_default{});
+    test_span(slow_crc{});
+    test_span(nibble_crc{});
+    test_span(hybrid_crc{});
+
+    for (size_t len = 250; len < 260; ++len) {
+        byte in[260 + 4] = {};
+        byte exp[sizeof(in) + 8];
+        byte out[sizeof(in) + 8];
+        for (size_t i = 0; i < len; ++i)
+            in[i] = i % 255;
+        putle(crc<crc32>({in, len}), in + len);
+        auto exp_len = cobs_encode({in, len + 4}, exp);
+        ASSERT_EQ(cobs_encode_with_crc({in, len}, out), exp_len);
+        assert_arreq({out, exp_len}, {exp, exp_len});
+    }
+}
+
+TEST(UtilCobs, CobsDecode)
+{
+    auto test = [&] (std::span<const uint8_t> exp, std::span<const uint8_t> arr) 
+    {
+        byte out[sizeof(output_data)] = {};
+        ASSERT_EQ(cobs_decode(arr.first(arr.size() - 1), out), exp.size());
+        assert_arreq({out, exp.size()}, exp);
+        ASSERT_EQ(cobs_decode(arr.first(arr.size() - 1), {out, exp.size() - 1}), 0);
+    };
+
+    test(input_buf_0, encoded_buf_0);
+    test(input_buf_1, encoded_buf_1);
+    test(input_buf_2, encoded_buf_2);
+    test(input_buf_3, encoded_buf_3);
+    test(input_buf_4, encoded_buf_4);
+    test(input_buf_5, encoded_buf_5);
+    test(input_buf_6, encoded_buf_6);
+    test(input_buf_7, encoded_buf_7);
+    test(input_buf_8, encoded_buf_8);
+    test(input_buf_9, encoded_buf_9);
+    test(input_buf_10, encoded_buf_10);
+
+    byte out[8];
+    constexpr byte malformed_0[] = { 0x03, 0x11 };
+    constexpr byte malformed_1[] = { 0x03, 0x11, 0x00 };
+    constexpr byte malformed_2[] = { 0x00 };
+    ASSERT_EQ(cobs_decode(malformed_0, out), 0);
+    ASSERT_EQ(cobs_decode(malformed_1, out), 0);
+    ASSERT_EQ(cobs_decode(malformed_2, out), 0);
+}
+
+template<class Enc, class Dec, class Pipe>
+void check_cobs_variant(Enc encode, Dec decode, Pipe pipe)
+{
+    auto encoder_callback = [] (const uint8_t* buf, size_t len) 
+    {
+        if (output_size + len <= sizeof(output_data)) {
+            std::copy_n(buf, len, output_data + output_size);
+            output_size += len;
+        }
+        return len;
+    };
+    uint32_t x = 1;
+    auto rand = [&] () {
+        x = x * 1664525 + 1013904223;
+        return x >> 16;
+    };
+    for (int i = 0; i < 2000; ++i) {
+        byte in[600];
+        byte enc[sizeof(in) + 8];
+        byte dec[sizeof(in)];
+        auto len = rand() % sizeof(in);
+        auto zeros = rand() % 4;
+        for (size_t j = 0; j < len; ++j)
+            in[j] = rand() % 4 < zeros ? 0 : rand();
+
+        auto enc_len = encode(std::span<const byte>{in, len}, std::span<byte>{enc});
+        ASSERT_NE(enc_len, 0);
+        ASSERT_LE(enc_len, len + 1 + len / 223);
+        ASSERT_EQ(std::count(enc, enc + enc_len, 0), 0);
+        ASSERT_EQ(decode(std::span<const byte>{enc, enc_len}, std::span<byte>{dec}), len ? len : 0);
+        assert_arreq({dec, len}, {in, len});
+
+        output_size = 0;
+        pipe.sink({in, len / 2}, encoder_callback);
+        pipe.sink({in + len / 2, len - len / 2}, encoder_callback);
+        pipe.stop(encoder_callback);
+        ASSERT_EQ(output_size, enc_len + 1);
+        ASSERT_EQ(output_data[enc_len], 0);
+        assert_arreq({output_data, enc_len}, {enc, enc_len});
+    }
+}
+
+TEST(UtilCobs, Cobsr)
+{
+    auto test = [&] (std::span<const uint8_t> arr, std::span<const uint8_t> exp) 
+    {
+        byte out[16] = {};
+        ASSERT_EQ(cobsr_encode(arr, out), exp.size());
+        assert_arreq({out, exp.size()}, exp);
+        byte dec[16] = {};
+        ASSERT_EQ(cobsr_decode(exp, dec), arr.size());
+        assert_arreq({dec, arr.size()}, arr);
+    };
+    constexpr byte in_0[] = { 0x31, 0x32, 0x33, 0x34, 0x35 };
+    constexpr byte in_1[] = { 0x12, 0x00, 0x34, 0x02 };
+    constexpr byte in_2[] = { 0x12, 0x00, 0x34, 0x03 };
+    constexpr byte in_3[] = { 0x02 };
+    constexpr byte in_4[] = { 0x12, 0x00 };
+    constexpr byte out_0[] = { 0x35, 0x31, 0x32, 0x33, 0x34 };
+    constexpr byte out_1[] = { 0x02, 0x12, 0x03, 0x34, 0x02 };
+    constexpr byte out_2[] = { 0x02, 0x12, 0x03, 0x34 };
+    constexpr byte out_3[] = { 0x02 };
+    constexpr byte out_4[] = { 0x02, 0x12, 0x01 };
+    test(in_0, out_0);
+    test(in_1, out_1);
+    test(in_2, out_2);
+    test(in_3, out_3);
+    test(in_4, out_4);
+
+    output_size = 0;
+    cobsr_encode(in_0, [] (const uint8_t* buf, size_t len) {
+        std::copy_n(buf, len, output_data + output_size);
+        output_size += len;
+        return len;
+    });
+    assert_arreq({output_data, output_size}, out_0);
+
+    check_cobs_variant(
+        [] (auto in, auto out) { return cobsr_encode(in, out); }, 
+        [] (auto in, auto out) { return cobsr_decode(in, out); }, 
+        cobsr_pipe_encoder{});
+    check_cobs_variant(
+        [] (auto in, auto out) { return cobs_encode(in, out); }, 
+        [] (auto in, auto out) { return cobs_decode(in, out); }, 
+        cobs_pipe_encoder{});
+}
+
+TEST(UtilCobs, CobsZpe)
+{
+    auto test = [&] (std::span<const uint8_t> arr, std::span<const uint8_t> exp) 
+    {
+        byte out[300] = {};
+        ASSERT_EQ(cobs_zpe_encode(arr, out), exp.size());
+        assert_arreq({out, exp.size()}, exp);
+        byte dec[300] = {};
+        ASSERT_EQ(cobs_zpe_decode(exp, dec), arr.size());
+        assert_arreq({dec, arr.size()}, arr);
+    };
+    constexpr byte in_0[] = { 0x11, 0x00, 0x00, 0x22 };
+    constexpr byte in_1[] = { 0x11, 0x00 };
+    constexpr byte in_2[] = { 0x11, 0x00, 0x22 };
+    constexpr byte in_3[] = { 0x00, 0x00, 0x00 };
+    constexpr byte out_0[] = { 0xe2, 0x11, 0x02, 0x22 };
+    constexpr byte out_1[] = { 0xe2, 0x11 };
+    constexpr byte out_2[] = { 0x02, 0x11, 0x02, 0x22 };
+    constexpr byte out_3[] = { 0xe1, 0xe1 };
+    test(in_0, out_0);
+    test(in_1, out_1);
+    test(in_2, out_2);
+    test(in_3, out_3);
+
+    byte zeros[20] = {};
+    byte wide[64] = {};
+    byte tight[11] = {};
+    ASSERT_EQ(cobs_zpe_encode(zeros, wide), sizeof(tight));
+    ASSERT_EQ(cobs_zpe_encode(zeros, tight), sizeof(tight));
+    assert_arreq(tight, {wide, sizeof(tight)});
+    ASSERT_EQ(cobs_zpe_encode(zeros, {tight, sizeof(tight) - 1}), 0);
+
+    check_cobs_variant(
+        [] (auto in, auto out) { return cobs_zpe_encode(in, out); }, 
+        [] (auto in, auto out) { return cobs_zpe_decode(in, out); }, 
+        cobs_zpe_pipe_encoder{});
+}
+
+TEST(UtilCobs, CobsVectored)
+{
+    auto encoder_callback = [] (const uint8_t* buf, size_t len) 
+    {
+        if (output_size + len <= sizeof(output_data)) {
+            std::copy_n(buf, len, output_data + output_size);
+            output_size += len;
+        }
+        return len;
+    };
+    uint32_t x = 7;
+    auto rand = [&] () {
+        x = x * 1664525 + 1013904223;
+        return x >> 16;
+    };
+    for (int i = 0; i < 2000; ++i) {
+        byte in[600];
+        byte exp[sizeof(in) + 8];
+        byte out[sizeof(in) + 8];
+        auto len = rand() % sizeof(in);
+        auto zeros = rand() % 4;
+        for (size_t j = 0; j < len; ++j)
+            in[j] = rand() % 4 < zeros ? 0 : rand() % 255 + 1;
+
+        std::span<const byte> frags[4];
+        size_t cuts[5] = { 0, rand() % (len + 1), rand() % (len + 1), rand() % (len + 1), len };
+        std::sort(cuts, cuts + 5);
+        for (size_t j = 0; j < 4; ++j)
+            frags[j] = {in + cuts[j], cuts[j + 1] - cuts[j]};
+
+        auto test = [&] (auto encode_contiguous, auto encode_vectored) {
+            auto exp_len = encode_contiguous(std::span<const byte>{in, len}, std::span<byte>{exp});
+            ASSERT_NE(exp_len, 0);
+            ASSERT_EQ(encode_vectored(frags, std::span<byte>{out}), exp_len);
+            assert_arreq({out, exp_len}, {exp, exp_len});
+            ASSERT_EQ(encode_vectored(frags, std::span<byte>{out, exp_len - 1}), 0);
+            output_size = 0;
+            ASSERT_EQ(encode_vectored(frags, encoder_callback), exp_len);
+            assert_arreq({output_data, output_size}, {exp, exp_len});
+        };
+        test([] (auto in, auto out) { return cobs_encode(in, out); }, 
+             [] (std::span<const std::span<const byte>> in, auto out) { return cobs_encode(in, out); });
+        test([] (auto in, auto out) { return cobsr_encode(in, out); }, 
+             [] (std::span<const std::span<const byte>> in, auto out) { return cobsr_encode(in, out); });
+        test([] (auto in, auto out) { return cobs_encode_with_crc(in, out); }, 
+             [] (std::span<const std::span<const byte>> in, auto out) { return cobs_encode_with_crc(in, out); });
+    }
+}
+
 TEST(UtilCobs, CobsPipeDecoder)
 {
     cobs_pipe_decoder decoder;
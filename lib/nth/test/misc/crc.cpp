@@ -30,11 +30,20 @@ auto check_fast_and_slow_constexpr(T exp)
         ret = crc_fast_stop<T, xorout, refout>(ret);
         return ret;
     }();
+    static constexpr auto nibble_1 = crc_nibble<T, poly, init, xorout, refin, refout>({test_data_bytes, test_size});
+    static constexpr auto hybrid_1 = crc_hybrid<T, poly, init, xorout, refin, refout>({test_data_bytes, test_size});
+    static constexpr auto comb_1 = crc_combine<T, poly, init, xorout, refin, refout>(
+        crc_fast<T, poly, init, xorout, refin, refout>({test_data_bytes, test_part}),
+        crc_fast<T, poly, init, xorout, refin, refout>({test_data_bytes + test_part, test_size - test_part}),
+        test_size - test_part);
 
     ASSERT_EQ(exp, slow_1);
     ASSERT_EQ(exp, slow_2);
     ASSERT_EQ(exp, fast_1);
     ASSERT_EQ(exp, fast_2);
+    ASSERT_EQ(exp, nibble_1);
+    ASSERT_EQ(exp, hybrid_1);
+    ASSERT_EQ(exp, comb_1);
 }
 
 template<class T, T poly, T init, T xorout, bool refin, bool refout>
@@ -58,11 +67,28 @@ auto check_fast_and_slow(T exp)
         ret = crc_fast_stop<T, xorout, refout>(ret);
         return ret;
     }();
+    auto policy = [] <class C> (C) {
+        auto ret = C::start();
+        ret = C::feed(ret, {reinterpret_cast<const byte*>(test_data), test_part});
+        ret = C::feed(ret, {reinterpret_cast<const byte*>(test_data) + test_part, test_size - test_part});
+        return C::stop(ret);
+    };
+    auto comb = [] (size_t part) {
+        auto a = crc_slow<T, poly, init, xorout, refin, refout>({reinterpret_cast<const byte*>(test_data), part});
+        auto b = crc_slow<T, poly, init, xorout, refin, refout>({reinterpret_cast<const byte*>(test_data) + part, test_size - part});
+        return crc_combine<T, poly, init, xorout, refin, refout>(a, b, test_size - part);
+    };
 
     ASSERT_EQ(exp, slow_1);
     ASSERT_EQ(exp, slow_2);
     ASSERT_EQ(exp, fast_1);
     ASSERT_EQ(exp, fast_2);
+    ASSERT_EQ(exp, policy(crc_slow_policy<T, poly, init, xorout, refin, refout>{}));
+    ASSERT_EQ(exp, policy(crc_nibble_policy<T, poly, init, xorout, refin, refout>{}));
+    ASSERT_EQ(exp, policy(crc_hybrid_policy<T, poly, init, xorout, refin, refout>{}));
+    ASSERT_EQ(exp, policy(crc_fast_policy<T, poly, init, xorout, refin, refout>{}));
+    for (size_t i = 0; i <= test_size; ++i)
+        ASSERT_EQ(exp, comb(i)) << "at split " << i;
     
     check_fast_and_slow_constexpr<T, poly, init, xorout, refin, refout>(exp);
 }
@@ -79,6 +105,33 @@ constexpr auto check_fast_and_slow_32(uint32_t exp) { return check_fast_and_slow
 template<uint64_t poly, uint64_t init, uint64_t xorout, bool refin, bool refout>
 constexpr auto check_fast_and_slow_64(uint64_t exp) { return check_fast_and_slow<uint64_t, poly, init, xorout, refin, refout>(exp); }
 
+template<crc_preset P>
+void check_preset()
+{
+    static constexpr auto exp = P.check;
+    static constexpr auto res_1 = crc<P>({test_data_bytes, test_size});
+    static constexpr auto res_2 = crc_state<P>{}
+        .update({test_data_bytes, test_part})
+        .update({test_data_bytes + test_part, test_size - test_part})
+        .value();
+    static_assert(crc_policy<crc_preset_policy<P>>);
+
+    ASSERT_EQ(exp, res_1);
+    ASSERT_EQ(exp, res_2);
+    ASSERT_EQ(exp, crc<P>({reinterpret_cast<const byte*>(test_data), test_size}));
+
+    crc_state<P> state;
+    for (size_t i = 0; i < test_size; ++i)
+        state.update({reinterpret_cast<const byte*>(test_data) + i, 1});
+    ASSERT_EQ(exp, state.value());
+    state.reset();
+    ASSERT_EQ(exp, state.update({reinterpret_cast<const byte*>(test_data), test_size}).value());
+
+    auto a = crc<P>({test_data_bytes, test_part});
+    auto b = crc<P>({test_data_bytes + test_part, test_size - test_part});
+    ASSERT_EQ(exp, crc_combine<P>(a, b, test_size - test_part));
+}
+
 TEST(MiscCrc, Crc8) 
 {
     check_fast_and_slow_8<0x2f, 0xff, 0xff, 0, 0>(0xdf); // CRC-8/AUTOSAR
@@ -163,5 +216,103 @@ TEST(MiscCrc, Crc64)
     check_fast_and_slow_64<0x42f0e1eba9ea3693, 0xffffffffffffffff, 0xffffffffffffffff, 1, 1>(0x995dc9bbdf1939fa); // CRC-64/XZ
 }
 
+TEST(MiscCrc, Preset8)
+{
+    check_preset<crc8_autosar>();
+    check_preset<crc8_bluetooth>();
+    check_preset<crc8_cdma2000>();
+    check_preset<crc8_darc>();
+    check_preset<crc8_dvb_s2>();
+    check_preset<crc8_gsm_a>();
+    check_preset<crc8_gsm_b>();
+    check_preset<crc8_hitag>();
+    check_preset<crc8_i_432_1>();
+    check_preset<crc8_i_code>();
+    check_preset<crc8_lte>();
+    check_preset<crc8_maxim_dow>();
+    check_preset<crc8_mifare_mad>();
+    check_preset<crc8_nrsc_5>();
+    check_preset<crc8_opensafety>();
+    check_preset<crc8_rohc>();
+    check_preset<crc8_sae_j1850>();
+    check_preset<crc8_smbus>();
+    check_preset<crc8_tech_3250>();
+    check_preset<crc8_wcdma>();
+}
+
+TEST(MiscCrc, Preset16)
+{
+    check_preset<crc16_arc>();
+    check_preset<crc16_cdma2000>();
+    check_preset<crc16_cms>();
+    check_preset<crc16_dds_110>();
+    check_preset<crc16_dect_r>();
+    check_preset<crc16_dect_x>();
+    check_preset<crc16_dnp>();
+    check_preset<crc16_en_13757>();
+    check_preset<crc16_genibus>();
+    check_preset<crc16_gsm>();
+    check_preset<crc16_ibm_3740>();
+    check_preset<crc16_ibm_sdlc>();
+    check_preset<crc16_iso_iec_14443_3_a>();
+    check_preset<crc16_kermit>();
+    check_preset<crc16_lj1200>();
+    check_preset<crc16_m17>();
+    check_preset<crc16_maxim_dow>();
+    check_preset<crc16_mcrf4xx>();
+    check_preset<crc16_modbus>();
+    check_preset<crc16_nrsc_5>();
+    check_preset<crc16_opensafety_a>();
+    check_preset<crc16_opensafety_b>();
+    check_preset<crc16_profibus>();
+    check_preset<crc16_riello>();
+    check_preset<crc16_spi_fujitsu>();
+    check_preset<crc16_t10_dif>();
+    check_preset<crc16_teledisk>();
+    check_preset<crc16_tms37157>();
+    check_preset<crc16_umts>();
+    check_preset<crc16_usb>();
+    check_preset<crc16_xmodem>();
+}
+
+TEST(MiscCrc, Preset32)
+{
+    check_preset<crc32_aixm>();
+    check_preset<crc32_autosar>();
+    check_preset<crc32_base91_d>();
+    check_preset<crc32_bzip2>();
+    check_preset<crc32_cd_rom_edc>();
+    check_preset<crc32_cksum>();
+    check_preset<crc32_iscsi>();
+    check_preset<crc32_iso_hdlc>();
+    check_preset<crc32_jamcrc>();
+    check_preset<crc32_mef>();
+    check_preset<crc32_mpeg_2>();
+    check_preset<crc32_xfer>();
+    check_preset<crc32>();
+    check_preset<crc32c>();
+}
+
+TEST(MiscCrc, Preset64)
+{
+    check_preset<crc64_ecma_182>();
+    check_preset<crc64_go_iso>();
+    check_preset<crc64_ms>();
+    check_preset<crc64_we>();
+    check_preset<crc64_xz>();
+}
+
+TEST(MiscCrc, ZeroShiftHugeLength)
+{
+    constexpr uint32_t poly = 0x04c11db7;
+    constexpr size_t n = size_t(1) << (sizeof(size_t) * 8 - 3);
+    static constexpr auto half = imp::crc_x8n<uint32_t, poly>(n / 2);
+    static constexpr auto full = imp::crc_x8n<uint32_t, poly>(n);
+    static constexpr auto most = imp::crc_x8n<uint32_t, poly>(SIZE_MAX);
+
+    ASSERT_EQ(full, (imp::crc_mulmod<uint32_t, poly>(half, half)));
+    ASSERT_NE(most, 0);
+}
+
+}
 }
-}
\ No newline at end of file
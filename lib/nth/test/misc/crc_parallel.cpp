@@ -0,0 +1,37 @@
+#include "test.h"
+#include "nth/misc/crc_parallel.h"
+
+namespace nth {
+namespace {
+
+template<class T, T poly, T init, T xorout, bool refin, bool refout>
+void check_parallel(std::span<const byte> data)
+{
+    auto exp = crc_fast<T, poly, init, xorout, refin, refout>(data);
+
+    for (size_t threads = 1; threads <= 8; ++threads) {
+        auto crc = crc_parallel<T, poly, init, xorout, refin, refout>(data, threads, 1000);
+        ASSERT_EQ(exp, crc) << "with threads " << threads;
+    }
+    ASSERT_EQ(exp, (crc_parallel<T, poly, init, xorout, refin, refout>(data)));
+    ASSERT_EQ((crc_fast<T, poly, init, xorout, refin, refout>(data.first(7))), 
+              (crc_parallel<T, poly, init, xorout, refin, refout>(data.first(7), 4, 1)));
+}
+
+TEST(MiscCrcParallel, Crc)
+{
+    std::vector<byte> data(100003);
+    uint32_t x = 0x12345678;
+    for (auto& b : data) {
+        x = x * 1664525 + 1013904223;
+        b = x >> 24;
+    }
+    check_parallel<uint8_t, 0x07, 0x00, 0x00, 0, 0>(data);                                          // CRC-8/SMBUS
+    check_parallel<uint16_t, 0x1021, 0xffff, 0xffff, 1, 1>(data);                                   // CRC-16/IBM-SDLC
+    check_parallel<uint32_t, 0x04c11db7, 0xffffffff, 0xffffffff, 1, 1>(data);                       // CRC-32/ISO-HDLC
+    check_parallel<uint32_t, 0x04c11db7, 0xffffffff, 0x00000000, 0, 0>(data);                       // CRC-32/MPEG-2
+    check_parallel<uint64_t, 0x42f0e1eba9ea3693, 0xffffffffffffffff, 0xffffffffffffffff, 1, 1>(data); // CRC-64/XZ
+}
+
+}
+}
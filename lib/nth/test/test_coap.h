@@ -0,0 +1,43 @@
+#ifndef NTH_TEST_COAP_H
+#define NTH_TEST_COAP_H
+
+#include "test.h"
+#include "nth/coap/address.h"
+#include "nth/coap/packet.h"
+#include <vector>
+
+namespace nth::coap {
+
+/**
+ * @brief Transport which records every sent datagram.
+ *
+ */
+struct fake_transport {
+    size_t send(std::span<const datagram> batch)
+    {
+        for (auto& it : batch)
+            sent.push_back({it.addr, {it.data.begin(), it.data.end()}});
+        return batch.size();
+    }
+    struct entry {
+        address addr;
+        std::vector<byte> data;
+    };
+    std::vector<entry> sent;
+};
+
+inline address make_addr(addr_port port)
+{
+    return {.data = {.u32 = 0x7f000001}, .port = port, .type = addr_type::ipv4};
+}
+
+inline std::vector<byte> make_empty(msg_type t, word id)
+{
+    packet pkt;
+    pkt.setup(t, msg_code::empty, id, {});
+    return {pkt.begin(), pkt.end()};
+}
+
+}
+
+#endif
@@ -0,0 +1,80 @@
+#include "test.h"
+#include "nth/util/arena.h"
+#include <vector>
+
+namespace nth {
+namespace {
+
+TEST(UtilArena, Allocate)
+{
+    alignas(64) byte buf[256];
+    arena a{buf};
+
+    ASSERT_EQ(a.capacity(), sizeof(buf));
+    ASSERT_EQ(a.used(), 0);
+
+    auto p1 = a.try_allocate(3, 1);
+    auto p2 = a.try_allocate(8, 8);
+    auto p3 = a.try_allocate(1, 64);
+
+    ASSERT_EQ(p1, buf);
+    ASSERT_EQ(p2, buf + 8);
+    ASSERT_EQ(p3, buf + 64);
+    ASSERT_EQ(a.used(), 65);
+    ASSERT_EQ(a.try_allocate(256 - 65 + 1, 1), nullptr);
+    ASSERT_EQ(a.try_allocate(256 - 65, 1), buf + 65);
+    ASSERT_EQ(a.available(), 0);
+    ASSERT_EQ(a.try_allocate(0, 1), buf + 256);
+    ASSERT_EQ(a.try_allocate(1, 1), nullptr);
+
+    a.reset();
+    ASSERT_EQ(a.try_allocate(1, 1), buf);
+}
+
+TEST(UtilArena, Rewind)
+{
+    byte buf[256];
+    arena a{buf};
+
+    a.try_allocate(10, 1);
+    auto m = a.mark();
+    a.try_allocate(100, 1);
+    a.rewind(m);
+    ASSERT_EQ(a.used(), 10);
+
+    {
+    auto guard = a.scope();
+    a.try_allocate(100, 1);
+    {
+    auto guard = a.scope();
+    a.try_allocate(100, 1);
+    ASSERT_EQ(a.used(), 210);
+    }
+    ASSERT_EQ(a.used(), 110);
+    }
+    ASSERT_EQ(a.used(), 10);
+}
+
+TEST(UtilArena, MemoryResource)
+{
+    alignas(std::max_align_t) byte buf[1024];
+    arena a{buf};
+
+    {
+    std::pmr::vector<int> v{&a};
+    v.reserve(100);
+    for (int i = 0; i < 100; ++i)
+        v.push_back(i);
+    ASSERT_EQ(v[99], 99);
+    ASSERT_GE(a.used(), 400);
+    ASSERT_GE(reinterpret_cast<byte*>(v.data()), buf);
+    ASSERT_LT(reinterpret_cast<byte*>(v.data()), buf + sizeof(buf));
+    }
+    auto guard = a.scope();
+    std::pmr::vector<int> v{&a};
+    v.push_back(1);
+    ASSERT_EQ(a.is_equal(a), true);
+}
+
+}
+}
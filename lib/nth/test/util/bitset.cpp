@@ -186,6 +186,75 @@ TEST(UtilBitset, AcquireAny)
     ASSERT_EQ(bv.acquire_any(), bv.capacity());
 }
 
+TEST(UtilBitset, AcquireAnyWide)
+{
+    bitset<uint64_t, 60 * 64 - 5, 63> bv;
+
+    ASSERT_EQ(bv.depth(), 1);
+    for (size_t i = 0; i < bv.capacity(); ++i)
+        ASSERT_EQ(bv.acquire_any(), i);
+    ASSERT_EQ(bv.acquire_any(), bv.capacity());
+
+    bv.clr(3000);
+    bv.clr(bv.capacity() - 1);
+    ASSERT_EQ(bv.acquire_any(), 3000);
+    ASSERT_EQ(bv.acquire_any(), bv.capacity() - 1);
+    ASSERT_EQ(bv.acquire_any(), bv.capacity());
+}
+
+TEST(UtilBitset, Range)
+{
+    bitset8<1337> bv;
+
+    bv.set(3, 1000);
+    for (size_t i = 0; i < bv.capacity(); ++i)
+        ASSERT_EQ(bv[i], i >= 3 && i < 1000) << "at index " << i;
+    ASSERT_EQ(bv.count(), 997);
+
+    bv.clr(5, 6);
+    bv.clr(64, 512);
+    ASSERT_EQ(bv.count(), 997 - 1 - 448);
+    for (size_t i = 0; i < bv.capacity(); ++i)
+        ASSERT_EQ(bv[i], i >= 3 && i < 1000 && i != 5 && (i < 64 || i >= 512)) << "at index " << i;
+
+    ASSERT_EQ(bv.acquire_any(), 0);
+    ASSERT_EQ(bv.acquire_any(), 1);
+    ASSERT_EQ(bv.acquire_any(), 2);
+    ASSERT_EQ(bv.acquire_any(), 5);
+    ASSERT_EQ(bv.acquire_any(), 64);
+
+    bv.set(0, bv.capacity());
+    ASSERT_EQ(bv.count(), bv.capacity());
+    ASSERT_EQ(bv.acquire_any(), bv.capacity());
+    bv.clr(0, bv.capacity());
+    ASSERT_EQ(bv.count(), 0);
+    ASSERT_EQ(bv.acquire_any(), 0);
+}
+
+TEST(UtilBitset, FindNextSet)
+{
+    bitset<uint64_t, 1000, 4> bv;
+
+    ASSERT_EQ(bv.find_next_set(0), bv.capacity());
+    ASSERT_EQ(bv.find_next_set(bv.capacity()), bv.capacity());
+    ASSERT_EQ(bv.count(), 0);
+
+    bv.set(0);
+    bv.set(63);
+    bv.set(64);
+    bv.set(999);
+
+    ASSERT_EQ(bv.find_next_set(0), 0);
+    ASSERT_EQ(bv.find_next_set(1), 63);
+    ASSERT_EQ(bv.find_next_set(64), 64);
+    ASSERT_EQ(bv.find_next_set(65), 999);
+    ASSERT_EQ(bv.find_next_set(999), 999);
+    ASSERT_EQ(bv.count(), 4);
+
+    bv.clr(999);
+    ASSERT_EQ(bv.find_next_set(65), bv.capacity());
+}
+
 TEST(UtilBitset, Death)
 {
     bitset8<7> bv;
@@ -193,6 +262,9 @@ TEST(UtilBitset, Death)
     ASSERT_DEATH(bv[bv.capacity() + 1], "");
     ASSERT_DEATH(bv.clr(bv.capacity() + 1), "");
     ASSERT_DEATH(bv.set(bv.capacity() + 1), "");
+    ASSERT_DEATH(bv.set(0, bv.capacity() + 1), "");
+    ASSERT_DEATH(bv.clr(2, 1), "");
+    ASSERT_DEATH(bv.find_next_set(bv.capacity() + 1), "");
 }
 
 }
@@ -0,0 +1,99 @@
+#include "test.h"
+#include "nth/util/bitset_atomic.h"
+#include <thread>
+#include <vector>
+
+namespace nth {
+namespace {
+
+TEST(UtilBitsetAtomic, AcquireAny)
+{
+    bitset_atomic<uint32_t, 1337, 4> bv;
+
+    ASSERT_EQ(bv.depth(), 2);
+    for (size_t i = 0; i < bv.capacity(); ++i)
+        ASSERT_EQ(bv.acquire_any(), i);
+    ASSERT_EQ(bv.acquire_any(), bv.capacity());
+    ASSERT_EQ(bv.count(), bv.capacity());
+
+    ASSERT_EQ(bv.clr(0), true);
+    ASSERT_EQ(bv.clr(0), false);
+    bv.clr(228);
+    bv.clr(bv.capacity() - 1);
+
+    ASSERT_EQ(bv.acquire_any(), 0);
+    ASSERT_EQ(bv.acquire_any(), 228);
+    ASSERT_EQ(bv.acquire_any(), bv.capacity() - 1);
+    ASSERT_EQ(bv.acquire_any(), bv.capacity());
+
+    bv.reset();
+    ASSERT_EQ(bv.count(), 0);
+    ASSERT_EQ(bv.acquire_any(), 0);
+}
+
+TEST(UtilBitsetAtomic, Range)
+{
+    bitset_atomic<uint8_t, 1337, 4> bv;
+
+    ASSERT_EQ(bv.depth(), 3);
+    bv.set(0, 1000);
+    ASSERT_EQ(bv.count(), 1000);
+    ASSERT_EQ(bv.acquire_any(), 1000);
+    bv.clr(500, 600);
+    ASSERT_EQ(bv.find_next_set(500), 600);
+    ASSERT_EQ(bv.find_next_set(1001), bv.capacity());
+    ASSERT_EQ(bv.acquire_any(), 500);
+    ASSERT_EQ(bv.count(), 902);
+}
+
+TEST(UtilBitsetAtomic, Threads)
+{
+    constexpr size_t threads = 4;
+    constexpr size_t rounds = 20000;
+    constexpr size_t size = 300;
+
+    bitset_atomic<uint8_t, size, 2> bv;
+    std::atomic<int> owner[size] = {};
+    std::atomic<bool> fail = false;
+    std::vector<std::thread> pool;
+
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            size_t held[size / threads];
+            size_t n = 0;
+            for (size_t i = 0; i < rounds; ++i) {
+                if (n < std::size(held) && (i * 7 + t) % 3) {
+                    auto pos = bv.acquire_any();
+                    if (pos == size) {
+                        fail = true;
+                        continue;
+                    }
+                    if (owner[pos].exchange(t + 1))
+                        fail = true;
+                    held[n++] = pos;
+                } else if (n) {
+                    auto pos = held[--n];
+                    owner[pos] = 0;
+                    if (!bv.clr(pos))
+                        fail = true;
+                }
+            }
+            while (n) {
+                auto pos = held[--n];
+                owner[pos] = 0;
+                bv.clr(pos);
+            }
+        });
+    }
+    for (auto& t : pool)
+        t.join();
+
+    ASSERT_EQ(fail, false);
+    ASSERT_EQ(bv.count(), 0);
+    for (size_t i = 0; i < size; ++i)
+        ASSERT_EQ(bv.acquire_any(), i);
+    ASSERT_EQ(bv.acquire_any(), size);
+}
+
+}
+}
@@ -1,5 +1,7 @@
 #include "test.h"
 #include "nth/util/bitslide.h"
+#include <random>
+#include <set>
 
 namespace nth {
 namespace {
@@ -70,5 +72,58 @@ TEST(UtilBitslide, Update)
     ASSERT_EQ(b.check_and_update(2), true);
 }
 
+TEST(UtilBitslideArr, MatchesBitslide)
+{
+    nth::bitslide<uint32_t, uint64_t> ref = 100;
+    nth::bitslide_arr<uint32_t, uint8_t, 64> b = 100;
+    std::mt19937 gen{1};
+
+    uint32_t seqn = 100;
+    for (int i = 0; i < 20000; ++i) {
+        seqn += gen() % 8;
+        auto x = seqn - gen() % 80;
+        ASSERT_EQ(b.check(x), ref.check(x)) << x;
+        ASSERT_EQ(b.check_and_update(x), ref.check_and_update(x)) << x;
+        ASSERT_EQ(b.latest(), ref.latest());
+    }
+}
+
+TEST(UtilBitslideArr, Wide)
+{
+    nth::bitslide_arr<uint64_t, uint32_t, 4096> b;
+    std::set<uint64_t> seen;
+    std::mt19937 gen{2};
+
+    ASSERT_FALSE(b.check(0));
+    ASSERT_TRUE(b.check(1));
+
+    uint64_t top = 0;
+    for (int i = 0; i < 50000; ++i) {
+        top += gen() % 300;
+        auto x = top - std::min<uint64_t>(top, gen() % 5000);
+        auto high = std::max(b.latest(), x);
+        auto expect = x > b.latest() || (x && high - x < 4096 && !seen.contains(x));
+        ASSERT_EQ(b.check_and_update(x), expect) << x;
+        seen.insert(x);
+    }
+}
+
+TEST(UtilBitslideArr, Jump)
+{
+    nth::bitslide_arr<uint32_t, uint32_t, 256> b = 10;
+
+    ASSERT_EQ(b.check_and_update(10), false);
+    ASSERT_EQ(b.check_and_update(11), true);
+    ASSERT_EQ(b.check_and_update(1000), true);
+    ASSERT_EQ(b.check_and_update(745), true);
+    ASSERT_EQ(b.check_and_update(744), false);
+    ASSERT_EQ(b.check_and_update(999), true);
+    ASSERT_EQ(b.check_and_update(999), false);
+    ASSERT_EQ(b.check_and_update(1255), true);
+    ASSERT_EQ(b.check_and_update(1000), false);
+    ASSERT_EQ(b.check_and_update(1001), true);
+    ASSERT_EQ(b.check_and_update(999), false);
+}
+
+}
 }
-}
\ No newline at end of file
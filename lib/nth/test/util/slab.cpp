@@ -0,0 +1,96 @@
+#include "test.h"
+#include "nth/util/slab.h"
+#include <list>
+#include <map>
+
+namespace nth {
+namespace {
+
+TEST(UtilSlab, SizeClass)
+{
+    using slab_t = slab<16, 4>;
+
+    ASSERT_EQ(slab_t::max_block(), 128);
+    ASSERT_EQ(slab_t::size_class(0), 0);
+    ASSERT_EQ(slab_t::size_class(16), 0);
+    ASSERT_EQ(slab_t::size_class(17), 1);
+    ASSERT_EQ(slab_t::size_class(1, 32), 1);
+    ASSERT_EQ(slab_t::size_class(64), 2);
+    ASSERT_EQ(slab_t::size_class(128), 3);
+    ASSERT_EQ(slab_t::size_class(129), 4);
+}
+
+TEST(UtilSlab, Reuse)
+{
+    alignas(std::max_align_t) byte buf[256];
+    slab<16, 4> s{buf};
+
+    auto a = s.try_allocate(10, 1);
+    auto b = s.try_allocate(20, 1);
+    auto c = s.try_allocate(16, 1);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    ASSERT_NE(c, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % 16, 0);
+    ASSERT_EQ(s.try_allocate(200, 1), nullptr);
+
+    auto used = s.used();
+    s.release(a, 10, 1);
+    s.release(c, 16, 1);
+    ASSERT_EQ(s.try_allocate(1, 1), c);
+    ASSERT_EQ(s.try_allocate(16, 1), a);
+    s.release(b, 20, 1);
+    ASSERT_EQ(s.try_allocate(32, 1), b);
+    ASSERT_EQ(s.used(), used);
+
+    s.reset();
+    ASSERT_EQ(s.used(), 0);
+}
+
+TEST(UtilSlab, OverAligned)
+{
+    alignas(std::max_align_t) byte buf[1024];
+    slab<16, 4> s{buf};
+
+    auto a = s.try_allocate(8, 1);
+    auto b = s.try_allocate(8, 64);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0);
+
+    std::pmr::memory_resource& r = s;
+    auto c = r.allocate(8, 64);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(c) % 64, 0);
+    r.deallocate(c, 8, 64);
+    auto d = s.try_allocate(64, 1);
+    ASSERT_EQ(d, c);
+    s.release(d, 64, 1);
+    ASSERT_EQ(r.allocate(8, 64), c);
+    ASSERT_EQ(s.try_allocate(8, 256), nullptr);
+}
+
+TEST(UtilSlab, MemoryResource)
+{
+    alignas(64) byte buf[4096];
+    slab<> s{buf};
+
+    std::pmr::list<int> l{&s};
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 50; ++i)
+            l.push_back(i);
+        l.clear();
+    }
+    auto used = s.used();
+    ASSERT_LE(used, 50 * 32);
+
+    std::pmr::map<int, int> m{&s};
+    for (int i = 0; i < 20; ++i)
+        m[i] = i;
+    m.clear();
+    for (int i = 0; i < 20; ++i)
+        m[i] = i;
+    ASSERT_EQ(m.size(), 20);
+}
+
+}
+}
@@ -80,10 +80,12 @@ void scan_process(struct bt_scan_device_info *device_info)
     uint16_t raw_len    = device_info->adv_data->len;
     LOG_HEX_D(raw_data, raw_len, "adv_data");
 
-    usb_send(&device_info->recv_info->rssi, 1);
-    usb_send(device_info->recv_info->addr->a.val, 6);
-    usb_send(raw_data, raw_len);
-    usb_send_finalize();
+    const std::span<const uint8_t> frame[] = {
+        {reinterpret_cast<const uint8_t*>(&device_info->recv_info->rssi), 1},
+        {device_info->recv_info->addr->a.val, 6},
+        {raw_data, raw_len},
+    };
+    usb_send_frame(frame);
 
     // if (raw_len > 7) {
     //     uint8_t payload_len = raw_data[3];
@@ -23,6 +23,7 @@ struct ring_buf ringbuf;
 const struct device* dev;
 #if (USB_COBS)
 nth::cobs_pipe_encoder cobs_pipe;
+bool cobs_short_write;
 #endif
 
 #if (USB_ECHO_TEST)
@@ -91,7 +92,13 @@ void usb_status_handler(enum usb_dc_status_code cb_status, const uint8_t* param)
 size_t cobs_write_handler(const uint8_t* data, size_t size)
 {
     LOG_HEX_I(data, size, TXT_MAG "USB TX COBS chunk");
-    return size_t(uart_fifo_fill(dev, data, size));
+    int len = uart_fifo_fill(dev, data, size);
+    if (len < int(size)) {
+        LOG_E("Drop %d bytes", int(size) - (len < 0 ? 0 : len));
+        cobs_short_write = true;
+        return len < 0 ? 0 : size_t(len);
+    }
+    return size;
 }
 
 #endif
@@ -162,7 +169,7 @@ bool usb_send(const void* data, size_t size)
     LOG_HEX_I(data, size, "USB TX raw chunk");
 #if (USB_COBS)
     cobs_pipe.sink({static_cast<const uint8_t*>(data), size}, cobs_write_handler);
-    return true;
+    return !cobs_short_write;
 #else
     uint8_t len = size;
     return  uart_fifo_fill(dev, &len, 1) == 1 &&
@@ -174,7 +181,24 @@ bool usb_send_finalize()
 {
 #if (USB_COBS)
     cobs_pipe.stop(cobs_write_handler);
-    return true;
+    bool ok = !cobs_short_write;
+    cobs_short_write = false;
+    return ok;
+#else
+    static_assert(false);
+#endif
+}
+
+bool usb_send_frame(std::span<const std::span<const uint8_t>> chunks)
+{
+    for (auto chunk : chunks)
+        LOG_HEX_I(chunk.data(), chunk.size(), "USB TX raw chunk");
+#if (USB_COBS)
+    const uint8_t delim = 0;
+    cobs_short_write = false;
+    nth::cobs_encode(chunks, cobs_write_handler);
+    cobs_write_handler(&delim, 1);
+    return !cobs_short_write;
 #else
     static_assert(false);
 #endif
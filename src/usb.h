@@ -3,12 +3,14 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <span>
 
 namespace app {
 
 void usb_init();
 bool usb_send(const void* data, size_t size);
 bool usb_send_finalize();
+bool usb_send_frame(std::span<const std::span<const uint8_t>> chunks);
 
 }
 